@@ -0,0 +1,252 @@
+/**
+ * @file BatchProcessor.cpp
+ * @brief Implementation of the BatchProcessor class.
+ */
+
+#include "BatchProcessor.h"
+#include <unordered_set>
+
+/**
+ * @brief Constructor for the BatchProcessor class.
+ *
+ * @param context The shared data context.
+ * @param pool The threads used to evaluate the requests.
+ * @param windowSize The number of requests evaluated in parallel before being applied, 0 for 64 per thread.
+ */
+BatchProcessor::BatchProcessor(shared_ptr<DataContext> context, ThreadPool& pool, size_t windowSize)
+    : context(std::move(context)), pool(pool), windowSize(windowSize > 0 ? windowSize : 64 * pool.size()) {}
+
+/**
+ * @brief Gets the students and UCs a class change depends on.
+ *
+ * The evaluation of a request only reads the enrollment of its students, the occupancy of the read UCs
+ * and the catalog, which never changes.
+ *
+ * @param request The request.
+ * @return The footprint of the request.
+ */
+template<>
+RequestFootprint BatchProcessor::footprintOf<ChangeClassRequest>(const ChangeClassRequest& request) {
+    return {{request.studentCode}, {request.currentUc}, {request.currentUc}};
+}
+
+/**
+ * @brief Gets the students and UCs a UC change depends on, only the occupancy of the new UC is read.
+ *
+ * @param request The request.
+ * @return The footprint of the request.
+ */
+template<>
+RequestFootprint BatchProcessor::footprintOf<ChangeUcRequest>(const ChangeUcRequest& request) {
+    return {{request.studentCode}, {request.newUc}, {request.currentUc, request.newUc}};
+}
+
+/**
+ * @brief Gets the students and UCs leaving a UC depends on, it doesn't depend on the occupancy.
+ *
+ * @param request The request.
+ * @return The footprint of the request.
+ */
+template<>
+RequestFootprint BatchProcessor::footprintOf<LeaveUcClassRequest>(const LeaveUcClassRequest& request) {
+    return {{request.studentCode}, {}, {request.currentUc}};
+}
+
+/**
+ * @brief Gets the students and UCs joining a UC depends on.
+ *
+ * @param request The request.
+ * @return The footprint of the request.
+ */
+template<>
+RequestFootprint BatchProcessor::footprintOf<JoinUcClassRequest>(const JoinUcClassRequest& request) {
+    return {{request.studentCode}, {request.newUc}, {request.newUc}};
+}
+
+/**
+ * @brief Gets the students and UCs a swap depends on, a swap doesn't change the number of students of any class.
+ *
+ * @param request The request.
+ * @return The footprint of the request.
+ */
+template<>
+RequestFootprint BatchProcessor::footprintOf<SwapClassesRequest>(const SwapClassesRequest& request) {
+    return {{request.studentCode1, request.studentCode2}, {}, {}};
+}
+
+/**
+ * @brief Gets the students and UCs a change request depends on.
+ *
+ * @param request The change request.
+ * @return The footprint of the request.
+ */
+RequestFootprint BatchProcessor::footprintOf(const ChangeRequest& request) {
+    return visit([](const auto& data) { return footprintOf(data); }, request.requestData);
+}
+
+/**
+ * @brief The verdict of a request whose student doesn't exist.
+ *
+ * @return A verdict that denies the change as NotEnrolled.
+ */
+static ChangeVerdict studentNotFound() {
+    ChangeVerdict verdict;
+    verdict.outcome = ChangeOutcome::NotEnrolled;
+    return verdict;
+}
+
+/**
+ * @brief Evaluates a class change on the current data, the student is resolved through the index of the context.
+ *
+ * @param request The request.
+ * @return The verdict of the request, NotEnrolled if the student doesn't exist.
+ */
+template<>
+ChangeVerdict BatchProcessor::evaluate<ChangeClassRequest>(const ChangeClassRequest& request) const {
+    const Student* student = context->findStudent(request.studentCode);
+    if (student == nullptr) {
+        return studentNotFound();
+    }
+    return Change(context).evaluateChangeClass(*student, context->getUcCode(request.currentUc), context->getClassCode(request.currentClass),
+                                               context->getClassCode(request.newClass), false);
+}
+
+/**
+ * @brief Evaluates a UC change on the current data.
+ *
+ * @param request The request.
+ * @return The verdict of the request, NotEnrolled if the student doesn't exist.
+ */
+template<>
+ChangeVerdict BatchProcessor::evaluate<ChangeUcRequest>(const ChangeUcRequest& request) const {
+    const Student* student = context->findStudent(request.studentCode);
+    if (student == nullptr) {
+        return studentNotFound();
+    }
+    return Change(context).evaluateChangeUC(*student, context->getUcCode(request.currentUc), context->getClassCode(request.currentClass),
+                                            context->getUcCode(request.newUc), false);
+}
+
+/**
+ * @brief Evaluates leaving a UC on the current data.
+ *
+ * @param request The request.
+ * @return The verdict of the request, NotEnrolled if the student doesn't exist.
+ */
+template<>
+ChangeVerdict BatchProcessor::evaluate<LeaveUcClassRequest>(const LeaveUcClassRequest& request) const {
+    const Student* student = context->findStudent(request.studentCode);
+    if (student == nullptr) {
+        return studentNotFound();
+    }
+    return Change(context).evaluateLeaveUCAndClass(*student, context->getUcCode(request.currentUc), context->getClassCode(request.currentClass));
+}
+
+/**
+ * @brief Evaluates joining a UC on the current data.
+ *
+ * @param request The request.
+ * @return The verdict of the request, NotEnrolled if the student doesn't exist.
+ */
+template<>
+ChangeVerdict BatchProcessor::evaluate<JoinUcClassRequest>(const JoinUcClassRequest& request) const {
+    const Student* student = context->findStudent(request.studentCode);
+    if (student == nullptr) {
+        return studentNotFound();
+    }
+    return Change(context).evaluateJoinUCAndClass(*student, context->getUcCode(request.newUc), false);
+}
+
+/**
+ * @brief Evaluates a class swap on the current data.
+ *
+ * @param request The request.
+ * @return The verdict of the request, NotEnrolled if one of the students doesn't exist.
+ */
+template<>
+ChangeVerdict BatchProcessor::evaluate<SwapClassesRequest>(const SwapClassesRequest& request) const {
+    const Student* student1 = context->findStudent(request.studentCode1);
+    const Student* student2 = context->findStudent(request.studentCode2);
+    if (student1 == nullptr || student2 == nullptr) {
+        return studentNotFound();
+    }
+    return Change(context).evaluateSwapClasses(*student1, context->getUcCode(request.uc), context->getClassCode(request.class1),
+                                               *student2, context->getClassCode(request.class2));
+}
+
+/**
+ * @brief Evaluates a change request on the current data, without applying it.
+ *
+ * Only reads the data, so it can run concurrently with other evaluations.
+ *
+ * @param request The change request.
+ * @return The verdict of the request.
+ */
+ChangeVerdict BatchProcessor::evaluate(const ChangeRequest& request) const {
+    return visit([this](const auto& data) { return evaluate(data); }, request.requestData);
+}
+
+/**
+ * @brief Evaluates every request of a batch in parallel on the current data.
+ *
+ * @param requests The change requests.
+ * @return The verdict of each request, in the same order.
+ *
+ * @complexity O(R * E / T), where R is the number of requests, E the cost of one evaluation and T the number of threads.
+ */
+vector<ChangeVerdict> BatchProcessor::validate(const vector<ChangeRequest>& requests) const {
+    vector<ChangeVerdict> verdicts(requests.size());
+    pool.parallelFor(requests.size(), [&](size_t i) {
+        verdicts[i] = evaluate(requests[i]);
+    });
+    return verdicts;
+}
+
+/**
+ * @brief Processes a batch of requests with the same results as processing them sequentially.
+ *
+ * Each window is evaluated in parallel and then applied in order. The students and written UCs of every accepted
+ * request are marked as changed, and a later request of the window that reads any of them gets nullptr instead of
+ * its verdict, so that it is evaluated again on the current data. The next window is evaluated after the changes.
+ *
+ * @param requests The change requests, in queue order.
+ * @param apply Applies a request and returns true if it was accepted.
+ * @return The counters of the batch.
+ */
+BatchSummary BatchProcessor::process(const vector<ChangeRequest>& requests, const function<bool(const ChangeRequest&, const ChangeVerdict*)>& apply) const {
+    BatchSummary summary;
+    vector<ChangeVerdict> verdicts(windowSize);
+
+    for (size_t begin = 0; begin < requests.size(); begin += windowSize) {
+        size_t end = min(begin + windowSize, requests.size());
+        pool.parallelFor(end - begin, [&](size_t i) {
+            verdicts[i] = evaluate(requests[begin + i]);
+        });
+
+        unordered_set<int> changedStudents;
+        unordered_set<UcId> changedUcs;
+
+        for (size_t i = begin; i < end; i++) {
+            RequestFootprint footprint = footprintOf(requests[i]);
+            bool stale = any_of(footprint.students.begin(), footprint.students.end(), [&](int studentCode) {
+                             return changedStudents.count(studentCode) > 0;
+                         }) ||
+                         any_of(footprint.readUcs.begin(), footprint.readUcs.end(), [&](UcId ucId) {
+                             return changedUcs.count(ucId) > 0;
+                         });
+
+            bool accepted = apply(requests[i], stale ? nullptr : &verdicts[i - begin]);
+
+            summary.processed++;
+            if (stale) {
+                summary.revalidated++;
+            }
+            if (accepted) {
+                summary.accepted++;
+                changedStudents.insert(footprint.students.begin(), footprint.students.end());
+                changedUcs.insert(footprint.writtenUcs.begin(), footprint.writtenUcs.end());
+            }
+        }
+    }
+    return summary;
+}
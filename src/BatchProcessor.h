@@ -0,0 +1,106 @@
+/**
+ * @file BatchProcessor.h
+ * @brief Header file for the BatchProcessor class.
+ */
+
+#ifndef PROJETO_AED_BATCHPROCESSOR_H
+#define PROJETO_AED_BATCHPROCESSOR_H
+
+#include "Change.h"
+#include "ChangeRequest.h"
+#include "ThreadPool.h"
+
+/**
+ * @struct RequestFootprint
+ * @brief The students and UCs whose data a change request reads and may modify.
+ */
+struct RequestFootprint {
+    vector<int> students;      ///< The codes of the students involved in the request, read and modified.
+    vector<UcId> readUcs;      ///< The UCs whose occupancy the evaluation of the request reads.
+    vector<UcId> writtenUcs;   ///< The UCs whose occupancy changes if the request is accepted.
+};
+
+/**
+ * @struct BatchSummary
+ * @brief Counters of a processed batch of change requests.
+ */
+struct BatchSummary {
+    size_t processed = 0;   ///< The number of requests processed.
+    size_t accepted = 0;    ///< The number of requests accepted.
+    size_t revalidated = 0; ///< The number of requests evaluated again because an earlier request changed their data.
+};
+
+/**
+ * @class BatchProcessor
+ * @brief Processes a batch of change requests, validating them in parallel and applying them in order.
+ *
+ * The batch is split in windows of consecutive requests. The requests of a window are first evaluated concurrently
+ * on the thread pool, against the data as it is before the window (no request is applied while they are evaluated).
+ * They are then applied one by one in the original order: a request whose students and UCs were not modified by an
+ * earlier accepted request of the window reads exactly the same data as in the parallel evaluation, so its verdict is
+ * used as is; any other request is evaluated again on the current data. The result is the same as processing the
+ * requests sequentially.
+ */
+class BatchProcessor {
+private:
+    shared_ptr<DataContext> context; ///< The data context shared with the rest of the application.
+    ThreadPool& pool;                ///< The threads used to evaluate the requests.
+    size_t windowSize;               ///< The number of requests evaluated in parallel before being applied.
+
+public:
+    /**
+     * @brief Constructor for the BatchProcessor class.
+     * @param context The shared data context.
+     * @param pool The threads used to evaluate the requests.
+     * @param windowSize The number of requests evaluated in parallel before being applied, 0 for 64 per thread.
+     */
+    BatchProcessor(shared_ptr<DataContext> context, ThreadPool& pool, size_t windowSize = 0);
+
+    /**
+     * @brief Get the students and UCs a request of a given type depends on, every request type must specialize it.
+     * @param request The request.
+     * @return The footprint of the request.
+     */
+    template<typename Request>
+    static RequestFootprint footprintOf(const Request& request) = delete;
+
+    /**
+     * @brief Get the students and UCs a change request depends on.
+     * @param request The change request.
+     * @return The footprint of the request.
+     */
+    static RequestFootprint footprintOf(const ChangeRequest& request);
+
+    /**
+     * @brief Evaluate a request of a given type on the current data, every request type must specialize it.
+     * @param request The request.
+     * @return The verdict of the request.
+     */
+    template<typename Request>
+    ChangeVerdict evaluate(const Request& request) const = delete;
+
+    /**
+     * @brief Evaluate a change request on the current data, without applying it.
+     * @param request The change request.
+     * @return The verdict of the request.
+     */
+    ChangeVerdict evaluate(const ChangeRequest& request) const;
+
+    /**
+     * @brief Evaluate every request of a batch in parallel on the current data.
+     * @param requests The change requests.
+     * @return The verdict of each request, in the same order.
+     */
+    vector<ChangeVerdict> validate(const vector<ChangeRequest>& requests) const;
+
+    /**
+     * @brief Process a batch of requests with the same results as processing them sequentially.
+     * @param requests The change requests, in queue order.
+     * @param apply Applies a request and returns true if it was accepted. It receives the verdict to use,
+     *              or nullptr if the request must be evaluated again on the current data.
+     * @return The counters of the batch.
+     */
+    BatchSummary process(const vector<ChangeRequest>& requests, const function<bool(const ChangeRequest&, const ChangeVerdict*)>& apply) const;
+};
+
+#endif //PROJETO_AED_BATCHPROCESSOR_H
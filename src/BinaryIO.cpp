@@ -0,0 +1,109 @@
+/**
+ * @file BinaryIO.cpp
+ * @brief Implementation of the binary record helpers.
+ */
+
+#include "BinaryIO.h"
+#include <array>
+
+/**
+ * @brief Builds the lookup tables of the reflected CRC-32 polynomial for slicing by 8.
+ *
+ * The table 0 gives the checksum of each byte value, and the table k the checksum of a byte
+ * followed by k zero bytes, so 8 bytes can be folded into the checksum with 8 independent lookups.
+ *
+ * @return The lookup tables.
+ */
+static array<array<uint32_t, 256>, 8> makeCrcTables() {
+    array<array<uint32_t, 256>, 8> tables{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (size_t k = 1; k < 8; k++) {
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+        }
+    }
+    return tables;
+}
+
+/**
+ * @brief Computes the CRC-32 (IEEE 802.3) checksum of a block of bytes, 8 bytes at a time.
+ *
+ * @param data The bytes.
+ * @param size The number of bytes.
+ * @param crc The checksum of the previous blocks, to checksum several blocks as one.
+ * @return The checksum.
+ *
+ * @complexity O(n), where n is the number of bytes.
+ */
+uint32_t crc32(const char* data, size_t size, uint32_t crc) {
+    static const array<array<uint32_t, 256>, 8> tables = makeCrcTables();
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    crc = ~crc;
+    while (size >= 8) {
+        uint32_t low = crc ^ ((uint32_t) bytes[0] | (uint32_t) bytes[1] << 8 | (uint32_t) bytes[2] << 16 | (uint32_t) bytes[3] << 24);
+        crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24]
+              ^ tables[3][bytes[4]] ^ tables[2][bytes[5]] ^ tables[1][bytes[6]] ^ tables[0][bytes[7]];
+        bytes += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = tables[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * @brief Constructor for the BinaryWriter class.
+ *
+ * @param buffer The buffer the values are appended to.
+ */
+BinaryWriter::BinaryWriter(string& buffer) : buffer(buffer) {}
+
+/**
+ * @brief Appends a string, preceded by its length in 32 bits.
+ *
+ * @param value The string.
+ */
+void BinaryWriter::putString(const string& value) {
+    put<uint32_t>((uint32_t) value.size());
+    buffer.append(value);
+}
+
+/**
+ * @brief Constructor for the BinaryReader class.
+ *
+ * @param data The bytes to read.
+ * @param size The number of bytes.
+ */
+BinaryReader::BinaryReader(const char* data, size_t size) : position(data), end(data + size) {}
+
+/**
+ * @brief Reads a string written by BinaryWriter::putString.
+ *
+ * @param value The string read.
+ * @return True if the string was read, false if there weren't enough bytes.
+ */
+bool BinaryReader::getString(string& value) {
+    uint32_t size;
+    if (!get(size) || (size_t) (end - position) < size) {
+        return false;
+    }
+    value.assign(position, size);
+    position += size;
+    return true;
+}
+
+/**
+ * @brief Checks if every byte was read.
+ *
+ * @return True if there are no bytes left, otherwise false.
+ */
+bool BinaryReader::atEnd() const {
+    return position == end;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file BinaryIO.h
+ * @brief Helpers to write and read fixed-size values and strings in binary records, and their checksum.
+ */
+
+#ifndef PROJETO_AED_BINARYIO_H
+#define PROJETO_AED_BINARYIO_H
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+using namespace std;
+
+/**
+ * @brief Compute the CRC-32 (IEEE 802.3) checksum of a block of bytes.
+ * @param data The bytes.
+ * @param size The number of bytes.
+ * @param crc The checksum of the previous blocks, to checksum several blocks as one.
+ * @return The checksum.
+ */
+uint32_t crc32(const char* data, size_t size, uint32_t crc = 0);
+
+/**
+ * @class BinaryWriter
+ * @brief Appends values to a binary buffer, in the byte order of the machine.
+ */
+class BinaryWriter {
+private:
+    string& buffer; ///< The buffer the values are appended to.
+
+public:
+    /**
+     * @brief Constructor for the BinaryWriter class.
+     * @param buffer The buffer the values are appended to.
+     */
+    explicit BinaryWriter(string& buffer);
+
+    /**
+     * @brief Append a trivially copyable value.
+     * @param value The value.
+     */
+    template<typename T>
+    void put(const T& value) {
+        static_assert(is_trivially_copyable<T>::value, "Only trivially copyable values can be written as bytes");
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    /**
+     * @brief Append a string, preceded by its length.
+     * @param value The string.
+     */
+    void putString(const string& value);
+};
+
+/**
+ * @class BinaryReader
+ * @brief Reads the values written by a BinaryWriter, failing instead of reading past the end.
+ */
+class BinaryReader {
+private:
+    const char* position; ///< The next byte to read.
+    const char* end;      ///< The end of the bytes.
+
+public:
+    /**
+     * @brief Constructor for the BinaryReader class.
+     * @param data The bytes to read.
+     * @param size The number of bytes.
+     */
+    BinaryReader(const char* data, size_t size);
+
+    /**
+     * @brief Read a trivially copyable value.
+     * @param value The value read.
+     * @return True if the value was read, false if there weren't enough bytes.
+     */
+    template<typename T>
+    bool get(T& value) {
+        static_assert(is_trivially_copyable<T>::value, "Only trivially copyable values can be read as bytes");
+        if ((size_t) (end - position) < sizeof(T)) {
+            return false;
+        }
+        memcpy(&value, position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    /**
+     * @brief Read a string written by BinaryWriter::putString.
+     * @param value The string read.
+     * @return True if the string was read, false if there weren't enough bytes.
+     */
+    bool getString(string& value);
+
+    /**
+     * @brief Check if every byte was read.
+     * @return True if there are no bytes left, otherwise false.
+     */
+    bool atEnd() const;
+};
+
+#endif //PROJETO_AED_BINARYIO_H
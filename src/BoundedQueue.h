@@ -0,0 +1,130 @@
+/**
+ * @file BoundedQueue.h
+ * @brief Header file for the BoundedQueue class.
+ */
+
+#ifndef PROJETO_AED_BOUNDEDQUEUE_H
+#define PROJETO_AED_BOUNDEDQUEUE_H
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @class BoundedQueue
+ * @brief A fixed-capacity queue that threads push to and pop from without locks.
+ *
+ * The slots form a ring, each with a sequence number that tells whether it is ready to be written or
+ * read in the current lap, so a push or a pop only claims a position with a compare-and-swap and never
+ * waits for another thread. A full queue refuses the push instead of growing, leaving the policy to the
+ * caller. The capacity is rounded up to a power of two.
+ *
+ * @tparam T The type of the elements, copied in and out of the slots.
+ */
+template <typename T>
+class BoundedQueue {
+private:
+    /**
+     * @struct Slot
+     * @brief A position of the ring: its sequence number and its element.
+     */
+    struct Slot {
+        atomic<size_t> sequence; ///< Equal to the position when it may be written, to the position + 1 when it may be read.
+        T value;                 ///< The element, valid while the slot may be read.
+    };
+
+    vector<Slot> slots;                  ///< The ring of slots.
+    size_t mask;                         ///< The capacity - 1, to wrap the positions around the ring.
+    alignas(64) atomic<size_t> tail;     ///< The position of the next push.
+    alignas(64) atomic<size_t> head;     ///< The position of the next pop.
+
+public:
+    /**
+     * @brief Constructor for the BoundedQueue class, the queue is empty.
+     * @param capacity The minimum number of elements the queue holds, at least 2.
+     */
+    explicit BoundedQueue(size_t capacity) : tail(0), head(0) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        slots = vector<Slot>(size);
+        mask = size - 1;
+        for (size_t i = 0; i < size; i++) {
+            slots[i].sequence.store(i, memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * @brief Get the number of elements the queue holds.
+     * @return The capacity of the queue.
+     */
+    size_t capacity() const {
+        return slots.size();
+    }
+
+    /**
+     * @brief Add an element at the end of the queue, if it isn't full.
+     * @param value The element.
+     * @return True if the element was added, false if the queue is full.
+     * @complexity O(1), retried only when another thread claimed the same position.
+     */
+    bool tryPush(const T& value) {
+        size_t position = tail.load(memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(memory_order_acquire);
+            if (sequence == position) {
+                if (tail.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(position + 1, memory_order_release);
+                    return true;
+                }
+            } else if (sequence < position) {
+                return false; // the slot still holds the element of the previous lap
+            } else {
+                position = tail.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Remove the element at the front of the queue, if there is one.
+     * @param value Receives the element.
+     * @return True if an element was removed, false if the queue is empty.
+     * @complexity O(1), retried only when another thread claimed the same position.
+     */
+    bool tryPop(T& value) {
+        size_t position = head.load(memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(memory_order_acquire);
+            if (sequence == position + 1) {
+                if (head.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+                    value = slot.value;
+                    slot.sequence.store(position + mask + 1, memory_order_release);
+                    return true;
+                }
+            } else if (sequence < position + 1) {
+                return false; // the slot wasn't written in this lap yet
+            } else {
+                position = head.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Check if the queue looks empty, the answer may be out of date as soon as it is given.
+     * @return True if no element was waiting when checked, otherwise false.
+     */
+    bool empty() const {
+        return head.load(memory_order_acquire) >= tail.load(memory_order_acquire);
+    }
+};
+
+#endif //PROJETO_AED_BOUNDEDQUEUE_H
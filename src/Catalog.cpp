@@ -0,0 +1,170 @@
+/**
+ * @file Catalog.cpp
+ * @brief Implementation of the Catalog class.
+ */
+
+#include "Catalog.h"
+
+/**
+ * @brief Constructor for the Catalog class, builds the indexes of the catalog.
+ *
+ * @param classes The classes of every UC.
+ * @param schedules The schedules of every class.
+ *
+ * @complexity O(C log C + S log S), where C is the number of classes and S the number of schedules.
+ */
+Catalog::Catalog(vector<Class> classes, vector<Schedule> schedules) : classes(std::move(classes)), schedules(std::move(schedules)) {
+    for (const Class& ucClass : this->classes) {
+        if (ucClasses.find(ucClass.UcCode) == ucClasses.end()) {
+            ucIds[ucClass.UcCode] = ucCodes.size();
+            ucCodes.push_back(ucClass.UcCode);
+        }
+        if (classIds.find(ucClass.ClassCode) == classIds.end()) {
+            classIds[ucClass.ClassCode] = classCodes.size();
+            classCodes.push_back(ucClass.ClassCode);
+        }
+        vector<string>& codes = ucClasses[ucClass.UcCode];
+        if (find(codes.begin(), codes.end(), ucClass.ClassCode) == codes.end()) {
+            codes.push_back(ucClass.ClassCode);
+        }
+    }
+    for (const Schedule& schedule : this->schedules) {
+        classSchedules[{schedule.UcToClasses.UcCode, schedule.UcToClasses.ClassCode}].push_back(schedule);
+    }
+}
+
+/**
+ * @brief Retrieves the classes of the catalog.
+ *
+ * @return A constant reference to the vector of Class objects.
+ */
+const vector<Class>& Catalog::getClasses() const {
+    return classes;
+}
+
+/**
+ * @brief Retrieves the schedules of the catalog.
+ *
+ * @return A constant reference to the vector of Schedule objects.
+ */
+const vector<Schedule>& Catalog::getSchedules() const {
+    return schedules;
+}
+
+/**
+ * @brief Get the codes of every UC in the catalog.
+ *
+ * @return The UC codes, in catalog order.
+ */
+const vector<string>& Catalog::getUcCodes() const {
+    return ucCodes;
+}
+
+/**
+ * @brief Get the class codes of a UC in the catalog.
+ *
+ * @param ucCode The code of the UC.
+ * @return The class codes of the UC, empty if the UC doesn't exist.
+ */
+const vector<string>& Catalog::getClassesOfUc(const string& ucCode) const {
+    static const vector<string> none;
+    auto it = ucClasses.find(ucCode);
+    return it != ucClasses.end() ? it->second : none;
+}
+
+/**
+ * @brief Get the schedules of a class of a UC.
+ *
+ * @param ucCode The code of the UC.
+ * @param classCode The code of the class.
+ * @return The schedules of the class, empty if the class doesn't exist.
+ *
+ * @complexity O(log S)
+ */
+const vector<Schedule>& Catalog::getClassSchedules(const string& ucCode, const string& classCode) const {
+    static const vector<Schedule> none;
+    auto it = classSchedules.find({ucCode, classCode});
+    return it != classSchedules.end() ? it->second : none;
+}
+
+/**
+ * @brief Get the id of a UC code.
+ *
+ * @param ucCode The code of the UC.
+ * @return The id of the UC, or InvalidId if it is not in the catalog.
+ *
+ * @complexity O(1) on average
+ */
+UcId Catalog::getUcId(const string& ucCode) const {
+    auto it = ucIds.find(ucCode);
+    return it != ucIds.end() ? it->second : InvalidId;
+}
+
+/**
+ * @brief Get the code of a UC id.
+ *
+ * @param ucId The id of the UC.
+ * @return The code of the UC, empty if the id is not valid.
+ */
+const string& Catalog::getUcCode(UcId ucId) const {
+    static const string none;
+    return ucId < ucCodes.size() ? ucCodes[ucId] : none;
+}
+
+/**
+ * @brief Get the id of a class code.
+ *
+ * @param classCode The code of the class.
+ * @return The id of the class, or InvalidId if it is not in the catalog.
+ *
+ * @complexity O(1) on average
+ */
+ClassId Catalog::getClassId(const string& classCode) const {
+    auto it = classIds.find(classCode);
+    return it != classIds.end() ? it->second : InvalidId;
+}
+
+/**
+ * @brief Get the code of a class id.
+ *
+ * @param classId The id of the class.
+ * @return The code of the class, empty if the id is not valid.
+ */
+const string& Catalog::getClassCode(ClassId classId) const {
+    static const string none;
+    return classId < classCodes.size() ? classCodes[classId] : none;
+}
+
+/**
+ * @brief Pack an enrollment as UC and class ids.
+ *
+ * @param classes The enrollment, as UC and class codes.
+ * @return The enrollment as ids, InvalidId for the codes that are not in the catalog.
+ *
+ * @complexity O(c) on average, where c is the number of classes.
+ */
+PackedEnrollment Catalog::pack(const vector<Class>& classes) const {
+    PackedEnrollment packed;
+    packed.reserve(classes.size());
+    for (const Class& ucClass : classes) {
+        packed.emplace_back(getUcId(ucClass.UcCode), getClassId(ucClass.ClassCode));
+    }
+    return packed;
+}
+
+/**
+ * @brief Unpack an enrollment of UC and class ids.
+ *
+ * @param classes The enrollment, as ids.
+ * @return The enrollment as UC and class codes.
+ *
+ * @complexity O(c), where c is the number of classes.
+ */
+vector<Class> Catalog::unpack(const PackedEnrollment& classes) const {
+    vector<Class> unpacked;
+    unpacked.reserve(classes.size());
+    for (const auto& ucClass : classes) {
+        unpacked.emplace_back(getUcCode(ucClass.first), getClassCode(ucClass.second));
+    }
+    return unpacked;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file Catalog.h
+ * @brief Header file for the Catalog class.
+ */
+
+#ifndef PROJETO_AED_CATALOG_H
+#define PROJETO_AED_CATALOG_H
+
+#include "Data.h"
+#include <map>
+#include <unordered_map>
+
+/**
+ * @class Catalog
+ * @brief The UCs, classes and schedules of the application, with their indexes.
+ *
+ * The catalog never changes at runtime, so it is built once and shared, through a pointer to a const
+ * Catalog, by every DataContext: the live one and the ones rebuilt for the roster of a past time.
+ */
+class Catalog {
+private:
+    vector<Class> classes;       ///< The classes of every UC, as read from the CSV files.
+    vector<Schedule> schedules;  ///< The schedules of every class, as read from the CSV files.
+
+    vector<string> ucCodes; ///< The codes of every UC in the catalog, in catalog order.
+    map<string, vector<string>> ucClasses; ///< The class codes of each UC in the catalog.
+    map<pair<string, string>, vector<Schedule>> classSchedules; ///< The schedules of each (UC code, class code) pair.
+    unordered_map<string, UcId> ucIds;       ///< The id of each UC code, its position in ucCodes.
+    vector<string> classCodes;               ///< The distinct class codes of the catalog, indexed by ClassId.
+    unordered_map<string, ClassId> classIds; ///< The id of each class code, its position in classCodes.
+
+public:
+    /**
+     * @brief Constructor for the Catalog class, builds its indexes.
+     * @param classes The classes of every UC.
+     * @param schedules The schedules of every class.
+     */
+    Catalog(vector<Class> classes, vector<Schedule> schedules);
+
+    Catalog(const Catalog&) = delete;
+    Catalog& operator=(const Catalog&) = delete;
+
+    /**
+     * @brief Get the vector of Class objects.
+     * @return A constant reference to the classes.
+     */
+    const vector<Class>& getClasses() const;
+
+    /**
+     * @brief Get the vector of Schedule objects.
+     * @return A constant reference to the schedules.
+     */
+    const vector<Schedule>& getSchedules() const;
+
+    /**
+     * @brief Get the codes of every UC in the catalog.
+     * @return The UC codes, in catalog order.
+     */
+    const vector<string>& getUcCodes() const;
+
+    /**
+     * @brief Get the class codes of a UC in the catalog.
+     * @param ucCode The code of the UC.
+     * @return The class codes of the UC, empty if the UC doesn't exist.
+     */
+    const vector<string>& getClassesOfUc(const string& ucCode) const;
+
+    /**
+     * @brief Get the schedules of a class of a UC.
+     * @param ucCode The code of the UC.
+     * @param classCode The code of the class.
+     * @return The schedules of the class, empty if the class doesn't exist.
+     */
+    const vector<Schedule>& getClassSchedules(const string& ucCode, const string& classCode) const;
+
+    /**
+     * @brief Get the id of a UC code.
+     * @param ucCode The code of the UC.
+     * @return The id of the UC, or InvalidId if it is not in the catalog.
+     */
+    UcId getUcId(const string& ucCode) const;
+
+    /**
+     * @brief Get the code of a UC id.
+     * @param ucId The id of the UC.
+     * @return The code of the UC, empty if the id is not valid.
+     */
+    const string& getUcCode(UcId ucId) const;
+
+    /**
+     * @brief Get the id of a class code.
+     * @param classCode The code of the class.
+     * @return The id of the class, or InvalidId if it is not in the catalog.
+     */
+    ClassId getClassId(const string& classCode) const;
+
+    /**
+     * @brief Get the code of a class id.
+     * @param classId The id of the class.
+     * @return The code of the class, empty if the id is not valid.
+     */
+    const string& getClassCode(ClassId classId) const;
+
+    /**
+     * @brief Pack an enrollment as UC and class ids.
+     * @param classes The enrollment, as UC and class codes.
+     * @return The enrollment as ids, InvalidId for the codes that are not in the catalog.
+     */
+    PackedEnrollment pack(const vector<Class>& classes) const;
+
+    /**
+     * @brief Unpack an enrollment of UC and class ids.
+     * @param classes The enrollment, as ids.
+     * @return The enrollment as UC and class codes.
+     */
+    vector<Class> unpack(const PackedEnrollment& classes) const;
+};
+
+#endif //PROJETO_AED_CATALOG_H
@@ -4,14 +4,65 @@
  */
 
 #include "Change.h"
+#include "ChangeLog.h"
 #include <cmath>
 
+/**
+ * @brief Returns a human readable description of a change outcome.
+ *
+ * @param outcome The outcome to describe.
+ * @return The description of the outcome.
+ */
+string describeOutcome(ChangeOutcome outcome) {
+    return outcome == ChangeOutcome::Accepted ? "Accepted" : describeReason(logReasonOf(outcome));
+}
+
+/**
+ * @brief Returns the reason a change log records for a change outcome.
+ *
+ * @param outcome The outcome.
+ * @return The reason of the outcome, None if it was accepted.
+ */
+LogReason logReasonOf(ChangeOutcome outcome) {
+    switch (outcome) {
+        case ChangeOutcome::Accepted:
+            return LogReason::None;
+        case ChangeOutcome::AlreadyEnrolled:
+            return LogReason::AlreadyEnrolled;
+        case ChangeOutcome::NotEnrolled:
+            return LogReason::NotEnrolled;
+        case ChangeOutcome::CapacityExceeded:
+            return LogReason::CapacityExceeded;
+        case ChangeOutcome::BalanceDisturbed:
+            return LogReason::BalanceDisturbed;
+        case ChangeOutcome::ScheduleConflict:
+            return LogReason::ScheduleConflict;
+        case ChangeOutcome::MaxUcsExceeded:
+            return LogReason::MaxUcsExceeded;
+        case ChangeOutcome::NoVacancy:
+            return LogReason::NoVacancy;
+    }
+    return LogReason::None;
+}
+
 /**
  * @brief Constructor for the Change class.
  *
- * @param globalCopy A reference to the Global object used for student data.
+ * @param context The shared data context used for student data, no data is copied.
  */
-Change::Change(Global& globalCopy) : global(globalCopy) {}
+Change::Change(shared_ptr<DataContext> context) : context(std::move(context)) {}
+
+/**
+ * @brief Gets the number of students of a class from the occupancy of its UC.
+ *
+ * @param classStudentsCount A map containing the current student count for each class.
+ * @param classCode The class code.
+ * @return The number of students of the class, 0 if it isn't in the map.
+ */
+static int classCount(const map<string, int>& classStudentsCount, const string& classCode) {
+    auto it = classStudentsCount.find(classCode);
+    return it != classStudentsCount.end() ? it->second : 0;
+}
 
 /**
  * @brief Checks if adding a student to a class exceeds its capacity.
@@ -20,9 +71,9 @@ Change::Change(Global& globalCopy) : global(globalCopy) {}
  * @param newClassCode The class code to check.
  * @return True if the class capacity is exceeded, otherwise false.
  */
-bool Change::checkIfClassCapacityExceeds(map<string, int> classStudentsCount, const string& newClassCode) {
+bool Change::checkIfClassCapacityExceeds(const map<string, int>& classStudentsCount, const string& newClassCode) const {
     int cap = 26;
-    int newCount = classStudentsCount[newClassCode]++;
+    int newCount = classCount(classStudentsCount, newClassCode);
     return newCount > cap;
 }
 
@@ -33,25 +84,29 @@ bool Change::checkIfClassCapacityExceeds(map<string, int> classStudentsCount, co
  * @param currentUcCode The current UC code of the student.
  * @param oldClassCode The current class code of the student.
  * @param newClassCode The new class code to change to.
+ * @param details If not null, receives the class counts that disturb the balance.
  * @return True if the balance between classes would be disturbed, otherwise false.
  */
-bool Change::checkIfBalanceBetweenClassesDisturbed(map<string, int> classStudentsCount, const string& currentUcCode, const string& oldClassCode, const string& newClassCode) {
+bool Change::checkIfBalanceBetweenClassesDisturbed(const map<string, int>& classStudentsCount, const string& currentUcCode, const string& oldClassCode, const string& newClassCode, string* details) const {
     // Check if student wants to change from a bigger class to a smaller class
-    if (classStudentsCount[oldClassCode] > classStudentsCount[newClassCode]) {
+    if (classCount(classStudentsCount, oldClassCode) > classCount(classStudentsCount, newClassCode)) {
         return false;
     }
 
     // Suppose student changes class
-    classStudentsCount[oldClassCode]--;
-    classStudentsCount[newClassCode]++;
+    int oldCount = classCount(classStudentsCount, oldClassCode) - 1;
+    int newCount = classCount(classStudentsCount, newClassCode) + 1;
 
     // Check if the difference in student counts exceeds 4 if student changes class
     for (const auto& it : classStudentsCount) {
-        if (abs(it.second - classStudentsCount[oldClassCode]) > 4 || abs(it.second - classStudentsCount[newClassCode]) > 4) {
-            cout << "   " << "In " << currentUcCode << ": " << endl;
-            cout << "   " << it.first << " class has " << it.second << " students." << endl;
-            cout << "   " << oldClassCode << " class will have " << classStudentsCount[oldClassCode] << " students." << endl;
-            cout << "   " << newClassCode << " class will have " << classStudentsCount[newClassCode] << " students." << endl;
+        int count = it.first == oldClassCode ? oldCount : it.first == newClassCode ? newCount : it.second;
+        if (abs(count - oldCount) > 4 || abs(count - newCount) > 4) {
+            if (details != nullptr) {
+                *details = "   In " + currentUcCode + ": \n"
+                         + "   " + it.first + " class has " + to_string(count) + " students.\n"
+                         + "   " + oldClassCode + " class will have " + to_string(oldCount) + " students.\n"
+                         + "   " + newClassCode + " class will have " + to_string(newCount) + " students.\n";
+            }
             return true;
         }
     }
@@ -60,45 +115,280 @@ bool Change::checkIfBalanceBetweenClassesDisturbed(map<string, int> classStudent
 }
 
 /**
- * @brief Attempts to build a new schedule for a student after a class change.
+ * @brief Checks if an enrollment has overlapping non-T classes.
+ *
+ * The schedules of each class are taken from the class schedules index of the context.
  *
- * @param student The student for whom the schedule is built.
- * @return True if the schedule can be built without conflicts, otherwise false.
+ * @param enrollment The classes of the student.
+ * @param details If not null, receives the description of the conflicting classes.
+ * @return True if there is a conflict, otherwise false.
+ *
+ * @complexity O(K log S + P^2), where K is the number of classes and P the number of schedules of the student.
  */
-bool Change::tryBuildNewSchedule(const Student& student) {
-    Consult consult(global);
-    vector<Schedule> studentSchedule = consult.getStudentSchedule(student);
-
-    vector<Schedule> conflictingClasses; // Stores classes with schedule conflicts
+bool Change::hasScheduleConflict(const vector<Class>& enrollment, string* details) const {
+    vector<const Schedule*> studentSchedule;
+    for (const Class& ucClass : enrollment) {
+        for (const Schedule& schedule : context->getClassSchedules(ucClass.UcCode, ucClass.ClassCode)) {
+            studentSchedule.push_back(&schedule);
+        }
+    }
 
+    bool conflict = false;
     for (size_t i = 0; i < studentSchedule.size(); i++) {
         for (size_t j = i + 1; j < studentSchedule.size(); j++) {
-            const Schedule& schedule1 = studentSchedule[i];
-            const Schedule& schedule2 = studentSchedule[j];
+            const Schedule& schedule1 = *studentSchedule[i];
+            const Schedule& schedule2 = *studentSchedule[j];
 
-            if (schedule1.WeekDay == schedule2.WeekDay) {
-                if (schedule1.Type == "T" || schedule2.Type == "T") {
-                    continue;
+            if (schedule1.WeekDay != schedule2.WeekDay || schedule1.Type == "T" || schedule2.Type == "T") {
+                continue;
+            }
+            // Check for non-T classes that overlap
+            if (!(schedule1.StartHour + schedule1.Duration <= schedule2.StartHour ||
+                  schedule2.StartHour + schedule2.Duration <= schedule1.StartHour)) {
+                if (details == nullptr) {
+                    return true;
                 }
-                // Check for non-T classes that overlap
-                if (!(schedule1.StartHour + schedule1.Duration <= schedule2.StartHour ||
-                      schedule2.StartHour + schedule2.Duration <= schedule1.StartHour)) {
-                    conflictingClasses.push_back(schedule1);
-                    conflictingClasses.push_back(schedule2);
+                if (!conflict) {
+                    *details += "Classes with schedule conflicts: \n";
+                }
+                conflict = true;
+                for (const Schedule* schedule : {&schedule1, &schedule2}) {
+                    ostringstream line;
+                    line << "   UC Code: " << schedule->UcToClasses.UcCode << ", Class Code: " << schedule->UcToClasses.ClassCode
+                         << ", Weekday: " << schedule->WeekDay << ", Start Hour: " << schedule->StartHour
+                         << ", Duration: " << schedule->Duration << ", Type: " << schedule->Type << "\n";
+                    *details += line.str();
                 }
             }
         }
     }
+    return conflict;
+}
 
-    if (!conflictingClasses.empty()) {
-        cout << "Classes with schedule conflicts: " << endl;
-        for (const Schedule& schedule : conflictingClasses) {
-            cout << "   UC Code: " << schedule.UcToClasses.UcCode << ", Class Code: " << schedule.UcToClasses.ClassCode << ", Weekday: " << schedule.WeekDay << ", Start Hour: " << schedule.StartHour << ", Duration: " << schedule.Duration << ", Type: " << schedule.Type << endl;
+/**
+ * @brief Finds the first class of a new UC, from the least to the most occupied, that fits the student's schedule.
+ *
+ * @param enrollment The classes of the student, the class at position index is replaced by each candidate.
+ * @param index The position of the new UC in the enrollment.
+ * @param newUcCode The new UC code.
+ * @param verdict The verdict to fill in.
+ */
+void Change::findCompatibleClass(vector<Class>& enrollment, size_t index, const string& newUcCode, ChangeVerdict& verdict) const {
+    map<string, int> classesWithVacancy = classesWithVacancyInNewUC(newUcCode);
+    if (classesWithVacancy.empty()) {
+        verdict.outcome = ChangeOutcome::NoVacancy;
+        return;
+    }
+
+    vector<pair<string, int>> sortedClasses(classesWithVacancy.begin(), classesWithVacancy.end());
+    sort(sortedClasses.begin(), sortedClasses.end(), [](const pair<string, int>& a, const pair<string, int>& b) {
+        return a.second < b.second;
+    });
+
+    // Loops through all classes in UC, the first one without conflicts is chosen
+    for (const auto& entry : sortedClasses) {
+        enrollment[index] = Class(newUcCode, entry.first);
+        if (!hasScheduleConflict(enrollment, &verdict.details)) {
+            verdict.outcome = ChangeOutcome::Accepted;
+            verdict.accepted = true;
+            verdict.newClassCode = entry.first;
+            verdict.details.clear();
+            return;
         }
-        return false; // Can't build schedule
     }
+    verdict.outcome = ChangeOutcome::ScheduleConflict;
+}
 
-    return true; // Can build schedule
+/**
+ * @brief Evaluates a class change on the current data without applying it.
+ *
+ * Runs the same capacity, balance and schedule conflict rules as changeClass, without any output.
+ *
+ * @param student The student that requests the change.
+ * @param currentUcCode The current UC code of the student.
+ * @param currentClassCode The current class code of the student.
+ * @param newClassCode The new class code to change to.
+ * @param suggestAlternatives If true and the change is denied, fill in the classes of the UC that would be accepted.
+ * @return The verdict of the change.
+ *
+ * @complexity O(C log C + P^2) without alternatives, where C is the number of classes of the UC and P the number of schedules of the student.
+ */
+ChangeVerdict Change::evaluateChangeClass(const Student& student, const string& currentUcCode, const string& currentClassCode, const string& newClassCode, bool suggestAlternatives) const {
+    ChangeVerdict verdict;
+    verdict.newUcCode = currentUcCode;
+    verdict.newClassCode = newClassCode;
+
+    auto current = find_if(student.UcToClasses.begin(), student.UcToClasses.end(), [&currentUcCode](const Class& ucClass) {
+        return ucClass.UcCode == currentUcCode;
+    });
+
+    if (currentClassCode == newClassCode) {
+        verdict.outcome = ChangeOutcome::AlreadyEnrolled;
+    } else if (current == student.UcToClasses.end()) {
+        verdict.outcome = ChangeOutcome::NotEnrolled;
+    } else {
+        const map<string, int>& classStudentsCount = context->getClassOccupancy(currentUcCode);
+        if (checkIfClassCapacityExceeds(classStudentsCount, newClassCode)) {
+            verdict.outcome = ChangeOutcome::CapacityExceeded;
+        } else if (checkIfBalanceBetweenClassesDisturbed(classStudentsCount, currentUcCode, currentClassCode, newClassCode, &verdict.details)) {
+            verdict.outcome = ChangeOutcome::BalanceDisturbed;
+        } else {
+            vector<Class> enrollment = student.UcToClasses;
+            enrollment[current - student.UcToClasses.begin()].ClassCode = newClassCode;
+            if (hasScheduleConflict(enrollment, &verdict.details)) {
+                verdict.outcome = ChangeOutcome::ScheduleConflict;
+            } else {
+                verdict.accepted = true;
+            }
+        }
+    }
+
+    if (!verdict.accepted && suggestAlternatives) {
+        for (const string& classCode : context->getClassesOfUc(currentUcCode)) {
+            if (classCode != currentClassCode && classCode != newClassCode &&
+                evaluateChangeClass(student, currentUcCode, currentClassCode, classCode, false).accepted) {
+                verdict.alternatives.push_back(classCode);
+            }
+        }
+    }
+    return verdict;
+}
+
+/**
+ * @brief Evaluates a UC change on the current data without applying it.
+ *
+ * @param student The student that requests the change.
+ * @param currentUcCode The current UC code of the student.
+ * @param currentClassCode The current class code of the student.
+ * @param newUcCode The new UC code to change to.
+ * @param suggestAlternatives If true and the change is denied, fill in the UCs that would be accepted.
+ * @return The verdict of the change, with the class the student would be assigned to.
+ */
+ChangeVerdict Change::evaluateChangeUC(const Student& student, const string& currentUcCode, const string& currentClassCode, const string& newUcCode, bool suggestAlternatives) const {
+    ChangeVerdict verdict;
+    verdict.newUcCode = newUcCode;
+
+    auto current = find_if(student.UcToClasses.begin(), student.UcToClasses.end(), [&currentUcCode](const Class& ucClass) {
+        return ucClass.UcCode == currentUcCode;
+    });
+
+    if (currentUcCode == newUcCode) {
+        verdict.outcome = ChangeOutcome::AlreadyEnrolled;
+    } else if (current == student.UcToClasses.end()) {
+        verdict.outcome = ChangeOutcome::NotEnrolled;
+    } else {
+        vector<Class> enrollment = student.UcToClasses;
+        findCompatibleClass(enrollment, current - student.UcToClasses.begin(), newUcCode, verdict);
+    }
+
+    if (!verdict.accepted && suggestAlternatives) {
+        for (const string& ucCode : context->getUcCodes()) {
+            bool enrolled = any_of(student.UcToClasses.begin(), student.UcToClasses.end(), [&ucCode](const Class& ucClass) {
+                return ucClass.UcCode == ucCode;
+            });
+            if (!enrolled && ucCode != newUcCode &&
+                evaluateChangeUC(student, currentUcCode, currentClassCode, ucCode, false).accepted) {
+                verdict.alternatives.push_back(ucCode);
+            }
+        }
+    }
+    return verdict;
+}
+
+/**
+ * @brief Evaluates leaving a UC and class on the current data without applying it.
+ *
+ * @param student The student that requests the change.
+ * @param ucCode The UC code to leave.
+ * @param classCode The class code to leave.
+ * @return The verdict of the change.
+ */
+ChangeVerdict Change::evaluateLeaveUCAndClass(const Student& student, const string& ucCode, const string& classCode) const {
+    ChangeVerdict verdict;
+    verdict.newUcCode = "-";
+    verdict.newClassCode = "-";
+    if (find(student.UcToClasses.begin(), student.UcToClasses.end(), Class(ucCode, classCode)) != student.UcToClasses.end()) {
+        verdict.accepted = true;
+    } else {
+        verdict.outcome = ChangeOutcome::NotEnrolled;
+    }
+    return verdict;
+}
+
+/**
+ * @brief Evaluates joining a new UC on the current data without applying it.
+ *
+ * @param student The student that requests the change.
+ * @param newUcCode The UC code to join.
+ * @param suggestAlternatives If true and the change is denied, fill in the UCs that would be accepted.
+ * @return The verdict of the change, with the class the student would be assigned to.
+ */
+ChangeVerdict Change::evaluateJoinUCAndClass(const Student& student, const string& newUcCode, bool suggestAlternatives) const {
+    ChangeVerdict verdict;
+    verdict.newUcCode = newUcCode;
+
+    // Check if student will be registered in more than 7 UCs, no other UC would be accepted either
+    if (!checkIfCanJoinNewUC(student)) {
+        verdict.outcome = ChangeOutcome::MaxUcsExceeded;
+        return verdict;
+    }
+
+    vector<Class> enrollment = student.UcToClasses;
+    enrollment.emplace_back();
+    findCompatibleClass(enrollment, enrollment.size() - 1, newUcCode, verdict);
+
+    if (!verdict.accepted && suggestAlternatives) {
+        for (const string& ucCode : context->getUcCodes()) {
+            bool enrolled = any_of(student.UcToClasses.begin(), student.UcToClasses.end(), [&ucCode](const Class& ucClass) {
+                return ucClass.UcCode == ucCode;
+            });
+            if (!enrolled && ucCode != newUcCode && evaluateJoinUCAndClass(student, ucCode, false).accepted) {
+                verdict.alternatives.push_back(ucCode);
+            }
+        }
+    }
+    return verdict;
+}
+
+/**
+ * @brief Evaluates a class swap between two students on the current data without applying it.
+ *
+ * A swap doesn't change the number of students in each class, so only the schedules are checked.
+ *
+ * @param student1 The first student.
+ * @param ucCode The UC in which the swap occurs.
+ * @param classCode1 The class code of the first student.
+ * @param student2 The second student.
+ * @param classCode2 The class code of the second student.
+ * @return The verdict of the change, from the point of view of the first student.
+ */
+ChangeVerdict Change::evaluateSwapClasses(const Student& student1, const string& ucCode, const string& classCode1, const Student& student2, const string& classCode2) const {
+    ChangeVerdict verdict;
+    verdict.newUcCode = ucCode;
+    verdict.newClassCode = classCode2;
+
+    vector<Class> enrollment1 = student1.UcToClasses;
+    vector<Class> enrollment2 = student2.UcToClasses;
+    auto class1 = find(enrollment1.begin(), enrollment1.end(), Class(ucCode, classCode1));
+    auto class2 = find(enrollment2.begin(), enrollment2.end(), Class(ucCode, classCode2));
+
+    if (class1 == enrollment1.end() || class2 == enrollment2.end()) {
+        verdict.outcome = ChangeOutcome::NotEnrolled;
+        return verdict;
+    }
+
+    class1->ClassCode = classCode2;
+    class2->ClassCode = classCode1;
+    if (hasScheduleConflict(enrollment1, nullptr)) {
+        verdict.outcome = ChangeOutcome::ScheduleConflict;
+        verdict.details = "Conflict in Student 1 new schedule.";
+    } else if (hasScheduleConflict(enrollment2, nullptr)) {
+        verdict.outcome = ChangeOutcome::ScheduleConflict;
+        verdict.details = "Conflict in Student 2 new schedule.";
+    } else {
+        verdict.accepted = true;
+    }
+    return verdict;
 }
 
 /**
@@ -106,70 +396,43 @@ bool Change::tryBuildNewSchedule(const Student& student) {
  *
  * Checks for all rules before changing a class, if it passes class is changed, otherwise the request is denied.
  *
+ * @param transaction The write transaction the change is made in.
  * @param student The student for whom the class is changed.
  * @param currentUcCode The current UC code of the student.
  * @param currentClassCode The current class code of the student.
  * @param newClassCode The new class code to change to.
+ * @param evaluated If not null, the verdict of the change already evaluated on the current data.
  */
-void Change::changeClass(Student& student, const string& currentUcCode, const string& currentClassCode, const string& newClassCode) {
+void Change::changeClass(WriteTransaction& transaction, Student& student, const string& currentUcCode, const string& currentClassCode, const string& newClassCode, const ChangeVerdict* evaluated) {
     //register change log
-    logEntry.requestType = "Change Class";
-    logEntry.timestamp = getCurrentTimestamp(); //defined in UtilityFunctions
+    logEntry = ChangeLogEntry();
+    logEntry.requestType = RequestType::ChangeClass;
+    logEntry.timestamp = getCurrentTime(); //defined in UtilityFunctions
     logEntry.studentCode = student.StudentCode;
-    logEntry.studentName = student.StudentName;
-    logEntry.currentUcCode = currentUcCode;
-    logEntry.currentClassCode = currentClassCode;
-    logEntry.newUcCode = currentUcCode;
-    logEntry.newClassCode = newClassCode;
+    logEntry.currentUc = context->getUcId(currentUcCode);
+    logEntry.currentClass = context->getClassId(currentClassCode);
+    logEntry.newUc = logEntry.currentUc;
+    logEntry.newClass = context->getClassId(newClassCode);
 
     cout << "[from " << currentUcCode << " , " << currentClassCode << " to " << newClassCode << "]:" << endl;
     cout << "   Requester Student: " << student.StudentCode << " , " << student.StudentName << endl;
 
-    // Check if new class code is the same as the current class code
-    if (currentClassCode == newClassCode) {
-        cerr << "FAILED: Student already in " << newClassCode << endl;
+    ChangeVerdict verdict = evaluated != nullptr ? *evaluated : evaluateChangeClass(student, currentUcCode, currentClassCode, newClassCode, false);
+    if (!verdict.accepted) {
+        cout << verdict.details;
+        cerr << "FAILED: " << describeOutcome(verdict.outcome) << ", can't change class." << endl;
         logEntry.accepted = false;
-        logEntry.extraNotes = "Student already in" + newClassCode;
+        logEntry.reason = logReasonOf(verdict.outcome);
         return;
-    } else {
-        // Create a map to store #students in each class for a certain uc
-        map<string, int> classStudentsCount;
-        this->global.Students.getStudentsCountInClass(currentUcCode, classStudentsCount);
-        // Check if capacity exceeds
-        if (!checkIfClassCapacityExceeds(classStudentsCount, newClassCode)) {
-            // Check if class balance is disturbed
-            if (!checkIfBalanceBetweenClassesDisturbed(classStudentsCount, currentUcCode, currentClassCode, newClassCode)) {
-                // Change student class to check if schedule can be built
-                for (auto& ucToClass : student.UcToClasses) {
-                    if (ucToClass.UcCode == currentUcCode) {
-                        ucToClass.ClassCode = newClassCode;
-                        // Check for schedule conflict
-                        if (!tryBuildNewSchedule(student)) {
-                            cerr << "FAILED: Conflict in new schedule, can't change class." << endl;
-                            ucToClass.ClassCode = currentClassCode; // Change back to current class
-                            logEntry.accepted = false;
-                            logEntry.extraNotes = "Conflict in new schedule";
-                            return;
-                        }
-                    }
-                }
+    }
 
-                cout << "Class changed successfully!" << endl;
-                logEntry.accepted = true;
-                return;
-            } else {
-                cerr << "FAILED: Balance between classes disturbed, can't change class." << endl;
-                logEntry.accepted = false;
-                logEntry.extraNotes = "Balance between classes disturbed";
-                return;
-            }
-        } else {
-            cerr << "FAILED: Class capacity exceeded, can't change class." << endl;
-            logEntry.accepted = false;
-            logEntry.extraNotes = "Class capacity exceeded";
-            return;
+    for (auto& ucToClass : transaction.edit(student).UcToClasses) {
+        if (ucToClass.UcCode == currentUcCode) {
+            ucToClass.ClassCode = newClassCode;
         }
     }
+    cout << "Class changed successfully!" << endl;
+    logEntry.accepted = true;
 }
 
 /**
@@ -178,31 +441,31 @@ void Change::changeClass(Student& student, const string& currentUcCode, const st
  * @param student The student to check for UC join eligibility.
  * @return True if the student can join a new UC, otherwise false.
  */
-bool Change::checkIfCanJoinNewUC(const Student& student) {
+bool Change::checkIfCanJoinNewUC(const Student& student) const {
     return student.UcToClasses.size() < 7;
 }
 
 /**
- * @brief Returns a map of classes with vacancy in a new UC for a student.
+ * @brief Returns a map of classes with vacancy in a new UC.
  *
- * @param student The student for whom class vacancy is checked.
  * @param newUcCode The UC code to check for vacancy.
  * @return A map containing class codes and available vacancies.
+ *
+ * @complexity O(C log C), where C is the number of classes of the UC.
  */
-map<string, int> Change::classesWithVacancyInNewUC(const Student& student, const string& newUcCode) {
+map<string, int> Change::classesWithVacancyInNewUC(const string& newUcCode) const {
     int cap = 26;
 
     // Create a map to store #students in each class for a certain uc
     map<string, int> classStudentsCount;
-    set<string> allClassCodesInUc;
 
-    for (const Class& ucToClass : this->global.Classes) {
-        if (ucToClass.UcCode == newUcCode) {
-            classStudentsCount[ucToClass.ClassCode] = 0;
-        }
+    for (const string& classCode : context->getClassesOfUc(newUcCode)) {
+        classStudentsCount[classCode] = 0;
     }
 
-    this->global.Students.getStudentsCountInClass(newUcCode, classStudentsCount);
+    for (const auto& it : context->getClassOccupancy(newUcCode)) {
+        classStudentsCount[it.first] = it.second;
+    }
 
     map<string, int> classesWithVacancy;
 
@@ -220,250 +483,176 @@ map<string, int> Change::classesWithVacancyInNewUC(const Student& student, const
  *
  * Checks for all rules, if it passes UC and class are changed, otherwise the request is denied.
  *
+ * @param transaction The write transaction the change is made in.
  * @param student The student for whom UC and class are changed.
  * @param currentUcCode The current UC code of the student.
  * @param currentClassCode The current class code of the student.
  * @param newUcCode The new UC code to change to.
+ * @param evaluated If not null, the verdict of the change already evaluated on the current data.
  */
-void Change::changeUC(Student& student, const string& currentUcCode, const string& currentClassCode, const string& newUcCode) {
+void Change::changeUC(WriteTransaction& transaction, Student& student, const string& currentUcCode, const string& currentClassCode, const string& newUcCode, const ChangeVerdict* evaluated) {
     //register change log
-    logEntry.requestType = "Change UC";
-    logEntry.timestamp = getCurrentTimestamp(); //defined in UtilityFunctions
+    logEntry = ChangeLogEntry();
+    logEntry.requestType = RequestType::ChangeUc;
+    logEntry.timestamp = getCurrentTime(); //defined in UtilityFunctions
     logEntry.studentCode = student.StudentCode;
-    logEntry.studentName = student.StudentName;
-    logEntry.currentUcCode = currentUcCode;
-    logEntry.currentClassCode = currentClassCode;
-    logEntry.newUcCode = newUcCode;
-    logEntry.newClassCode = "-";
+    logEntry.currentUc = context->getUcId(currentUcCode);
+    logEntry.currentClass = context->getClassId(currentClassCode);
+    logEntry.newUc = context->getUcId(newUcCode);
 
     cout << "[from " << currentUcCode << " to " << newUcCode << "]:" << endl;
     cout << "   Requester Student: " << student.StudentCode << " , " << student.StudentName << endl;
 
-    bool ucAndClassChanged = false;
-
-    // Check if new uc code is the same as the current uc code
-    if (currentUcCode == newUcCode) {
-        cerr << "FAILED: Student already in " << newUcCode << endl;
+    ChangeVerdict verdict = evaluated != nullptr ? *evaluated : evaluateChangeUC(student, currentUcCode, currentClassCode, newUcCode, false);
+    if (!verdict.accepted) {
+        cout << verdict.details;
+        cerr << "FAILED: " << describeOutcome(verdict.outcome) << ", can't change" << endl;
         logEntry.accepted = false;
-        logEntry.extraNotes = "Student already in";
+        logEntry.reason = logReasonOf(verdict.outcome);
         return;
-    } else {
-        map<string, int> classesWithVacancy = classesWithVacancyInNewUC(student, newUcCode);
-        if (!classesWithVacancy.empty()) {
-            // Change student UC to check
-            for (auto& ucToClass : student.UcToClasses) {
-                if (ucToClass.UcCode == currentUcCode) {
-                    ucToClass.UcCode = newUcCode;
-
-                    vector <pair<string, int>> sortedClasses(classesWithVacancy.begin(), classesWithVacancy.end());
-
-                    sort(sortedClasses.begin(), sortedClasses.end(), [](const pair<string, int>& a, const pair<string, int>& b) {
-                        return a.second < b.second;
-                    });
-
-                    // Loops through all classes in UC
-                    for (const auto& entry: sortedClasses) {
-                        // Change class to the new class
-                        ucToClass.ClassCode = entry.first;
-                        // Tries to build schedule, if not successful, loop to next class
-                        if (tryBuildNewSchedule(student)) {
-                            cout << "UC and class changed successfully!" << endl;
-                            cout << newUcCode << ", " << ucToClass.ClassCode << endl;
-                            ucAndClassChanged = true;
-
-                            // After changing UC, sort the student's UCs
-                            sort(student.UcToClasses.begin(), student.UcToClasses.end(), [](const Class& a, const Class& b) {
-                                return a.UcCode < b.UcCode;
-                            });
-
-                            logEntry.accepted = true;
-                            logEntry.newClassCode = entry.first;
-                            break;
-                        }
-                    }
-                    // If student was not able to enter a new UC and class
-                    if (!ucAndClassChanged) {
-                        // Change them back
-                        ucToClass.UcCode = currentUcCode;
-                        ucToClass.ClassCode = currentClassCode;
-                        cerr << "FAILED: Conflict in new schedule, can't change" << endl;
-                        logEntry.accepted = false;
-                        logEntry.extraNotes = "Conflict in new schedule";
-                    }
-                }
-            }
-        } else {
-            cerr << "FAILED: No class with vacancy in the new UC or UC doesn't exist" << endl;
-            logEntry.accepted = false;
-            logEntry.extraNotes = "No class with vacancy in the new UC or UC doesn't exist";
+    }
+
+    for (auto& ucToClass : transaction.edit(student).UcToClasses) {
+        if (ucToClass.UcCode == currentUcCode) {
+            ucToClass = Class(newUcCode, verdict.newClassCode);
+            break;
         }
     }
+
+    // After changing UC, sort the student's UCs
+    sort(student.UcToClasses.begin(), student.UcToClasses.end(), [](const Class& a, const Class& b) {
+        return a.UcCode < b.UcCode;
+    });
+
+    cout << "UC and class changed successfully!" << endl;
+    cout << newUcCode << ", " << verdict.newClassCode << endl;
+    logEntry.accepted = true;
+    logEntry.newClass = context->getClassId(verdict.newClassCode);
 }
 
 /**
  * Removes a specific UC and class for a student.
  *
  * This function removes the specified UC and class from the student's list of UCs and classes.
+ * @param transaction The write transaction the change is made in.
  * @param student The student for whom the UC and class are to be removed.
  * @param ucCode The code of the UC to leave.
  * @param classCode The code of the class to leave.
+ * @param evaluated If not null, the verdict of the change already evaluated on the current data.
  */
-void Change::leaveUCAndClass(Student& student, const string& ucCode, const string& classCode) {
+void Change::leaveUCAndClass(WriteTransaction& transaction, Student& student, const string& ucCode, const string& classCode, const ChangeVerdict* evaluated) {
     //register change log
-    logEntry.requestType = "Leave UC and Class";
-    logEntry.timestamp = getCurrentTimestamp(); //defined in UtilityFunctions
+    logEntry = ChangeLogEntry();
+    logEntry.requestType = RequestType::LeaveUcAndClass;
+    logEntry.timestamp = getCurrentTime(); //defined in UtilityFunctions
     logEntry.studentCode = student.StudentCode;
-    logEntry.studentName = student.StudentName;
-    logEntry.currentUcCode = ucCode;
-    logEntry.currentClassCode = classCode;
-    logEntry.newUcCode = "-";
-    logEntry.newClassCode = "-";
+    logEntry.currentUc = context->getUcId(ucCode);
+    logEntry.currentClass = context->getClassId(classCode);
 
     cout << "[from " << ucCode << " , " << classCode << "]:" << endl;
     cout << "   Requester Student: " << student.StudentCode << " , " << student.StudentName << endl;
 
-    // Iterate through the classes in student.UcToClasses
-    for (auto it = student.UcToClasses.begin(); it != student.UcToClasses.end(); ++it) {
-        // Check if the ucClass matches the provided ucCode and classCode
-        if (it->UcCode == ucCode && it->ClassCode == classCode) {
-            // Remove the matched class
-            student.UcToClasses.erase(it);
-            cout << "UC and class removed successfully!" << endl;
-            logEntry.accepted = true;
-            break; // Exit the loop after removing one UC and class
-        }
+    ChangeVerdict verdict = evaluated != nullptr ? *evaluated : evaluateLeaveUCAndClass(student, ucCode, classCode);
+    if (!verdict.accepted) {
+        cerr << "FAILED: " << describeOutcome(verdict.outcome) << endl;
+        logEntry.accepted = false;
+        logEntry.reason = logReasonOf(verdict.outcome);
+        return;
     }
+
+    vector<Class>& ucToClasses = transaction.edit(student).UcToClasses;
+    ucToClasses.erase(find(ucToClasses.begin(), ucToClasses.end(), Class(ucCode, classCode)));
+    cout << "UC and class removed successfully!" << endl;
+    logEntry.accepted = true;
 }
 
 /**
  * Add a new UC and class to a student.
  *
  * This function adds the student to the specified UC and class if it respects all rules.
+ * @param transaction The write transaction the change is made in.
  * @param student The student to join the new UC and class.
  * @param newUcCode The code of the new UC to join.
+ * @param evaluated If not null, the verdict of the change already evaluated on the current data.
  */
-void Change::joinUCAndClass(Student& student, const string& newUcCode) {
+void Change::joinUCAndClass(WriteTransaction& transaction, Student& student, const string& newUcCode, const ChangeVerdict* evaluated) {
     //register change log
-    logEntry.requestType = "Leave UC and Class";
-    logEntry.timestamp = getCurrentTimestamp(); //defined in UtilityFunctions
+    logEntry = ChangeLogEntry();
+    logEntry.requestType = RequestType::JoinUcAndClass;
+    logEntry.timestamp = getCurrentTime(); //defined in UtilityFunctions
     logEntry.studentCode = student.StudentCode;
-    logEntry.studentName = student.StudentName;
-    logEntry.currentUcCode = "-";
-    logEntry.currentClassCode = "-";
-    logEntry.newUcCode = newUcCode;
-    logEntry.newClassCode = "-";
+    logEntry.newUc = context->getUcId(newUcCode);
 
     cout << "[to " << newUcCode << "]:" << endl;
     cout << "   Requester Student: " << student.StudentCode << " , " << student.StudentName << endl;
 
-    bool ucAndClassAdded = false;
-
-    // Check if student will be registered in more than 7 UCs
-    if (!checkIfCanJoinNewUC(student)) {
-        cerr << "FAILED: Maximum number of UCs will exceed (max: 7 UCs)." << endl;
+    ChangeVerdict verdict = evaluated != nullptr ? *evaluated : evaluateJoinUCAndClass(student, newUcCode, false);
+    if (!verdict.accepted) {
+        cout << verdict.details;
+        cerr << "FAILED: " << describeOutcome(verdict.outcome) << endl;
         logEntry.accepted = false;
-        logEntry.extraNotes = "Maximum number of UCs will exceed (max 7 UCs)";
-    } else {
-        map<string, int> classesWithVacancy = classesWithVacancyInNewUC(student, newUcCode);
-
-        if (!classesWithVacancy.empty()) {
-            vector<pair<string, int>> sortedClasses(classesWithVacancy.begin(), classesWithVacancy.end());
+        logEntry.reason = logReasonOf(verdict.outcome);
+        return;
+    }
 
-            sort(sortedClasses.begin(), sortedClasses.end(), [](const pair<string, int>& a, const pair<string, int>& b) {
-                return a.second < b.second;
-            });
+    transaction.edit(student).UcToClasses.emplace_back(newUcCode, verdict.newClassCode);
+    sort(student.UcToClasses.begin(), student.UcToClasses.end(), [](const Class& a, const Class& b) {
+        return a.UcCode < b.UcCode;
+    });
 
-            for (const auto& entry: sortedClasses) {
-                Class newClass = Class(newUcCode, entry.first);
-                student.UcToClasses.push_back(newClass);
-                if (tryBuildNewSchedule(student)) {
-                    cout << "UC and class added successfully!" << endl;
-                    cout << newUcCode << ", " << newClass.ClassCode << endl;
-                    ucAndClassAdded = true;
-
-                    sort(student.UcToClasses.begin(), student.UcToClasses.end(), [](const Class& a, const Class& b) {
-                        return a.UcCode < b.UcCode;
-                    });
-
-                    logEntry.accepted = true;
-                    logEntry.newClassCode = entry.first;
-
-                    break;
-                } else {
-                    // Find the iterator pointing to the newly added class
-                    auto it = student.UcToClasses.end() - 1;
-                    cerr << "Conflict in new schedule , can't join " << it->ClassCode << endl;
-                    student.UcToClasses.erase(it);  // Erase the last added class
-                }
-            }
-            if (!ucAndClassAdded) {
-                cerr << "FAILED: No matching UC and class found for adding." << endl;
-                logEntry.accepted = false;
-                logEntry.extraNotes = "No matching UC and class found for adding";
-            }
-        } else {
-            cerr << "FAILED: No class with vacancy in the new UC." << endl;
-            logEntry.accepted = false;
-            logEntry.extraNotes = "No class with vacancy in the new UC";
-        }
-    }
+    cout << "UC and class added successfully!" << endl;
+    cout << newUcCode << ", " << verdict.newClassCode << endl;
+    logEntry.accepted = true;
+    logEntry.newClass = context->getClassId(verdict.newClassCode);
 }
 
 /**
  * Swaps classes between two students within the same UC.
  *
  * This function swaps the class of student1 with that of student2 within the same UC.
+ * @param transaction The write transaction the change is made in.
  * @param student1 The first student to swap classes with.
  * @param ucCode The code of the UC in which the swap occurs.
  * @param classCode1 The code of the first class to swap.
  * @param student2 The second student to swap classes with.
  * @param classCode2 The code of the second class to swap.
+ * @param evaluated If not null, the verdict of the change already evaluated on the current data.
  */
-void Change::swapClassesBetweenStudents(Student& student1, const string& ucCode, const string& classCode1, Student& student2, const string& classCode2) {
+void Change::swapClassesBetweenStudents(WriteTransaction& transaction, Student& student1, const string& ucCode, const string& classCode1, Student& student2, const string& classCode2, const ChangeVerdict* evaluated) {
     //register change log
-    logEntry.requestType = "Swap Class with other student";
-    logEntry.timestamp = getCurrentTimestamp(); //defined in UtilityFunctions
+    logEntry = ChangeLogEntry();
+    logEntry.requestType = RequestType::SwapClass;
+    logEntry.timestamp = getCurrentTime(); //defined in UtilityFunctions
     logEntry.studentCode = student1.StudentCode;
-    logEntry.studentName = student1.StudentName;
-    logEntry.currentUcCode = ucCode;
-    logEntry.currentClassCode = classCode1;
-    logEntry.newUcCode = ucCode;
-    logEntry.newClassCode = classCode2;
-    logEntry.extraNotes = "Swap with student \"" + student2.StudentName +  "\" (" + to_string(student2.StudentCode) + ").\n";
+    logEntry.currentUc = context->getUcId(ucCode);
+    logEntry.currentClass = context->getClassId(classCode1);
+    logEntry.newUc = logEntry.currentUc;
+    logEntry.newClass = context->getClassId(classCode2);
+    logEntry.otherStudentCode = student2.StudentCode;
     cout << "[from " << ucCode << " , " << classCode1 << " with " << classCode2 << "]:" << endl;
     cout << "   Requester Student: " << student1.StudentCode << " , " << student1.StudentName << " , " << classCode1 << endl;
     cout << "   Requester Student: " << student2.StudentCode << " , " << student2.StudentName << " , " << classCode2 << endl;
 
-    // Change student1 class to check if schedule can be built
-    for (auto& ucToClass : student1.UcToClasses) {
+    ChangeVerdict verdict = evaluated != nullptr ? *evaluated : evaluateSwapClasses(student1, ucCode, classCode1, student2, classCode2);
+    if (!verdict.accepted) {
+        string reason = verdict.details.empty() ? describeOutcome(verdict.outcome) : verdict.details;
+        cerr << "FAILED: " << reason << " Can't swap classes." << endl;
+        logEntry.accepted = false;
+        logEntry.reason = logReasonOf(verdict.outcome);
+        return;
+    }
+
+    for (auto& ucToClass : transaction.edit(student1).UcToClasses) {
         if (ucToClass.UcCode == ucCode) {
             ucToClass.ClassCode = classCode2;
-            // Check for schedule conflict
-            if (!tryBuildNewSchedule(student1)) {
-                cerr << "FAILED: Conflict in Student 1 new schedule, can't swap classes." << endl;
-                ucToClass.ClassCode = classCode1; // Change back to current class
-                logEntry.accepted = false;
-                logEntry.extraNotes += "Conflict in Student 1 new schedule.";
-                return;
-            }
         }
     }
-
-    // Change student2 class to check if schedule can be built
-    for (auto& ucToClass : student2.UcToClasses) {
+    for (auto& ucToClass : transaction.edit(student2).UcToClasses) {
         if (ucToClass.UcCode == ucCode) {
             ucToClass.ClassCode = classCode1;
-            // Check for schedule conflict
-            if (!tryBuildNewSchedule(student2)) {
-                cerr << "FAILED: Conflict in Student 2 new schedule, can't swap classes." << endl;
-                ucToClass.ClassCode = classCode2; // Change back to current class
-                logEntry.accepted = false;
-                logEntry.extraNotes += "Conflict in Student 2 new schedule.";
-                return;
-            }
         }
     }
 
     cout << "Classes swapped successfully!" << endl;
-    return;
+    logEntry.accepted = true;
 }
\ No newline at end of file
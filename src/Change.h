@@ -8,6 +8,49 @@
 
 #include "ReadData.h"
 #include "Consult.h"
+#include "DataContext.h"
+
+/**
+ * @enum ChangeOutcome
+ * @brief The result of checking a change against the rules.
+ */
+enum class ChangeOutcome {
+    Accepted,         ///< The change respects every rule.
+    AlreadyEnrolled,  ///< The student is already in the new class or UC.
+    NotEnrolled,      ///< The student is not in the class or UC to change.
+    CapacityExceeded, ///< The new class would exceed its capacity.
+    BalanceDisturbed, ///< The balance between the classes of the UC would be disturbed.
+    ScheduleConflict, ///< The new schedule would have overlapping classes.
+    MaxUcsExceeded,   ///< The student would be registered in more than 7 UCs.
+    NoVacancy         ///< No class of the new UC has vacancy.
+};
+
+/**
+ * @brief Get a human readable description of a change outcome.
+ * @param outcome The outcome to describe.
+ * @return The description of the outcome.
+ */
+string describeOutcome(ChangeOutcome outcome);
+
+/**
+ * @brief Get the reason a change log records for a change outcome.
+ * @param outcome The outcome.
+ * @return The reason of the outcome, None if it was accepted.
+ */
+LogReason logReasonOf(ChangeOutcome outcome);
+
+/**
+ * @struct ChangeVerdict
+ * @brief The verdict of evaluating a change without applying it.
+ */
+struct ChangeVerdict {
+    ChangeOutcome outcome = ChangeOutcome::Accepted; ///< The first rule that denies the change, or Accepted.
+    bool accepted = false;        ///< True if the change would be accepted.
+    string newUcCode;             ///< The UC the student would end up in.
+    string newClassCode;          ///< The class the student would end up in.
+    string details;               ///< Extra information about the outcome (balance numbers, conflicting classes).
+    vector<string> alternatives;  ///< Classes or UCs for which the same change would be accepted.
+};
 
 /**
  * @class Change
@@ -17,18 +60,31 @@
  * and ensuring a balance between classes. It also manages student schedule updates and supports
  * changing UCs and classes for students, as well as swapping classes between students.
  *
+ * Every change can be evaluated on the current data without modifying it (dry-run), the methods
+ * that apply a change use the same evaluation to decide if the change is accepted.
+ *
  * This class facilitates necessary changes to student enrollments and schedules.
  */
 class Change {
+private:
+    /**
+     * @brief Find the first class of a UC, from the least to the most occupied, that fits the enrollment.
+     * @param enrollment The classes of the student, with a placeholder for the new UC at position index.
+     * @param index The position of the new UC in the enrollment.
+     * @param newUcCode The new UC code.
+     * @param verdict The verdict to fill in.
+     */
+    void findCompatibleClass(vector<Class>& enrollment, size_t index, const string& newUcCode, ChangeVerdict& verdict) const;
+
 public:
-    Global global;
+    shared_ptr<DataContext> context; ///< The data context shared with the rest of the application.
     ChangeLogEntry logEntry;
 
     /**
      * @brief Constructor for the Change class.
-     * @param globalCopy The Global object to initialize with.
+     * @param context The shared data context to read from.
      */
-    Change(Global& globalCopy);
+    Change(shared_ptr<DataContext> context);
 
     /**
      * @brief Check if adding a student to a new class will exceed its capacity.
@@ -36,7 +92,7 @@ public:
      * @param newClassCode The class code to check.
      * @return True if adding the student will exceed the capacity, otherwise false.
      */
-    bool checkIfClassCapacityExceeds(map<string, int> classStudentsCount, const string& newClassCode);
+    bool checkIfClassCapacityExceeds(const map<string, int>& classStudentsCount, const string& newClassCode) const;
 
     /**
      * @brief Check if changing a student's class would disturb the balance between classes.
@@ -44,81 +100,136 @@ public:
      * @param currentUcCode The current UC code.
      * @param oldClassCode The old class code.
      * @param newClassCode The new class code.
+     * @param details If not null, receives the class counts that disturb the balance.
      * @return True if the balance is disturbed, otherwise false.
      */
-    bool checkIfBalanceBetweenClassesDisturbed(map<string, int> classStudentsCount, const string& currentUcCode, const string& oldClassCode, const string& newClassCode);
+    bool checkIfBalanceBetweenClassesDisturbed(const map<string, int>& classStudentsCount, const string& currentUcCode, const string& oldClassCode, const string& newClassCode, string* details = nullptr) const;
 
     /**
-     * @brief Try to build a new schedule for a student.
-     * @param student The Student object for which to build a schedule.
-     * @return True if the schedule is successfully built, otherwise false.
+     * @brief Check if an enrollment has overlapping non-T classes.
+     * @param enrollment The classes of the student.
+     * @param details If not null, receives the description of the conflicting classes.
+     * @return True if there is a conflict, otherwise false.
      */
-    bool tryBuildNewSchedule(const Student& student);
+    bool hasScheduleConflict(const vector<Class>& enrollment, string* details = nullptr) const;
 
     /**
-     * @brief Get the schedule of a student.
+     * @brief Evaluate a class change without applying it.
      * @param student The Student object.
-     * @param studentSchedule The vector to store the student's schedule.
+     * @param currentUcCode The current UC code.
+     * @param currentClassCode The current class code.
+     * @param newClassCode The new class code.
+     * @param suggestAlternatives If true and the change is denied, fill in the classes of the UC that would be accepted.
+     * @return The verdict of the change.
      */
-    void getStudentSchedule(const Student& student, vector<Schedule>& studentSchedule);
+    ChangeVerdict evaluateChangeClass(const Student& student, const string& currentUcCode, const string& currentClassCode, const string& newClassCode, bool suggestAlternatives = true) const;
+
+    /**
+     * @brief Evaluate a UC change without applying it.
+     * @param student The Student object.
+     * @param currentUcCode The current UC code.
+     * @param currentClassCode The current class code.
+     * @param newUcCode The new UC code.
+     * @param suggestAlternatives If true and the change is denied, fill in the UCs that would be accepted.
+     * @return The verdict of the change.
+     */
+    ChangeVerdict evaluateChangeUC(const Student& student, const string& currentUcCode, const string& currentClassCode, const string& newUcCode, bool suggestAlternatives = true) const;
+
+    /**
+     * @brief Evaluate leaving a UC and class without applying it.
+     * @param student The Student object.
+     * @param ucCode The UC code to leave.
+     * @param classCode The class code to leave.
+     * @return The verdict of the change.
+     */
+    ChangeVerdict evaluateLeaveUCAndClass(const Student& student, const string& ucCode, const string& classCode) const;
+
+    /**
+     * @brief Evaluate joining a UC without applying it.
+     * @param student The Student object.
+     * @param newUcCode The new UC code to join.
+     * @param suggestAlternatives If true and the change is denied, fill in the UCs that would be accepted.
+     * @return The verdict of the change.
+     */
+    ChangeVerdict evaluateJoinUCAndClass(const Student& student, const string& newUcCode, bool suggestAlternatives = true) const;
+
+    /**
+     * @brief Evaluate a class swap between two students without applying it.
+     * @param student1 The first Student object.
+     * @param ucCode The UC code of the classes to be swapped.
+     * @param classCode1 The class code of the first student.
+     * @param student2 The second Student object.
+     * @param classCode2 The class code of the second student.
+     * @return The verdict of the change, from the point of view of the first student.
+     */
+    ChangeVerdict evaluateSwapClasses(const Student& student1, const string& ucCode, const string& classCode1, const Student& student2, const string& classCode2) const;
 
     /**
      * @brief Change the class of a student.
+     * @param transaction The write transaction the change is made in.
      * @param student The Student object to change the class for.
      * @param currentUcCode The current UC code.
      * @param currentClassCode The current class code.
      * @param newClassCode The new class code.
+     * @param evaluated If not null, the verdict of the change already evaluated on the current data.
      */
-    void changeClass(Student& student, const string& currentUcCode, const string& currentClassCode, const string& newClassCode);
+    void changeClass(WriteTransaction& transaction, Student& student, const string& currentUcCode, const string& currentClassCode, const string& newClassCode, const ChangeVerdict* evaluated = nullptr);
 
     /**
      * @brief Check if a student can join a new UC.
      * @param student The Student object.
      * @return True if the student can join the new UC, otherwise false.
      */
-    bool checkIfCanJoinNewUC(const Student& student);
+    bool checkIfCanJoinNewUC(const Student& student) const;
 
     /**
-     * @brief Find all classes with vacancy in a new UC for a student.
-     * @param student The Student object.
+     * @brief Find all classes with vacancy in a new UC.
      * @param newUcCode The new UC code.
      * @return A map of class codes and their vacancy counts.
      */
-    map<string, int> classesWithVacancyInNewUC(const Student& student, const string& newUcCode);
+    map<string, int> classesWithVacancyInNewUC(const string& newUcCode) const;
 
     /**
      * @brief Change the UC and respective class of a student，student can choose the UC to go but class can't be chosen.
+     * @param transaction The write transaction the change is made in.
      * @param student The Student object to change the UC for.
      * @param currentUcCode The current UC code.
      * @param currentClassCode The current class code.
      * @param newUcCode The new UC code.
+     * @param evaluated If not null, the verdict of the change already evaluated on the current data.
      */
-    void changeUC(Student& student, const string& currentUcCode, const string& currentClassCode, const string& newUcCode);
+    void changeUC(WriteTransaction& transaction, Student& student, const string& currentUcCode, const string& currentClassCode, const string& newUcCode, const ChangeVerdict* evaluated = nullptr);
 
     /**
      * @brief Leave a UC and respective class for a student.
+     * @param transaction The write transaction the change is made in.
      * @param student The Student object.
      * @param ucCode The UC code to leave.
      * @param classCode The class code to leave.
+     * @param evaluated If not null, the verdict of the change already evaluated on the current data.
      */
-    void leaveUCAndClass(Student& student, const string& ucCode, const string& classCode);
+    void leaveUCAndClass(WriteTransaction& transaction, Student& student, const string& ucCode, const string& classCode, const ChangeVerdict* evaluated = nullptr);
 
     /**
      * @brief Join a UC and class for a student.
+     * @param transaction The write transaction the change is made in.
      * @param student The Student object.
      * @param newUcCode The new UC code to join.
+     * @param evaluated If not null, the verdict of the change already evaluated on the current data.
      */
-    void joinUCAndClass(Student& student, const string& newUcCode);
+    void joinUCAndClass(WriteTransaction& transaction, Student& student, const string& newUcCode, const ChangeVerdict* evaluated = nullptr);
 
     /**
      * @brief Swap classes between two students.
+     * @param transaction The write transaction the change is made in.
      * @param student1 The first Student object.
      * @param ucCode The UC code of the classes to be swapped.
      * @param classCode1 The class code of the first student.
      * @param student2 The second Student object.
      * @param classCode2 The class code of the second student.
+     * @param evaluated If not null, the verdict of the change already evaluated on the current data.
      */
-    void swapClassesBetweenStudents(Student& student1, const string& ucCode, const string& classCode1, Student& student2, const string& classCode2);
+    void swapClassesBetweenStudents(WriteTransaction& transaction, Student& student1, const string& ucCode, const string& classCode1, Student& student2, const string& classCode2, const ChangeVerdict* evaluated = nullptr);
 
     vector<string> successfulRequests;
     vector<string> failedRequests;
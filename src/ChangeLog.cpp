@@ -0,0 +1,364 @@
+/**
+ * @file ChangeLog.cpp
+ * @brief Implementation of the ChangeLog class.
+ */
+
+#include "ChangeLog.h"
+#include "DataContext.h"
+#include <numeric>
+
+/**
+ * @brief Constructor for the ChangeLog class, the log is empty.
+ */
+ChangeLog::ChangeLog() : chronological(true) {}
+
+/**
+ * @brief Adds an entry to the index of a UC, growing the UC index up to that id.
+ *
+ * @param uc The id of the UC.
+ * @param position The position of the entry.
+ */
+void ChangeLog::indexUc(UcId uc, size_t position) {
+    if (uc >= byUc.size()) {
+        byUc.resize((size_t) uc + 1);
+    }
+    byUc[uc].push_back(position);
+}
+
+/**
+ * @brief Adds the last entry to the indexes.
+ *
+ * @complexity O(1) amortized, and the update of the statistics.
+ */
+void ChangeLog::indexLast() {
+    size_t position = entries.size() - 1;
+    const ChangeLogEntry& entry = entries.back();
+    if (position > 0 && entry.timestamp < entries[position - 1].timestamp) {
+        chronological = false;
+    }
+    (entry.accepted ? acceptedPositions : deniedPositions).push_back(position);
+    byType[(size_t) entry.requestType].push_back(position);
+    byStudent[entry.studentCode].push_back(position);
+    if (entry.currentUc != InvalidId) {
+        indexUc(entry.currentUc, position);
+    }
+    if (entry.newUc != InvalidId && entry.newUc != entry.currentUc) {
+        indexUc(entry.newUc, position);
+    }
+    if (entry.changeId != NoChange) {
+        byChange.emplace_back(entry.changeId, position);
+    }
+    stats.add(entry);
+}
+
+/**
+ * @brief Checks if an entry meets the conditions of a filter.
+ *
+ * @param entry The entry.
+ * @param filter The filter.
+ * @return True if the entry meets every condition, otherwise false.
+ */
+bool ChangeLog::matches(const ChangeLogEntry& entry, const ChangeLogFilter& filter) {
+    return (filter.state == LogState::Any || entry.accepted == (filter.state == LogState::Accepted))
+           && (!filter.requestType || entry.requestType == *filter.requestType)
+           && (filter.studentCode == 0 || entry.studentCode == filter.studentCode)
+           && (filter.uc == InvalidId || entry.currentUc == filter.uc || entry.newUc == filter.uc)
+           && entry.timestamp >= filter.from && entry.timestamp < filter.until;
+}
+
+/**
+ * @brief Replaces the log with the entries recovered from a previous run.
+ *
+ * The reviews of the administrator are counted again from the reasons of the entries: a reversed entry
+ * was reversed once, and a restored entry was reversed and then restored.
+ *
+ * @param recovered The entries, in logging order.
+ *
+ * @complexity O(n), where n is the number of entries.
+ */
+void ChangeLog::restore(vector<ChangeLogEntry> recovered) {
+    *this = ChangeLog();
+    entries.reserve(recovered.size());
+    for (ChangeLogEntry& entry : recovered) {
+        entries.push_back(std::move(entry));
+        indexLast();
+        if (entries.back().reason == LogReason::ReversedByAdministrator || entries.back().reason == LogReason::RestoredByAdministrator) {
+            stats.review(false);
+        }
+        if (entries.back().reason == LogReason::RestoredByAdministrator) {
+            stats.review(true);
+        }
+    }
+}
+
+/**
+ * @brief Adds an entry at the end of the log.
+ *
+ * @param entry The entry, its change id must be NoChange or greater than the change ids in the log.
+ *
+ * @complexity O(1) amortized
+ */
+void ChangeLog::append(const ChangeLogEntry& entry) {
+    entries.push_back(entry);
+    indexLast();
+}
+
+/**
+ * @brief Gets the number of entries.
+ *
+ * @return The number of entries.
+ */
+size_t ChangeLog::size() const {
+    return entries.size();
+}
+
+/**
+ * @brief Checks if the log has no entries.
+ *
+ * @return True if the log is empty, otherwise false.
+ */
+bool ChangeLog::empty() const {
+    return entries.empty();
+}
+
+/**
+ * @brief Gets an entry.
+ *
+ * @param position The position of the entry, less than the size.
+ * @return The entry.
+ */
+const ChangeLogEntry& ChangeLog::operator[](size_t position) const {
+    return entries[position];
+}
+
+/**
+ * @brief Gets the last entry, the log must not be empty.
+ *
+ * @return The last entry.
+ */
+const ChangeLogEntry& ChangeLog::back() const {
+    return entries.back();
+}
+
+/**
+ * @brief Finds the entries of some changes of the undo history, by binary search in the change index.
+ *
+ * @param changeIds The ids of the changes.
+ * @return The positions of their entries, in increasing order.
+ *
+ * @complexity O(c log n + k log k), where c is the number of changes and k the number of entries found.
+ */
+vector<size_t> ChangeLog::positionsOfChanges(const vector<size_t>& changeIds) const {
+    vector<size_t> positions;
+    for (size_t changeId : changeIds) {
+        auto it = lower_bound(byChange.begin(), byChange.end(), make_pair(changeId, (size_t) 0));
+        for (; it != byChange.end() && it->first == changeId; it++) {
+            positions.push_back(it->second);
+        }
+    }
+    sort(positions.begin(), positions.end());
+    return positions;
+}
+
+/**
+ * @brief Sets the state and the reason of some entries, keeping the state indexes up to date.
+ *
+ * The entries whose state changes leave one state index and are merged into the other, so the
+ * indexes stay sorted without being rebuilt.
+ *
+ * @param positions The positions of the entries, in increasing order.
+ * @param accepted The new state of the entries.
+ * @param reason The new reason of the entries.
+ *
+ * @complexity O(a + d + k), where a and d are the numbers of accepted and denied entries and k the number of positions.
+ */
+void ChangeLog::mark(const vector<size_t>& positions, bool accepted, LogReason reason) {
+    vector<size_t> moved;
+    for (size_t position : positions) {
+        ChangeLogEntry& entry = entries[position];
+        if (entry.accepted != accepted) {
+            moved.push_back(position);
+            stats.review(accepted);
+        }
+        entry.accepted = accepted;
+        entry.reason = reason;
+    }
+    if (moved.empty()) {
+        return;
+    }
+    vector<size_t>& source = accepted ? deniedPositions : acceptedPositions;
+    vector<size_t>& target = accepted ? acceptedPositions : deniedPositions;
+
+    vector<size_t> kept;
+    kept.reserve(source.size() - moved.size());
+    set_difference(source.begin(), source.end(), moved.begin(), moved.end(), back_inserter(kept));
+    source.swap(kept);
+
+    size_t middle = target.size();
+    target.insert(target.end(), moved.begin(), moved.end());
+    inplace_merge(target.begin(), target.begin() + (ptrdiff_t) middle, target.end());
+}
+
+/**
+ * @brief Selects the entries that meet the conditions of a filter.
+ *
+ * The time range is narrowed to a range of positions by binary search. Then the shortest index of the
+ * conditions of the filter, cut to that range, gives the candidates, on which the other conditions are
+ * checked; without an index shorter than the range, the range itself is gone through. A filter with
+ * a single condition is answered by copying its index, cut to the range, without reading the entries.
+ *
+ * @param filter The filter.
+ * @return The positions of the selected entries, in increasing order.
+ *
+ * @complexity O(log n + m), where m is the length of the shortest index or range of the filter.
+ */
+vector<size_t> ChangeLog::select(const ChangeLogFilter& filter) const {
+    size_t first = 0, last = entries.size();
+    if (chronological && filter.from != INT64_MIN) {
+        first = (size_t) (partition_point(entries.begin(), entries.end(), [&filter](const ChangeLogEntry& entry) {
+            return entry.timestamp < filter.from;
+        }) - entries.begin());
+    }
+    if (chronological && filter.until != INT64_MAX) {
+        last = (size_t) (partition_point(entries.begin(), entries.end(), [&filter](const ChangeLogEntry& entry) {
+            return entry.timestamp < filter.until;
+        }) - entries.begin());
+    }
+    if (first >= last) {
+        return {};
+    }
+
+    static const vector<size_t> none;
+    const vector<size_t>* candidates = nullptr;
+    size_t conditions = 0;
+    auto consider = [&candidates, &conditions](const vector<size_t>& index) {
+        if (candidates == nullptr || index.size() < candidates->size()) {
+            candidates = &index;
+        }
+        conditions++;
+    };
+    if (filter.state != LogState::Any) {
+        consider(filter.state == LogState::Accepted ? acceptedPositions : deniedPositions);
+    }
+    if (filter.requestType) {
+        consider(byType[(size_t) *filter.requestType]);
+    }
+    if (filter.studentCode != 0) {
+        auto it = byStudent.find(filter.studentCode);
+        consider(it == byStudent.end() ? none : it->second);
+    }
+    if (filter.uc != InvalidId) {
+        consider(filter.uc < byUc.size() ? byUc[filter.uc] : none);
+    }
+
+    // With a single condition and an exact range, the index or the range is the selection
+    bool exactRange = chronological || (filter.from == INT64_MIN && filter.until == INT64_MAX);
+    vector<size_t> selected;
+    if (exactRange && conditions == 0) {
+        selected.resize(last - first);
+        iota(selected.begin(), selected.end(), first);
+    } else if (exactRange && conditions == 1) {
+        auto begin = lower_bound(candidates->begin(), candidates->end(), first);
+        selected.assign(begin, lower_bound(begin, candidates->end(), last));
+    } else if (candidates == nullptr || candidates->size() >= last - first) {
+        for (size_t position = first; position < last; position++) {
+            if (matches(entries[position], filter)) {
+                selected.push_back(position);
+            }
+        }
+    } else {
+        auto begin = lower_bound(candidates->begin(), candidates->end(), first);
+        auto end = lower_bound(begin, candidates->end(), last);
+        for (auto it = begin; it != end; it++) {
+            if (matches(entries[*it], filter)) {
+                selected.push_back(*it);
+            }
+        }
+    }
+    return selected;
+}
+
+/**
+ * @brief Gets the statistics of the entries, kept up to date as they are logged.
+ *
+ * @return The statistics.
+ */
+const ChangeLogStats& ChangeLog::getStats() const {
+    return stats;
+}
+
+/**
+ * @brief Gets the name of a request type.
+ *
+ * @param type The request type.
+ * @return The name of the request type.
+ */
+string describeRequestType(RequestType type) {
+    switch (type) {
+        case RequestType::ChangeClass:
+            return "Change Class";
+        case RequestType::ChangeUc:
+            return "Change UC";
+        case RequestType::LeaveUcAndClass:
+            return "Leave UC and Class";
+        case RequestType::JoinUcAndClass:
+            return "Join UC and Class";
+        case RequestType::SwapClass:
+            return "Swap Class with other student";
+    }
+    return "-";
+}
+
+/**
+ * @brief Returns a human readable description of a change log reason.
+ *
+ * @param reason The reason to describe.
+ * @return The description of the reason, "-" for None.
+ */
+string describeReason(LogReason reason) {
+    switch (reason) {
+        case LogReason::None:
+            return "-";
+        case LogReason::AlreadyEnrolled:
+            return "Student already in the requested class or UC";
+        case LogReason::NotEnrolled:
+            return "Student not enrolled in the UC and class";
+        case LogReason::CapacityExceeded:
+            return "Class capacity exceeded";
+        case LogReason::BalanceDisturbed:
+            return "Balance between classes disturbed";
+        case LogReason::ScheduleConflict:
+            return "Conflict in new schedule";
+        case LogReason::MaxUcsExceeded:
+            return "Maximum number of UCs will exceed (max 7 UCs)";
+        case LogReason::NoVacancy:
+            return "No class with vacancy in the new UC or UC doesn't exist";
+        case LogReason::AcceptedInCycle:
+            return "Accepted in a cycle of class changes";
+        case LogReason::ReversedByAdministrator:
+            return "REQUEST RESULT REVERSED BY ADMINISTRATOR";
+        case LogReason::RestoredByAdministrator:
+            return "REQUEST RESULT RESTORED BY ADMINISTRATOR";
+    }
+    return "-";
+}
+
+/**
+ * @brief Formats the notes of a change log entry, from its reason and the ids it holds.
+ *
+ * @param entry The entry.
+ * @param context The data context the names of the students are read from.
+ * @return The notes of the entry.
+ */
+string describeNotes(const ChangeLogEntry& entry, DataContext& context) {
+    string reason = entry.reason == LogReason::AcceptedInCycle
+                    ? "Accepted in a cycle of " + to_string(entry.cycleLength) + " class changes"
+                    : describeReason(entry.reason);
+    if (entry.otherStudentCode == 0) {
+        return reason;
+    }
+    const Student* other = context.findStudent(entry.otherStudentCode);
+    string notes = "Swap with student \"" + (other != nullptr ? other->StudentName : string("-")) + "\" ("
+                   + to_string(entry.otherStudentCode) + ").";
+    return entry.reason == LogReason::None ? notes : notes + " " + reason;
+}
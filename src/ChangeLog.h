@@ -0,0 +1,172 @@
+/**
+ * @file ChangeLog.h
+ * @brief Header file for the ChangeLog class.
+ */
+
+#ifndef PROJETO_AED_CHANGELOG_H
+#define PROJETO_AED_CHANGELOG_H
+
+#include "ChangeLogStats.h"
+#include <array>
+#include <optional>
+
+/**
+ * @enum LogState
+ * @brief The states of the change log entries a filter keeps.
+ */
+enum class LogState {
+    Any,      ///< Every entry.
+    Accepted, ///< The accepted entries.
+    Denied    ///< The denied entries, including the reversed ones.
+};
+
+/**
+ * @struct ChangeLogFilter
+ * @brief The conditions a change log entry must meet to be selected, an empty field matches every entry.
+ */
+struct ChangeLogFilter {
+    LogState state = LogState::Any;    ///< The state of the entries.
+    optional<RequestType> requestType; ///< The type of the request.
+    int studentCode = 0;               ///< The code of the student, 0 for any.
+    UcId uc = InvalidId;               ///< The current or new UC, InvalidId for any.
+    int64_t from = INT64_MIN;          ///< The first timestamp, inclusive, in nanoseconds since the epoch.
+    int64_t until = INT64_MAX;         ///< The end of the time range, exclusive, in nanoseconds since the epoch.
+};
+
+/**
+ * @class ChangeLog
+ * @brief The change log entries, in logging order, indexed by state, request type, student, UC and change.
+ *
+ * The entries are fixed-size records, only formatted when they are displayed. Each index keeps the
+ * positions of its entries in increasing order, so a filter is answered by going through the shortest
+ * index that applies to it and checking the other conditions on those entries only.
+ * The entries are logged in the order of their timestamps, so a time range is a range of positions found
+ * by binary search; if the clock ever went back, the time range is checked entry by entry instead.
+ */
+class ChangeLog {
+private:
+    vector<ChangeLogEntry> entries;                       ///< The entries, in logging order.
+    vector<size_t> acceptedPositions;                     ///< The positions of the accepted entries.
+    vector<size_t> deniedPositions;                       ///< The positions of the denied entries.
+    array<vector<size_t>, RequestTypeCount> byType;       ///< The positions of the entries of each request type.
+    unordered_map<int, vector<size_t>> byStudent;         ///< The positions of the entries of each student.
+    vector<vector<size_t>> byUc;                          ///< The positions of the entries of each current or new UC, by UC id.
+    vector<pair<size_t, size_t>> byChange;                ///< The change id and the position of each entry with a change, by change id.
+    bool chronological;                                   ///< True if the timestamps of the entries never go back.
+    ChangeLogStats stats;                                 ///< The statistics of the entries, updated as they are logged.
+
+    /**
+     * @brief Add an entry to the index of a UC.
+     * @param uc The id of the UC.
+     * @param position The position of the entry.
+     */
+    void indexUc(UcId uc, size_t position);
+
+    /**
+     * @brief Add the last entry to the indexes.
+     */
+    void indexLast();
+
+    /**
+     * @brief Check if an entry meets the conditions of a filter.
+     * @param entry The entry.
+     * @param filter The filter.
+     * @return True if the entry meets every condition, otherwise false.
+     */
+    static bool matches(const ChangeLogEntry& entry, const ChangeLogFilter& filter);
+
+public:
+    /**
+     * @brief Constructor for the ChangeLog class, the log is empty.
+     */
+    ChangeLog();
+
+    /**
+     * @brief Replace the log with the entries recovered from a previous run.
+     * @param recovered The entries, in logging order.
+     */
+    void restore(vector<ChangeLogEntry> recovered);
+
+    /**
+     * @brief Add an entry at the end of the log.
+     * @param entry The entry, its change id must be NoChange or greater than the change ids in the log.
+     */
+    void append(const ChangeLogEntry& entry);
+
+    /**
+     * @brief Get the number of entries.
+     * @return The number of entries.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Check if the log has no entries.
+     * @return True if the log is empty, otherwise false.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Get an entry.
+     * @param position The position of the entry, less than the size.
+     * @return The entry.
+     */
+    const ChangeLogEntry& operator[](size_t position) const;
+
+    /**
+     * @brief Get the last entry, the log must not be empty.
+     * @return The last entry.
+     */
+    const ChangeLogEntry& back() const;
+
+    /**
+     * @brief Find the entries of some changes of the undo history.
+     * @param changeIds The ids of the changes.
+     * @return The positions of their entries, in increasing order.
+     */
+    vector<size_t> positionsOfChanges(const vector<size_t>& changeIds) const;
+
+    /**
+     * @brief Set the state and the reason of some entries, keeping the state indexes up to date.
+     * @param positions The positions of the entries, in increasing order.
+     * @param accepted The new state of the entries.
+     * @param reason The new reason of the entries.
+     */
+    void mark(const vector<size_t>& positions, bool accepted, LogReason reason);
+
+    /**
+     * @brief Select the entries that meet the conditions of a filter.
+     * @param filter The filter.
+     * @return The positions of the selected entries, in increasing order.
+     */
+    vector<size_t> select(const ChangeLogFilter& filter) const;
+
+    /**
+     * @brief Get the statistics of the entries, kept up to date as they are logged.
+     * @return The statistics.
+     */
+    const ChangeLogStats& getStats() const;
+};
+
+/**
+ * @brief Get the name of a request type.
+ * @param type The request type.
+ * @return The name of the request type.
+ */
+string describeRequestType(RequestType type);
+
+/**
+ * @brief Get a human readable description of a change log reason.
+ * @param reason The reason.
+ * @return The description of the reason, "-" for None.
+ */
+string describeReason(LogReason reason);
+
+/**
+ * @brief Format the notes of a change log entry: its reason, and the other student of a swap or the length of a cycle.
+ * @param entry The entry.
+ * @param context The data context the names of the students are read from.
+ * @return The notes of the entry.
+ */
+string describeNotes(const ChangeLogEntry& entry, DataContext& context);
+
+#endif //PROJETO_AED_CHANGELOG_H
@@ -0,0 +1,423 @@
+/**
+ * @file ChangeLogExporter.cpp
+ * @brief Implementation of the ChangeLogExporter class.
+ */
+
+#include "ChangeLogExporter.h"
+#include "ChangeLog.h"
+#include "JournalFile.h"
+#include <iostream>
+#include <charconv>
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/**
+ * @brief The header row of a CSV file.
+ */
+static const string CsvHeader = "Entry,Time,RequestType,StudentCode,CurrentUc,CurrentClass,NewUc,NewClass,State,Reason,OtherStudentCode,CycleLength\n";
+
+/**
+ * @brief Appends a number to a buffer, without going through a temporary string.
+ *
+ * @param out The buffer.
+ * @param value The number.
+ */
+static void appendNumber(string& out, int64_t value) {
+    char digits[24];
+    out.append(digits, (size_t) (to_chars(digits, digits + sizeof(digits), value).ptr - digits));
+}
+
+/**
+ * @brief Appends a field to a CSV row, quoted if it has a comma, a quote or a line break.
+ *
+ * @param out The buffer.
+ * @param field The field.
+ */
+static void appendCsvField(string& out, const string& field) {
+    if (field.find_first_of(",\"\n") == string::npos) {
+        out += field;
+        return;
+    }
+    out += '"';
+    for (char c : field) {
+        if (c == '"') {
+            out += '"';
+        }
+        out += c;
+    }
+    out += '"';
+}
+
+/**
+ * @brief Appends a JSON string, escaping its quotes, backslashes and control characters.
+ *
+ * @param out The buffer.
+ * @param text The text of the string.
+ */
+static void appendJsonString(string& out, const string& text) {
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if ((unsigned char) c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned) c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+/**
+ * @brief Gets the name of an export format.
+ *
+ * @param format The format.
+ * @return "CSV" or "JSONL".
+ */
+string describeFormat(ExportFormat format) {
+    return format == ExportFormat::Csv ? "CSV" : "JSONL";
+}
+
+/**
+ * @brief Constructor for the ChangeLogExporter class, opens the current file and starts the writer.
+ *
+ * @param catalog The catalog the UC and class codes are read from.
+ * @param options The configuration of the stream.
+ */
+ChangeLogExporter::ChangeLogExporter(shared_ptr<const Catalog> catalog, ExportOptions options)
+    : options(std::move(options)), catalog(std::move(catalog)), queue(this->options.queueCapacity), policy(this->options.policy),
+      exported(0), dropped(0), rotations(0), failed(false), fd(-1), fileBytes(0), buffered(0), cachedSecond(INT64_MIN), sleeping(false), stopping(false) {
+    path = this->options.basePath + (this->options.format == ExportFormat::Csv ? ".csv" : ".jsonl");
+    openFile();
+    writer = thread(&ChangeLogExporter::writeLoop, this);
+}
+
+/**
+ * @brief Destructor for the ChangeLogExporter class, the queued entries are written before the file is closed.
+ */
+ChangeLogExporter::~ChangeLogExporter() {
+    stopping.store(true);
+    {
+        lock_guard<mutex> guard(lock);
+        wakeUp.notify_one();
+    }
+    writer.join();
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+/**
+ * @brief Wakes the writer if it is waiting for entries.
+ *
+ * The fence orders the push before the check of the writer, which orders its sleep before its check of
+ * the queue, so one of them sees the other; the notification is sent under the lock, so it can't fall
+ * between the check of the writer and its wait.
+ */
+void ChangeLogExporter::wake() {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (sleeping.load(memory_order_relaxed)) {
+        lock_guard<mutex> guard(lock);
+        wakeUp.notify_one();
+    }
+}
+
+/**
+ * @brief Queues an entry for the writer, applying the backpressure policy if the queue is full.
+ *
+ * @param position The position of the entry in the change logs.
+ * @param entry The entry.
+ * @return True if the entry was queued, false if it was dropped.
+ *
+ * @complexity O(1), or the time the writer takes to make room if the queue is full and the policy is Block.
+ */
+bool ChangeLogExporter::push(size_t position, const ChangeLogEntry& entry) {
+    Record record;
+    record.position = position;
+    record.entry = entry;
+    if (!queue.tryPush(record)) {
+        if (policy.load(memory_order_relaxed) == BackpressurePolicy::Drop) {
+            dropped.fetch_add(1, memory_order_relaxed);
+            return false;
+        }
+        do {
+            wake();
+            this_thread::yield();
+        } while (!queue.tryPush(record));
+    }
+    wake();
+    return true;
+}
+
+/**
+ * @brief Opens the current file for appending, a new or empty CSV file starts with the header row.
+ */
+void ChangeLogExporter::openFile() {
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    struct stat status = {};
+    if (fd < 0 || ::fstat(fd, &status) != 0) {
+        if (!failed.exchange(true)) {
+            cerr << "ERROR: Could not open " << path << ", the change logs won't be exported." << endl;
+        }
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        return;
+    }
+    fileBytes = (size_t) status.st_size;
+    if (fileBytes == 0 && options.format == ExportFormat::Csv) {
+        buffer += CsvHeader;
+        fileBytes += CsvHeader.size();
+    }
+}
+
+/**
+ * @brief Writes the buffer to the current file and empties it, the entries of a failed write are lost.
+ */
+void ChangeLogExporter::flush() {
+    if (buffer.empty()) {
+        return;
+    }
+    if (fd >= 0 && writeAll(fd, buffer)) {
+        exported.fetch_add(buffered, memory_order_relaxed);
+    } else if (!failed.exchange(true)) {
+        cerr << "ERROR: Could not write to " << path << ", the change logs won't be exported." << endl;
+    }
+    buffer.clear();
+    buffered = 0;
+}
+
+/**
+ * @brief Closes the current file, shifts the rotated files one number up and starts a new file.
+ *
+ * The file number n becomes n + 1, the one of the maximum number is replaced by the one before it,
+ * and the current file becomes number 1.
+ */
+void ChangeLogExporter::rotate() {
+    flush();
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    string extension = path.substr(options.basePath.size());
+    auto rotatedPath = [this, &extension](size_t number) {
+        return number == 0 ? path : options.basePath + "." + to_string(number) + extension;
+    };
+    if (options.maxRotatedFiles == 0) {
+        ::unlink(path.c_str());
+    }
+    for (size_t number = options.maxRotatedFiles; number > 0; number--) {
+        ::rename(rotatedPath(number - 1).c_str(), rotatedPath(number).c_str());
+    }
+    rotations.fetch_add(1, memory_order_relaxed);
+    openFile();
+}
+
+/**
+ * @brief Formats a timestamp at the end of the buffer, as formatTimestamp does.
+ *
+ * Converting a time to the local time zone costs more than the rest of a row, and the entries of a
+ * burst share their second, so only the milliseconds are formatted again within the same second.
+ *
+ * @param timestamp The timestamp, in nanoseconds since the epoch.
+ */
+void ChangeLogExporter::formatTime(int64_t timestamp) {
+    int64_t second = timestamp / 1000000000 - (timestamp % 1000000000 < 0 ? 1 : 0);
+    if (second != cachedSecond) {
+        cachedSecond = second;
+        cachedTime = formatTimestamp(second * 1000000000);
+    }
+    int millis = (int) ((timestamp - second * 1000000000) / 1000000);
+    buffer.append(cachedTime, 0, cachedTime.size() - 3);
+    buffer += (char) ('0' + millis / 100);
+    buffer += (char) ('0' + millis / 10 % 10);
+    buffer += (char) ('0' + millis % 10);
+}
+
+/**
+ * @brief Formats an entry as a row of the file, at the end of the buffer.
+ *
+ * A CSV row has the columns of the header; a JSONL line has the same fields, with null for the UCs and
+ * classes an entry doesn't have.
+ *
+ * @param record The entry and its number.
+ *
+ * @complexity O(1)
+ */
+void ChangeLogExporter::format(const Record& record) {
+    const ChangeLogEntry& entry = record.entry;
+    const string& currentUc = catalog->getUcCode(entry.currentUc);
+    const string& currentClass = catalog->getClassCode(entry.currentClass);
+    const string& newUc = catalog->getUcCode(entry.newUc);
+    const string& newClass = catalog->getClassCode(entry.newClass);
+
+    if (options.format == ExportFormat::Csv) {
+        appendNumber(buffer, (int64_t) record.position + 1);
+        buffer += ',';
+        formatTime(entry.timestamp);
+        buffer += ',';
+        buffer += describeRequestType(entry.requestType);
+        buffer += ',';
+        appendNumber(buffer, entry.studentCode);
+        for (const string* field : {&currentUc, &currentClass, &newUc, &newClass}) {
+            buffer += ',';
+            appendCsvField(buffer, *field);
+        }
+        buffer += entry.accepted ? ",Accepted," : ",Denied,";
+        if (entry.reason != LogReason::None) {
+            appendCsvField(buffer, describeReason(entry.reason));
+        }
+        buffer += ',';
+        if (entry.otherStudentCode != 0) {
+            appendNumber(buffer, entry.otherStudentCode);
+        }
+        buffer += ',';
+        if (entry.cycleLength != 0) {
+            appendNumber(buffer, entry.cycleLength);
+        }
+        buffer += '\n';
+    } else {
+        auto optionalString = [this](const char* name, const string& text) {
+            buffer += name;
+            if (text.empty()) {
+                buffer += "null";
+            } else {
+                appendJsonString(buffer, text);
+            }
+        };
+        buffer += "{\"entry\":";
+        appendNumber(buffer, (int64_t) record.position + 1);
+        buffer += ",\"time\":\"";
+        formatTime(entry.timestamp);
+        buffer += '"';
+        buffer += ",\"requestType\":";
+        appendJsonString(buffer, describeRequestType(entry.requestType));
+        buffer += ",\"studentCode\":";
+        appendNumber(buffer, entry.studentCode);
+        optionalString(",\"currentUc\":", currentUc);
+        optionalString(",\"currentClass\":", currentClass);
+        optionalString(",\"newUc\":", newUc);
+        optionalString(",\"newClass\":", newClass);
+        buffer += entry.accepted ? ",\"accepted\":true" : ",\"accepted\":false";
+        optionalString(",\"reason\":", entry.reason == LogReason::None ? string() : describeReason(entry.reason));
+        buffer += ",\"otherStudentCode\":";
+        if (entry.otherStudentCode != 0) {
+            appendNumber(buffer, entry.otherStudentCode);
+        } else {
+            buffer += "null";
+        }
+        buffer += ",\"cycleLength\":";
+        if (entry.cycleLength != 0) {
+            appendNumber(buffer, entry.cycleLength);
+        } else {
+            buffer += "null";
+        }
+        buffer += "}\n";
+    }
+    buffered++;
+}
+
+/**
+ * @brief Takes and writes the entries of the queue until the stream is closed.
+ *
+ * The entries are formatted as they are taken; the buffer is written when it reaches FlushBytes and
+ * whenever the queue is empty, so a burst of entries costs a few writes and a single entry is written
+ * as soon as it arrives. The file is rotated after the entry that makes it reach its maximum size.
+ * The wait has a timeout, as a safety net for a missed wake up.
+ */
+void ChangeLogExporter::writeLoop() {
+    Record record;
+    while (true) {
+        while (queue.tryPop(record)) {
+            size_t before = buffer.size();
+            format(record);
+            fileBytes += buffer.size() - before;
+            if (fileBytes >= options.maxFileBytes) {
+                rotate();
+            } else if (buffer.size() >= FlushBytes) {
+                flush();
+            }
+        }
+        flush();
+
+        unique_lock<mutex> guard(lock);
+        sleeping.store(true, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        wakeUp.wait_for(guard, chrono::milliseconds(100), [this]() { return stopping.load() || !queue.empty(); });
+        sleeping.store(false, memory_order_relaxed);
+        if (stopping.load() && queue.empty()) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Sets what to do when the queue is full, from the next entry pushed.
+ *
+ * @param newPolicy The backpressure policy.
+ */
+void ChangeLogExporter::setPolicy(BackpressurePolicy newPolicy) {
+    policy.store(newPolicy);
+}
+
+/**
+ * @brief Gets the configuration of the stream, with its current policy.
+ *
+ * @return The configuration.
+ */
+ExportOptions ChangeLogExporter::getOptions() const {
+    ExportOptions current = options;
+    current.policy = policy.load();
+    return current;
+}
+
+/**
+ * @brief Gets the path of the current file.
+ *
+ * @return The path.
+ */
+const string& ChangeLogExporter::getPath() const {
+    return path;
+}
+
+/**
+ * @brief Gets the number of entries written to the files.
+ *
+ * @return The number of entries exported.
+ */
+uint64_t ChangeLogExporter::getExported() const {
+    return exported.load();
+}
+
+/**
+ * @brief Gets the number of entries dropped because the queue was full.
+ *
+ * @return The number of entries dropped.
+ */
+uint64_t ChangeLogExporter::getDropped() const {
+    return dropped.load();
+}
+
+/**
+ * @brief Gets the number of files rotated.
+ *
+ * @return The number of rotations.
+ */
+uint64_t ChangeLogExporter::getRotations() const {
+    return rotations.load();
+}
+
+/**
+ * @brief Checks if a file couldn't be opened or written.
+ *
+ * @return True after a failure, otherwise false.
+ */
+bool ChangeLogExporter::hasFailed() const {
+    return failed.load();
+}
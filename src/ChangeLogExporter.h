@@ -0,0 +1,208 @@
+/**
+ * @file ChangeLogExporter.h
+ * @brief Header file for the ChangeLogExporter class.
+ */
+
+#ifndef PROJETO_AED_CHANGELOGEXPORTER_H
+#define PROJETO_AED_CHANGELOGEXPORTER_H
+
+#include "ReadData.h"
+#include "Catalog.h"
+#include "BoundedQueue.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @enum ExportFormat
+ * @brief The formats the change log entries are exported in.
+ */
+enum class ExportFormat {
+    Csv,  ///< A CSV file with a header row, one entry per row.
+    Jsonl ///< A JSON object per line.
+};
+
+/**
+ * @enum BackpressurePolicy
+ * @brief What to do with an entry exported while the queue of the writer is full.
+ */
+enum class BackpressurePolicy {
+    Block, ///< Wait until the writer makes room, no entry is lost.
+    Drop   ///< Drop the entry and count it, the caller never waits.
+};
+
+/**
+ * @struct ExportOptions
+ * @brief The configuration of a change log export stream.
+ */
+struct ExportOptions {
+    string basePath = "data/changelog";                    ///< The path of the files, without the extension of the format.
+    ExportFormat format = ExportFormat::Csv;               ///< The format of the files.
+    BackpressurePolicy policy = BackpressurePolicy::Block; ///< What to do when the queue is full.
+    size_t queueCapacity = 4096;                           ///< The number of entries the queue holds.
+    size_t maxFileBytes = 8 * 1024 * 1024;                 ///< The size a file is rotated at.
+    size_t maxRotatedFiles = 5;                            ///< The number of rotated files kept, the oldest is deleted.
+};
+
+/**
+ * @class ChangeLogExporter
+ * @brief Streams the change log entries to rotating CSV or JSONL files, from a background thread.
+ *
+ * The entries are pushed to a bounded lock-free queue, so logging an entry costs a copy into the
+ * queue and never waits for the disk. The writer thread formats the entries it takes into a buffer and
+ * writes the buffer as a batch once it is large enough or the queue is empty. When the current file
+ * reaches its maximum size it is renamed to ".1", the older files shift one number up and a new file is
+ * started. An entry is exported again when the administrator reverses or restores it; its number, the
+ * position in the change logs, tells which row it updates.
+ *
+ * The rows only hold codes, read from the catalog, which never changes, so the writer doesn't read the
+ * roster the requests are changing. The files are an export, they are not synced to the disk.
+ */
+class ChangeLogExporter {
+private:
+    /**
+     * @struct Record
+     * @brief An entry waiting in the queue, with its number.
+     */
+    struct Record {
+        size_t position = 0;  ///< The position of the entry in the change logs.
+        ChangeLogEntry entry; ///< The entry.
+    };
+
+    static const size_t FlushBytes = 64 * 1024;  ///< The size the buffer is written at, before the queue is empty.
+
+    ExportOptions options;              ///< The configuration of the stream.
+    string path;                        ///< The path of the current file.
+    shared_ptr<const Catalog> catalog;  ///< The catalog the UC and class codes are read from.
+    BoundedQueue<Record> queue;         ///< The entries waiting for the writer.
+    atomic<BackpressurePolicy> policy;  ///< What to do when the queue is full, may change while running.
+    atomic<uint64_t> exported;          ///< The number of entries written.
+    atomic<uint64_t> dropped;           ///< The number of entries dropped because the queue was full.
+    atomic<uint64_t> rotations;         ///< The number of files rotated.
+    atomic<bool> failed;                ///< True after a file couldn't be opened or written.
+
+    int fd;                             ///< The descriptor of the current file, -1 if it couldn't be opened.
+    size_t fileBytes;                   ///< The size of the current file, including the buffer.
+    string buffer;                      ///< The formatted entries not yet written.
+    uint64_t buffered;                  ///< The number of entries in the buffer.
+    int64_t cachedSecond;               ///< The second of the last timestamp formatted.
+    string cachedTime;                  ///< The last timestamp formatted, to reuse its date and time of the day.
+
+    mutex lock;                         ///< Protects the sleep of the writer.
+    condition_variable wakeUp;          ///< Signals the writer that there are entries or that the stream is closing.
+    atomic<bool> sleeping;              ///< True while the writer waits for entries.
+    atomic<bool> stopping;              ///< True when the stream is being closed.
+    thread writer;                      ///< Formats and writes the entries.
+
+    /**
+     * @brief Wake the writer if it is waiting for entries.
+     */
+    void wake();
+
+    /**
+     * @brief Open the current file for appending, writing the header of a new CSV file.
+     */
+    void openFile();
+
+    /**
+     * @brief Write the buffer to the current file and empty it.
+     */
+    void flush();
+
+    /**
+     * @brief Close the current file, shift the rotated files one number up and start a new file.
+     */
+    void rotate();
+
+    /**
+     * @brief Format a timestamp at the end of the buffer, reusing the date and time of the previous one in the same second.
+     * @param timestamp The timestamp, in nanoseconds since the epoch.
+     */
+    void formatTime(int64_t timestamp);
+
+    /**
+     * @brief Format an entry as a row of the file, at the end of the buffer.
+     * @param record The entry and its number.
+     */
+    void format(const Record& record);
+
+    /**
+     * @brief Take and write the entries of the queue until the stream is closed.
+     */
+    void writeLoop();
+
+public:
+    /**
+     * @brief Constructor for the ChangeLogExporter class, opens the current file and starts the writer.
+     * @param catalog The catalog the UC and class codes are read from.
+     * @param options The configuration of the stream.
+     */
+    ChangeLogExporter(shared_ptr<const Catalog> catalog, ExportOptions options);
+
+    /**
+     * @brief Destructor for the ChangeLogExporter class, writes the queued entries and closes the file.
+     */
+    ~ChangeLogExporter();
+
+    ChangeLogExporter(const ChangeLogExporter&) = delete;
+    ChangeLogExporter& operator=(const ChangeLogExporter&) = delete;
+
+    /**
+     * @brief Queue an entry for the writer, applying the backpressure policy if the queue is full.
+     * @param position The position of the entry in the change logs.
+     * @param entry The entry.
+     * @return True if the entry was queued, false if it was dropped.
+     */
+    bool push(size_t position, const ChangeLogEntry& entry);
+
+    /**
+     * @brief Set what to do when the queue is full.
+     * @param newPolicy The backpressure policy.
+     */
+    void setPolicy(BackpressurePolicy newPolicy);
+
+    /**
+     * @brief Get the configuration of the stream, with its current policy.
+     * @return The configuration.
+     */
+    ExportOptions getOptions() const;
+
+    /**
+     * @brief Get the path of the current file.
+     * @return The path.
+     */
+    const string& getPath() const;
+
+    /**
+     * @brief Get the number of entries written to the files.
+     * @return The number of entries exported.
+     */
+    uint64_t getExported() const;
+
+    /**
+     * @brief Get the number of entries dropped because the queue was full.
+     * @return The number of entries dropped.
+     */
+    uint64_t getDropped() const;
+
+    /**
+     * @brief Get the number of files rotated.
+     * @return The number of rotations.
+     */
+    uint64_t getRotations() const;
+
+    /**
+     * @brief Check if a file couldn't be opened or written.
+     * @return True after a failure, otherwise false.
+     */
+    bool hasFailed() const;
+};
+
+/**
+ * @brief Get the name of an export format.
+ * @param format The format.
+ * @return "CSV" or "JSONL".
+ */
+string describeFormat(ExportFormat format);
+
+#endif //PROJETO_AED_CHANGELOGEXPORTER_H
@@ -0,0 +1,279 @@
+/**
+ * @file ChangeLogStats.cpp
+ * @brief Implementation of the ChangeLogStats class.
+ */
+
+#include "ChangeLogStats.h"
+#include "ChangeLog.h"
+#include "DataContext.h"
+#include "JournalFile.h"
+
+/**
+ * @brief Constructor for the TimeBuckets class, every bucket is empty.
+ *
+ * @param width The width of a bucket, in nanoseconds.
+ * @param buckets The number of buckets of the window.
+ */
+TimeBuckets::TimeBuckets(int64_t width, size_t buckets) : width(width), ring(buckets), newest(INT64_MIN / 2) {}
+
+/**
+ * @brief Counts a request in the bucket of its time.
+ *
+ * The buckets skipped since the newest one are emptied first, as they are reused from older times.
+ *
+ * @param timestamp The time of the request, in nanoseconds since the epoch.
+ * @param accepted True if the request was accepted.
+ *
+ * @complexity O(1) amortized, each bucket is emptied once per window.
+ */
+void TimeBuckets::add(int64_t timestamp, bool accepted) {
+    int64_t size = (int64_t) ring.size();
+    int64_t bucket = timestamp / width;
+    if (bucket > newest) {
+        for (int64_t skipped = max(newest + 1, bucket - size + 1); skipped <= bucket; skipped++) {
+            ring[(size_t) (skipped % size)] = RequestCounts();
+        }
+        newest = bucket;
+    }
+    if (bucket <= newest - size) {
+        return;
+    }
+    RequestCounts& counts = ring[(size_t) (bucket % size)];
+    (accepted ? counts.accepted : counts.denied)++;
+}
+
+/**
+ * @brief Gets the buckets of the window that ends at a given time.
+ *
+ * The buckets of the ring that are out of that window are read as empty, the ring is not changed.
+ *
+ * @param now The time the window ends at, in nanoseconds since the epoch.
+ * @return The start of each bucket, in nanoseconds since the epoch, and its requests, oldest first.
+ *
+ * @complexity O(b), where b is the number of buckets.
+ */
+vector<pair<int64_t, RequestCounts>> TimeBuckets::window(int64_t now) const {
+    int64_t size = (int64_t) ring.size();
+    int64_t last = now / width;
+    vector<pair<int64_t, RequestCounts>> buckets;
+    buckets.reserve(ring.size());
+    for (int64_t bucket = last - size + 1; bucket <= last; bucket++) {
+        bool inRing = bucket <= newest && bucket > newest - size;
+        buckets.emplace_back(bucket * width, inRing ? ring[(size_t) (bucket % size)] : RequestCounts());
+    }
+    return buckets;
+}
+
+/**
+ * @brief Constructor for the ChangeLogStats class, every counter is 0.
+ */
+ChangeLogStats::ChangeLogStats()
+    : byReason(), minutes(60LL * 1000000000, MinuteBuckets), hours(3600LL * 1000000000, HourBuckets), reversed(0), restored(0) {}
+
+/**
+ * @brief Packs a UC and a class as a single key.
+ *
+ * @param uc The id of the UC.
+ * @param classId The id of the class.
+ * @return The key of the UC and class.
+ */
+uint32_t ChangeLogStats::classKey(UcId uc, ClassId classId) {
+    return ((uint32_t) uc << 16) | classId;
+}
+
+/**
+ * @brief Counts a request of a class and updates the ranking of the busiest classes.
+ *
+ * A class only moves up the ranking, by one request at a time, so it is enough to move it past the
+ * classes it now has more requests than; a class out of the ranking takes the place of the last one
+ * once it has more requests.
+ *
+ * @param key The UC and class, packed by classKey.
+ *
+ * @complexity O(k), where k is the number of classes in the ranking.
+ */
+void ChangeLogStats::countClass(uint32_t key) {
+    uint64_t count = ++byClass[key];
+    size_t position = 0;
+    while (position < busiest.size() && busiest[position].first != key) {
+        position++;
+    }
+    if (position == busiest.size()) {
+        if (busiest.size() < TopClasses) {
+            busiest.emplace_back(key, count);
+        } else if (count > busiest.back().second) {
+            busiest.back() = {key, count};
+            position = busiest.size() - 1;
+        } else {
+            return;
+        }
+    }
+    busiest[position].second = count;
+    while (position > 0 && busiest[position - 1].second < count) {
+        swap(busiest[position - 1], busiest[position]);
+        position--;
+    }
+}
+
+/**
+ * @brief Counts a logged entry.
+ *
+ * The UC and class of a request are the requested ones, or the ones left by a request to leave; a
+ * denied request to join or change UC has no class.
+ *
+ * @param entry The entry.
+ *
+ * @complexity O(k), where k is the number of classes in the ranking of the busiest classes.
+ */
+void ChangeLogStats::add(const ChangeLogEntry& entry) {
+    (entry.accepted ? total.accepted : total.denied)++;
+    byReason[(size_t) entry.reason]++;
+
+    UcId uc = entry.newUc != InvalidId ? entry.newUc : entry.currentUc;
+    ClassId classId = entry.newUc != InvalidId ? entry.newClass : entry.currentClass;
+    if (uc != InvalidId) {
+        if (uc >= byUc.size()) {
+            byUc.resize((size_t) uc + 1);
+        }
+        (entry.accepted ? byUc[uc].accepted : byUc[uc].denied)++;
+        if (classId != InvalidId) {
+            countClass(classKey(uc, classId));
+        }
+    }
+
+    minutes.add(entry.timestamp, entry.accepted);
+    hours.add(entry.timestamp, entry.accepted);
+}
+
+/**
+ * @brief Counts an entry reversed or restored by the administrator.
+ *
+ * The other statistics keep the decision of the request, as it was logged.
+ *
+ * @param accepted True if the entry was restored, false if it was reversed.
+ */
+void ChangeLogStats::review(bool accepted) {
+    (accepted ? restored : reversed)++;
+}
+
+/**
+ * @brief Gets the requests of every entry.
+ *
+ * @return The total requests.
+ */
+const RequestCounts& ChangeLogStats::getTotal() const {
+    return total;
+}
+
+/**
+ * @brief Gets the requests of a UC.
+ *
+ * @param uc The id of the UC.
+ * @return The requests of the UC.
+ */
+RequestCounts ChangeLogStats::getUc(UcId uc) const {
+    return uc < byUc.size() ? byUc[uc] : RequestCounts();
+}
+
+/**
+ * @brief Gets the number of entries of a reason.
+ *
+ * @param reason The reason.
+ * @return The number of entries.
+ */
+uint64_t ChangeLogStats::getReason(LogReason reason) const {
+    return byReason[(size_t) reason];
+}
+
+/**
+ * @brief Gets the busiest classes.
+ *
+ * @return The UC and class of each, packed by classKey, and their number of requests, most requested first.
+ */
+const vector<pair<uint32_t, uint64_t>>& ChangeLogStats::getBusiestClasses() const {
+    return busiest;
+}
+
+/**
+ * @brief Gets the requests of each of the last minutes.
+ *
+ * @param now The current time, in nanoseconds since the epoch.
+ * @return The start of each minute and its requests, oldest first.
+ */
+vector<pair<int64_t, RequestCounts>> ChangeLogStats::getMinutes(int64_t now) const {
+    return minutes.window(now);
+}
+
+/**
+ * @brief Gets the requests of each of the last hours.
+ *
+ * @param now The current time, in nanoseconds since the epoch.
+ * @return The start of each hour and its requests, oldest first.
+ */
+vector<pair<int64_t, RequestCounts>> ChangeLogStats::getHours(int64_t now) const {
+    return hours.window(now);
+}
+
+/**
+ * @brief Gets the number of entries reversed by the administrator.
+ *
+ * @return The number of reversed entries.
+ */
+uint64_t ChangeLogStats::getReversed() const {
+    return reversed;
+}
+
+/**
+ * @brief Gets the number of entries restored by the administrator.
+ *
+ * @return The number of restored entries.
+ */
+uint64_t ChangeLogStats::getRestored() const {
+    return restored;
+}
+
+/**
+ * @brief Writes the statistics to a CSV file, through a temporary file that replaces it.
+ *
+ * Each row is a statistic: its section (total, uc, reason, class, minute, hour or review), its key,
+ * and its requests, accepted, denied and acceptance rate where they apply.
+ *
+ * @param path The path of the file.
+ * @param context The data context the UC and class codes are read from.
+ * @param now The current time, in nanoseconds since the epoch.
+ * @return True if the file was written, otherwise false.
+ *
+ * @complexity O(u + r + k + b), where u is the number of UCs, r of reasons, k of busiest classes and b of buckets.
+ */
+bool ChangeLogStats::exportCsv(const string& path, const DataContext& context, int64_t now) const {
+    string out = "Section,Key,Requests,Accepted,Denied,AcceptanceRate\n";
+    auto row = [&out](const string& section, const string& key, const RequestCounts& counts) {
+        char rate[16];
+        snprintf(rate, sizeof(rate), "%.4f", counts.acceptanceRate());
+        out += section + "," + key + "," + to_string(counts.requests()) + "," + to_string(counts.accepted) + ","
+               + to_string(counts.denied) + "," + rate + "\n";
+    };
+
+    row("total", "all", total);
+    for (UcId uc = 0; uc < byUc.size(); uc++) {
+        if (byUc[uc].requests() > 0) {
+            row("uc", context.getUcCode(uc), byUc[uc]);
+        }
+    }
+    for (size_t reason = 0; reason < LogReasonCount; reason++) {
+        out += "reason," + (reason == (size_t) LogReason::None ? string("None") : describeReason((LogReason) reason)) + "," + to_string(byReason[reason]) + ",,,\n";
+    }
+    for (const auto& busy : busiest) {
+        out += "class," + context.getUcCode((UcId) (busy.first >> 16)) + " " + context.getClassCode((ClassId) (busy.first & 0xFFFF))
+               + "," + to_string(busy.second) + ",,,\n";
+    }
+    for (const auto& bucket : minutes.window(now)) {
+        row("minute", formatTimestamp(bucket.first).substr(0, 16), bucket.second);
+    }
+    for (const auto& bucket : hours.window(now)) {
+        row("hour", formatTimestamp(bucket.first).substr(0, 13), bucket.second);
+    }
+    out += "review,reversed," + to_string(reversed) + ",,,\n";
+    out += "review,restored," + to_string(restored) + ",,,\n";
+    return replaceFile(path, out);
+}
@@ -0,0 +1,189 @@
+/**
+ * @file ChangeLogStats.h
+ * @brief Header file for the ChangeLogStats class.
+ */
+
+#ifndef PROJETO_AED_CHANGELOGSTATS_H
+#define PROJETO_AED_CHANGELOGSTATS_H
+
+#include "ReadData.h"
+#include <array>
+
+/**
+ * @struct RequestCounts
+ * @brief The number of accepted and denied requests of a group.
+ */
+struct RequestCounts {
+    uint64_t accepted = 0; ///< The number of accepted requests.
+    uint64_t denied = 0;   ///< The number of denied requests.
+
+    /**
+     * @brief Get the number of requests.
+     * @return The number of accepted and denied requests.
+     */
+    uint64_t requests() const { return accepted + denied; }
+
+    /**
+     * @brief Get the share of accepted requests.
+     * @return The acceptance rate, from 0 to 1, or 0 without requests.
+     */
+    double acceptanceRate() const { return requests() == 0 ? 0.0 : (double) accepted / (double) requests(); }
+};
+
+/**
+ * @class TimeBuckets
+ * @brief The requests of the last buckets of a fixed width, in a ring.
+ *
+ * A bucket is reused when the time moves past the window, so the ring has a fixed size whatever the
+ * number of requests. A request older than the window is not counted.
+ */
+class TimeBuckets {
+private:
+    int64_t width;                ///< The width of a bucket, in nanoseconds.
+    vector<RequestCounts> ring;   ///< The buckets, bucket number b is at b modulo the size.
+    int64_t newest;               ///< The number of the newest bucket in the ring.
+
+public:
+    /**
+     * @brief Constructor for the TimeBuckets class, every bucket is empty.
+     * @param width The width of a bucket, in nanoseconds.
+     * @param buckets The number of buckets of the window.
+     */
+    TimeBuckets(int64_t width, size_t buckets);
+
+    /**
+     * @brief Count a request in the bucket of its time.
+     * @param timestamp The time of the request, in nanoseconds since the epoch.
+     * @param accepted True if the request was accepted.
+     */
+    void add(int64_t timestamp, bool accepted);
+
+    /**
+     * @brief Get the buckets of the window that ends at a given time.
+     * @param now The time the window ends at, in nanoseconds since the epoch.
+     * @return The start of each bucket, in nanoseconds since the epoch, and its requests, oldest first.
+     */
+    vector<pair<int64_t, RequestCounts>> window(int64_t now) const;
+};
+
+/**
+ * @class ChangeLogStats
+ * @brief Statistics of the change logs, updated as each entry is logged.
+ *
+ * Every entry updates a few counters: the totals, the requests of its UC, the entries of its reason,
+ * the requests of its class and the buckets of its minute and of its hour. The busiest classes are kept
+ * as a short ranking, updated on each request, as the counts only grow. So every statistic is read in
+ * a time that depends on the number of UCs, reasons or buckets, never on the length of the log.
+ */
+class ChangeLogStats {
+public:
+    static const size_t TopClasses = 10;      ///< The number of classes in the ranking of the busiest classes.
+    static const size_t MinuteBuckets = 60;   ///< The number of minutes of the request rate by minute.
+    static const size_t HourBuckets = 48;     ///< The number of hours of the request rate by hour.
+
+private:
+    RequestCounts total;                               ///< The requests of every entry.
+    vector<RequestCounts> byUc;                        ///< The requests of each UC, by UC id.
+    array<uint64_t, LogReasonCount> byReason;          ///< The number of entries of each reason.
+    unordered_map<uint32_t, uint64_t> byClass;         ///< The number of requests of each UC and class, packed by classKey.
+    vector<pair<uint32_t, uint64_t>> busiest;          ///< The busiest classes, packed by classKey, most requested first.
+    TimeBuckets minutes;                               ///< The requests of the last minutes.
+    TimeBuckets hours;                                 ///< The requests of the last hours.
+    uint64_t reversed;                                 ///< The number of entries reversed by the administrator.
+    uint64_t restored;                                 ///< The number of entries restored by the administrator.
+
+    /**
+     * @brief Count a request of a class and update the ranking of the busiest classes.
+     * @param key The UC and class, packed by classKey.
+     */
+    void countClass(uint32_t key);
+
+public:
+    /**
+     * @brief Constructor for the ChangeLogStats class, every counter is 0.
+     */
+    ChangeLogStats();
+
+    /**
+     * @brief Pack a UC and a class as a single key.
+     * @param uc The id of the UC.
+     * @param classId The id of the class.
+     * @return The key of the UC and class.
+     */
+    static uint32_t classKey(UcId uc, ClassId classId);
+
+    /**
+     * @brief Count a logged entry.
+     * @param entry The entry.
+     */
+    void add(const ChangeLogEntry& entry);
+
+    /**
+     * @brief Count an entry reversed or restored by the administrator.
+     * @param accepted True if the entry was restored, false if it was reversed.
+     */
+    void review(bool accepted);
+
+    /**
+     * @brief Get the requests of every entry.
+     * @return The total requests.
+     */
+    const RequestCounts& getTotal() const;
+
+    /**
+     * @brief Get the requests of a UC, the one requested, or the one left by a request to leave.
+     * @param uc The id of the UC.
+     * @return The requests of the UC.
+     */
+    RequestCounts getUc(UcId uc) const;
+
+    /**
+     * @brief Get the number of entries of a reason.
+     * @param reason The reason.
+     * @return The number of entries.
+     */
+    uint64_t getReason(LogReason reason) const;
+
+    /**
+     * @brief Get the busiest classes, the ones with the most requests.
+     * @return The UC and class of each, packed by classKey, and their number of requests, most requested first.
+     */
+    const vector<pair<uint32_t, uint64_t>>& getBusiestClasses() const;
+
+    /**
+     * @brief Get the requests of each of the last minutes.
+     * @param now The current time, in nanoseconds since the epoch.
+     * @return The start of each minute and its requests, oldest first.
+     */
+    vector<pair<int64_t, RequestCounts>> getMinutes(int64_t now) const;
+
+    /**
+     * @brief Get the requests of each of the last hours.
+     * @param now The current time, in nanoseconds since the epoch.
+     * @return The start of each hour and its requests, oldest first.
+     */
+    vector<pair<int64_t, RequestCounts>> getHours(int64_t now) const;
+
+    /**
+     * @brief Get the number of entries reversed by the administrator.
+     * @return The number of reversed entries.
+     */
+    uint64_t getReversed() const;
+
+    /**
+     * @brief Get the number of entries restored by the administrator.
+     * @return The number of restored entries.
+     */
+    uint64_t getRestored() const;
+
+    /**
+     * @brief Write the statistics to a CSV file, atomically.
+     * @param path The path of the file.
+     * @param context The data context the UC and class codes are read from.
+     * @param now The current time, in nanoseconds since the epoch.
+     * @return True if the file was written, otherwise false.
+     */
+    bool exportCsv(const string& path, const DataContext& context, int64_t now) const;
+};
+
+#endif //PROJETO_AED_CHANGELOGSTATS_H
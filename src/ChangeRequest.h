@@ -0,0 +1,129 @@
+/**
+ * @file ChangeRequest.h
+ * @brief Defines the change requests that students submit and administrators process.
+ */
+
+#ifndef PROJETO_AED_CHANGEREQUEST_H
+#define PROJETO_AED_CHANGEREQUEST_H
+
+#include "DataContext.h"
+#include <variant>
+#include <type_traits>
+
+/**
+ * @struct ChangeClassRequest
+ * @brief A structure to represent a request to Change a Student's Class.
+ */
+struct ChangeClassRequest {
+    int studentCode;      ///< The code of the student for whom the change is requested.
+    UcId currentUc;       ///< The current UC (University Course) of the student.
+    ClassId currentClass; ///< The current class of the student.
+    ClassId newClass;     ///< The desired new class for the student.
+};
+
+/**
+ * @struct ChangeUcRequest
+ * @brief A structure to represent a request to Change a Student's UC (University Course).
+ */
+struct ChangeUcRequest {
+    int studentCode;      ///< The code of the student for whom the change is requested.
+    UcId currentUc;       ///< The current UC of the student.
+    ClassId currentClass; ///< The current class of the student.
+    UcId newUc;           ///< The desired new UC for the student.
+};
+
+/**
+ * @struct LeaveUcClassRequest
+ * @brief A structure to represent a request for a Student to leave a specific UC and Class.
+ */
+struct LeaveUcClassRequest {
+    int studentCode;      ///< The code of the student who wishes to leave.
+    UcId currentUc;       ///< The UC the student wants to leave.
+    ClassId currentClass; ///< The class the student wants to leave.
+};
+
+/**
+ * @struct JoinUcClassRequest
+ * @brief A structure to represent a request for a Student to join a specific UC and Class.
+ */
+struct JoinUcClassRequest {
+    int studentCode; ///< The code of the student who wishes to join.
+    UcId newUc;      ///< The UC the student wants to join.
+};
+
+/**
+ * @struct SwapClassesRequest
+ * @brief A structure to represent a request for two Students to swap Classes within the same UC.
+ */
+struct SwapClassesRequest {
+    int studentCode1; ///< The code of the first student involved in the class swap.
+    UcId uc;          ///< The UC to which the swap pertains.
+    ClassId class1;   ///< The class of the first student.
+    int studentCode2; ///< The code of the second student involved in the class swap.
+    ClassId class2;   ///< The class of the second student.
+};
+
+// Requests only hold codes and catalog ids, they stay valid when the students tree is replaced and can be copied as bytes
+static_assert(is_trivially_copyable_v<ChangeClassRequest> && is_trivially_copyable_v<ChangeUcRequest> &&
+              is_trivially_copyable_v<LeaveUcClassRequest> && is_trivially_copyable_v<JoinUcClassRequest> &&
+              is_trivially_copyable_v<SwapClassesRequest>, "Change requests must be trivially copyable");
+
+/**
+ * @struct ChangeRequest
+ * @brief A structure to represent a generic Change request, which can be of various types (changing class, changing UC, leaving UC and class, joining UC and class, or swapping classes).
+ *
+ * The type of the request is the alternative held by the variant, requests are dispatched with std::visit
+ * to a function template specialized for each type.
+ */
+struct ChangeRequest {
+    variant<ChangeClassRequest, ChangeUcRequest, LeaveUcClassRequest, JoinUcClassRequest, SwapClassesRequest> requestData; ///< A variant that can hold any of the specific request types, allowing for flexibility in managing different types of requests.
+};
+
+static_assert(is_trivially_copyable_v<ChangeRequest>, "Change requests must be trivially copyable");
+
+/**
+ * @brief Get the name of a request type, every request type must specialize it.
+ * @return The name of the request type.
+ */
+template<typename Request>
+const char* requestTypeName() = delete;
+
+template<> inline const char* requestTypeName<ChangeClassRequest>() { return "ChangeClassRequest"; }
+template<> inline const char* requestTypeName<ChangeUcRequest>() { return "ChangeUcRequest"; }
+template<> inline const char* requestTypeName<LeaveUcClassRequest>() { return "LeaveUcClassRequest"; }
+template<> inline const char* requestTypeName<JoinUcClassRequest>() { return "JoinUcClassRequest"; }
+template<> inline const char* requestTypeName<SwapClassesRequest>() { return "SwapClassesRequest"; }
+
+/**
+ * @brief Get the name of the type of a change request.
+ * @param request The change request.
+ * @return The name of the request type.
+ */
+inline const char* requestTypeName(const ChangeRequest& request) {
+    return visit([](const auto& data) { return requestTypeName<decay_t<decltype(data)>>(); }, request.requestData);
+}
+
+/**
+ * @brief Get the codes of the students involved in a request, the requester first. Every request type must specialize it.
+ * @param request The request.
+ * @return The student codes.
+ */
+template<typename Request>
+vector<int> studentsOf(const Request& request) = delete;
+
+template<> inline vector<int> studentsOf(const ChangeClassRequest& request) { return {request.studentCode}; }
+template<> inline vector<int> studentsOf(const ChangeUcRequest& request) { return {request.studentCode}; }
+template<> inline vector<int> studentsOf(const LeaveUcClassRequest& request) { return {request.studentCode}; }
+template<> inline vector<int> studentsOf(const JoinUcClassRequest& request) { return {request.studentCode}; }
+template<> inline vector<int> studentsOf(const SwapClassesRequest& request) { return {request.studentCode1, request.studentCode2}; }
+
+/**
+ * @brief Get the codes of the students involved in a change request, the requester first.
+ * @param request The change request.
+ * @return The student codes.
+ */
+inline vector<int> studentsOf(const ChangeRequest& request) {
+    return visit([](const auto& data) { return studentsOf(data); }, request.requestData);
+}
+
+#endif //PROJETO_AED_CHANGEREQUEST_H
@@ -0,0 +1,470 @@
+/**
+ * @file ColumnarExporter.cpp
+ * @brief Implementation of the ColumnarExporter class.
+ */
+
+#include "ColumnarExporter.h"
+#include "JournalFile.h"
+#include <algorithm>
+#include <cmath>
+#include <string_view>
+#include <fcntl.h>
+#include <unistd.h>
+
+static const string Magic = "LEICCOL1";
+
+/**
+ * @brief Gets the number of bits needed to store a value.
+ *
+ * @param value The value.
+ * @return The number of bits, 0 for 0.
+ */
+static uint8_t bitWidth(uint64_t value) {
+    return value == 0 ? 0 : (uint8_t) (64 - __builtin_clzll(value));
+}
+
+/**
+ * @brief Appends values bit-packed in 64-bit words, from the low bits of each word.
+ *
+ * @param count The number of values.
+ * @param width The number of bits of each value.
+ * @param value Gives each value, less than 2^width, by its position.
+ * @param out The buffer the words are appended to.
+ *
+ * @complexity O(n), where n is the number of values.
+ */
+template<typename Value>
+static void pack(size_t count, uint8_t width, const Value& value, string& out) {
+    size_t at = out.size();
+    out.resize(at + (count * width + 63) / 64 * sizeof(uint64_t), '\0');
+    if (width == 0) {
+        return;
+    }
+    char* words = &out[at];
+    uint64_t word = 0;
+    unsigned used = 0;
+    auto flush = [&words, &word]() {
+        memcpy(words, &word, sizeof(uint64_t));
+        words += sizeof(uint64_t);
+    };
+    for (size_t i = 0; i < count; i++) {
+        uint64_t bits = value(i);
+        word |= bits << used;
+        used += width;
+        if (used >= 64) {
+            flush();
+            used -= 64;
+            // The bits of the value that didn't fit start the next word
+            word = used == 0 ? 0 : bits >> (width - used);
+        }
+    }
+    if (used > 0) {
+        flush();
+    }
+}
+
+/**
+ * @class StringIds
+ * @brief Gives each distinct string an id, in the order they first appear, for the dictionary of a column.
+ *
+ * An unordered_map allocates a node for each string and divides by a prime on each lookup. This table is
+ * a power of two of slots holding ids, probed linearly, and the hash of each string is kept to compare
+ * it before the string, so a lookup is usually a hash, a mask and a comparison of two integers.
+ */
+class StringIds {
+private:
+    vector<uint32_t> slots;  ///< The id + 1 of the string in each slot, 0 for an empty slot.
+    vector<uint64_t> hashes; ///< The hash of each string, by id.
+
+    /**
+     * @brief Hashes a string, with 64-bit FNV-1a.
+     *
+     * @param text The string.
+     * @return The hash.
+     */
+    static uint64_t hash(string_view text) {
+        uint64_t value = 14695981039346656037ull;
+        for (char c : text) {
+            value = (value ^ (unsigned char) c) * 1099511628211ull;
+        }
+        // The low bits pick the slot, mix the high bits into them
+        return value ^ (value >> 29);
+    }
+
+    /**
+     * @brief Doubles the number of slots, placing every string again.
+     */
+    void grow() {
+        slots.assign(max<size_t>(slots.size() * 2, 64), 0);
+        size_t mask = slots.size() - 1;
+        for (uint32_t id = 0; id < strings.size(); id++) {
+            size_t slot = hashes[id] & mask;
+            while (slots[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = id + 1;
+        }
+    }
+
+public:
+    vector<string_view> strings; ///< The distinct strings, by id.
+
+    /**
+     * @brief Gets the id of a string, giving it the next id if it is new.
+     *
+     * @param text The string, which must outlive the ids.
+     * @return The id of the string.
+     *
+     * @complexity O(l) on average, where l is the length of the string.
+     */
+    uint32_t idOf(string_view text) {
+        if ((strings.size() + 1) * 2 > slots.size()) {
+            grow();
+        }
+        uint64_t textHash = hash(text);
+        size_t mask = slots.size() - 1;
+        size_t slot = textHash & mask;
+        while (slots[slot] != 0) {
+            uint32_t id = slots[slot] - 1;
+            if (hashes[id] == textHash && strings[id] == text) {
+                return id;
+            }
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = (uint32_t) strings.size() + 1;
+        hashes.push_back(textHash);
+        strings.push_back(text);
+        return (uint32_t) strings.size() - 1;
+    }
+};
+
+/**
+ * @brief Adds empty columns to a table.
+ *
+ * @param table The table.
+ * @param columns The name of each column, and true for a string column or false for an integer column.
+ */
+static void addColumns(ColumnTable& table, const vector<pair<string, bool>>& columns) {
+    for (const auto& definition : columns) {
+        Column column;
+        column.name = definition.first;
+        column.text = definition.second;
+        table.columns.push_back(std::move(column));
+    }
+}
+
+/**
+ * @brief Constructor for the ColumnarExporter class.
+ *
+ * @param pool The threads the columns are encoded on.
+ */
+ColumnarExporter::ColumnarExporter(ThreadPool& pool) : pool(pool) {}
+
+/**
+ * @brief Encodes integer values, bit-packed or as runs, whichever is smaller.
+ *
+ * Both encodings store the values as differences from the smallest one. The runs are stored when their
+ * ends and values take fewer words than a value per row.
+ *
+ * @param values The values.
+ * @param encoded Receives the encoding, appended to its chunk.
+ *
+ * @complexity O(n), where n is the number of values.
+ */
+void ColumnarExporter::encodeValues(const vector<int64_t>& values, EncodedColumn& encoded) {
+    if (values.empty()) {
+        return;
+    }
+    int64_t largest = values[0];
+    encoded.base = values[0];
+    size_t runs = 1;
+    for (size_t row = 1; row < values.size(); row++) {
+        encoded.base = min(encoded.base, values[row]);
+        largest = max(largest, values[row]);
+        runs += values[row] != values[row - 1];
+    }
+    uint64_t base = (uint64_t) encoded.base;
+    encoded.valueWidth = bitWidth((uint64_t) largest - base);
+    uint8_t runEndWidth = bitWidth(values.size());
+    size_t packedWords = (values.size() * encoded.valueWidth + 63) / 64;
+    size_t runWords = (runs * runEndWidth + 63) / 64 + (runs * encoded.valueWidth + 63) / 64;
+
+    if (runWords >= packedWords) {
+        pack(values.size(), encoded.valueWidth, [&values, base](size_t row) {
+            return (uint64_t) values[row] - base;
+        }, encoded.chunk);
+        return;
+    }
+    vector<size_t> runEnds;
+    runEnds.reserve(runs);
+    for (size_t row = 1; row < values.size(); row++) {
+        if (values[row] != values[row - 1]) {
+            runEnds.push_back(row);
+        }
+    }
+    runEnds.push_back(values.size());
+    encoded.encoding = 1;
+    encoded.runEndWidth = runEndWidth;
+    encoded.runs = runs;
+    pack(runs, runEndWidth, [&runEnds](size_t run) {
+        return (uint64_t) runEnds[run];
+    }, encoded.chunk);
+    pack(runs, encoded.valueWidth, [&values, &runEnds, base](size_t run) {
+        return (uint64_t) values[runEnds[run] - 1] - base;
+    }, encoded.chunk);
+}
+
+/**
+ * @brief Encodes a column.
+ *
+ * A string column is first replaced by the indexes of its strings in its dictionary, the distinct
+ * strings sorted in byte order, so the order of the indexes is the order of the strings.
+ *
+ * @param column The column.
+ * @return The encoded column.
+ *
+ * @complexity O(n + d log d), where n is the number of values and d the number of distinct strings.
+ */
+ColumnarExporter::EncodedColumn ColumnarExporter::encode(const Column& column) {
+    EncodedColumn encoded;
+    if (!column.text) {
+        encodeValues(column.numbers, encoded);
+        return encoded;
+    }
+
+    StringIds ids;
+    vector<string_view>& dictionary = ids.strings;
+    vector<int64_t> indexes(column.strings.size());
+    for (size_t row = 0; row < column.strings.size(); row++) {
+        const string* value = column.strings[row];
+        // The rows of a student repeat its strings, which are found again without hashing them
+        if (row > 0 && value == column.strings[row - 1]) {
+            indexes[row] = indexes[row - 1];
+            continue;
+        }
+        // The strings are scattered in memory, start loading the ones needed next
+        if (row + PrefetchDistance < column.strings.size()) {
+            __builtin_prefetch(column.strings[row + PrefetchDistance]);
+        }
+        indexes[row] = ids.idOf(*value);
+    }
+    vector<pair<string_view, uint32_t>> sorted(dictionary.size());
+    for (uint32_t id = 0; id < dictionary.size(); id++) {
+        sorted[id] = {dictionary[id], id};
+    }
+    sort(sorted.begin(), sorted.end());
+    vector<int64_t> sortedIndex(dictionary.size());
+    for (uint32_t position = 0; position < sorted.size(); position++) {
+        sortedIndex[sorted[position].second] = position;
+    }
+    for (int64_t& index : indexes) {
+        index = sortedIndex[index];
+    }
+
+    BinaryWriter writer(encoded.chunk);
+    uint32_t offset = 0;
+    writer.put<uint32_t>(offset);
+    for (const auto& entry : sorted) {
+        offset += (uint32_t) entry.first.size();
+        writer.put<uint32_t>(offset);
+    }
+    for (const auto& entry : sorted) {
+        encoded.chunk.append(entry.first.data(), entry.first.size());
+    }
+    encoded.chunk.resize((encoded.chunk.size() + 7) / 8 * 8, '\0');
+    encoded.dictionaryCount = (uint32_t) dictionary.size();
+    encoded.dictionarySize = encoded.chunk.size();
+    encodeValues(indexes, encoded);
+    return encoded;
+}
+
+/**
+ * @brief Builds the enrollment table: a row per enrollment of each student, in the order of the roster CSV file.
+ *
+ * @param students The roster.
+ * @return The table, with StudentCode, StudentName, UcCode and ClassCode columns.
+ *
+ * @complexity O(r), where r is the number of enrollments.
+ */
+ColumnTable ColumnarExporter::enrollmentTable(const StudentBST& students) {
+    ColumnTable table;
+    table.name = "enrollments";
+    addColumns(table, {{"StudentCode", false}, {"StudentName", true}, {"UcCode", true}, {"ClassCode", true}});
+    students.forEachStudent([&table](const Student& student) {
+        for (const Class& ucClass : student.UcToClasses) {
+            table.columns[0].numbers.push_back(student.StudentCode);
+            table.columns[1].strings.push_back(&student.StudentName);
+            table.columns[2].strings.push_back(&ucClass.UcCode);
+            table.columns[3].strings.push_back(&ucClass.ClassCode);
+        }
+    });
+    table.rows = table.columns[0].numbers.size();
+    return table;
+}
+
+/**
+ * @brief Builds the schedule table: a row per schedule of the catalog, with its times in minutes.
+ *
+ * @param catalog The catalog.
+ * @return The table, with UcCode, ClassCode, WeekDay, StartMinute, DurationMinutes and Type columns.
+ *
+ * @complexity O(S), where S is the number of schedules.
+ */
+ColumnTable ColumnarExporter::scheduleTable(const Catalog& catalog) {
+    ColumnTable table;
+    table.name = "schedules";
+    addColumns(table, {
+        {"UcCode", true}, {"ClassCode", true}, {"WeekDay", true}, {"StartMinute", false}, {"DurationMinutes", false}, {"Type", true}
+    });
+    for (const Schedule& schedule : catalog.getSchedules()) {
+        table.columns[0].strings.push_back(&schedule.UcToClasses.UcCode);
+        table.columns[1].strings.push_back(&schedule.UcToClasses.ClassCode);
+        table.columns[2].strings.push_back(&schedule.WeekDay);
+        table.columns[3].numbers.push_back(lround(schedule.StartHour * 60));
+        table.columns[4].numbers.push_back(lround(schedule.Duration * 60));
+        table.columns[5].strings.push_back(&schedule.Type);
+    }
+    table.rows = catalog.getSchedules().size();
+    return table;
+}
+
+/**
+ * @brief Builds the change log table: a row per entry, with the columns of the change log export.
+ *
+ * The time is in nanoseconds since the epoch. The UCs and classes an entry doesn't have are empty
+ * strings, as is the reason of an entry without one; the other student and the cycle length are 0 when
+ * the entry has none.
+ *
+ * @param log The change log.
+ * @param catalog The catalog the UC and class codes are read from.
+ * @return The table.
+ *
+ * @complexity O(n), where n is the number of entries.
+ */
+ColumnTable ColumnarExporter::changeLogTable(const ChangeLog& log, const Catalog& catalog) {
+    static const vector<string> requestTypes = [] {
+        vector<string> names;
+        for (size_t type = 0; type < RequestTypeCount; type++) {
+            names.push_back(describeRequestType((RequestType) type));
+        }
+        return names;
+    }();
+    static const vector<string> reasons = [] {
+        vector<string> names(1);
+        for (size_t reason = 1; reason < LogReasonCount; reason++) {
+            names.push_back(describeReason((LogReason) reason));
+        }
+        return names;
+    }();
+    static const string states[] = {"Denied", "Accepted"};
+
+    ColumnTable table;
+    table.name = "changelog";
+    addColumns(table, {
+        {"Entry", false}, {"Time", false}, {"RequestType", true}, {"StudentCode", false}, {"CurrentUc", true},
+        {"CurrentClass", true}, {"NewUc", true}, {"NewClass", true}, {"State", true}, {"Reason", true},
+        {"OtherStudentCode", false}, {"CycleLength", false}
+    });
+    for (size_t position = 0; position < log.size(); position++) {
+        const ChangeLogEntry& entry = log[position];
+        table.columns[0].numbers.push_back((int64_t) position + 1);
+        table.columns[1].numbers.push_back(entry.timestamp);
+        table.columns[2].strings.push_back(&requestTypes[(size_t) entry.requestType]);
+        table.columns[3].numbers.push_back(entry.studentCode);
+        table.columns[4].strings.push_back(&catalog.getUcCode(entry.currentUc));
+        table.columns[5].strings.push_back(&catalog.getClassCode(entry.currentClass));
+        table.columns[6].strings.push_back(&catalog.getUcCode(entry.newUc));
+        table.columns[7].strings.push_back(&catalog.getClassCode(entry.newClass));
+        table.columns[8].strings.push_back(&states[entry.accepted ? 1 : 0]);
+        table.columns[9].strings.push_back(&reasons[(size_t) entry.reason]);
+        table.columns[10].numbers.push_back(entry.otherStudentCode);
+        table.columns[11].numbers.push_back(entry.cycleLength);
+    }
+    table.rows = log.size();
+    return table;
+}
+
+/**
+ * @brief Writes tables to a columnar file, through a temporary file that replaces it.
+ *
+ * Every column of every table is encoded in parallel, then the chunks are written in order, each
+ * padded to the next page boundary, followed by the footer.
+ *
+ * @param tables The tables.
+ * @param path The path of the file.
+ * @param bytes Receives the size of the file.
+ * @return True if the file was written, otherwise false.
+ *
+ * @complexity O(n / t), where n is the number of values and t the number of threads, and the write of the file.
+ */
+bool ColumnarExporter::exportTables(const vector<ColumnTable>& tables, const string& path, uint64_t& bytes) const {
+    vector<const Column*> columns;
+    for (const ColumnTable& table : tables) {
+        for (const Column& column : table.columns) {
+            columns.push_back(&column);
+        }
+    }
+    vector<EncodedColumn> encoded(columns.size());
+    pool.parallelFor(columns.size(), [&](size_t i) {
+        encoded[i] = encode(*columns[i]);
+    });
+
+    string temporaryPath = path + ".tmp";
+    int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    const string padding(Alignment, '\0');
+    bool ok = writeAll(fd, Magic);
+    uint64_t offset = Magic.size();
+
+    string footer;
+    BinaryWriter writer(footer);
+    writer.put<uint32_t>(1);
+    writer.put<uint32_t>(0x01020304);
+    writer.put<uint32_t>((uint32_t) Alignment);
+    writer.put<uint32_t>((uint32_t) tables.size());
+    size_t next = 0;
+    for (const ColumnTable& table : tables) {
+        writer.putString(table.name);
+        writer.put<uint64_t>(table.rows);
+        writer.put<uint32_t>((uint32_t) table.columns.size());
+        for (const Column& column : table.columns) {
+            EncodedColumn& chunk = encoded[next++];
+            size_t pad = (Alignment - offset % Alignment) % Alignment;
+            ok = ok && writeAll(fd, padding.substr(0, pad)) && writeAll(fd, chunk.chunk);
+            offset += pad;
+
+            writer.putString(column.name);
+            writer.put<uint8_t>(column.text ? 1 : 0);
+            writer.put<uint8_t>(chunk.encoding);
+            writer.put<uint8_t>(chunk.valueWidth);
+            writer.put<uint8_t>(chunk.runEndWidth);
+            writer.put<int64_t>(chunk.base);
+            writer.put<uint64_t>(chunk.runs);
+            writer.put<uint32_t>(chunk.dictionaryCount);
+            writer.put<uint64_t>(chunk.dictionarySize);
+            writer.put<uint64_t>(offset);
+            writer.put<uint64_t>(chunk.chunk.size());
+            writer.put<uint32_t>(crc32(chunk.chunk.data(), chunk.chunk.size()));
+            offset += chunk.chunk.size();
+            // The chunk is in the file, free it before writing the next one
+            string().swap(chunk.chunk);
+        }
+    }
+    uint32_t footerSize = (uint32_t) footer.size();
+    writer.put<uint32_t>(footerSize);
+    writer.put<uint32_t>(crc32(footer.data(), footerSize));
+    footer += Magic;
+    ok = ok && writeAll(fd, footer);
+    bytes = offset + footer.size();
+
+    ok = ok && ::fdatasync(fd) == 0;
+    ::close(fd);
+    if (!ok || ::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        ::unlink(temporaryPath.c_str());
+        return false;
+    }
+    syncDirectoryOf(path);
+    return true;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file ColumnarExporter.h
+ * @brief Header file for the ColumnarExporter class.
+ */
+
+#ifndef PROJETO_AED_COLUMNAREXPORTER_H
+#define PROJETO_AED_COLUMNAREXPORTER_H
+
+#include "Catalog.h"
+#include "ChangeLog.h"
+#include "ThreadPool.h"
+
+/**
+ * @struct Column
+ * @brief A column of a table to export: integers, or strings that are dictionary encoded.
+ */
+struct Column {
+    string name;                   ///< The name of the column.
+    bool text = false;             ///< True for a string column, false for an integer column.
+    vector<int64_t> numbers;       ///< The values of an integer column.
+    vector<const string*> strings; ///< The values of a string column, the strings must outlive the export.
+};
+
+/**
+ * @struct ColumnTable
+ * @brief A table to export, with columns of the same number of rows.
+ */
+struct ColumnTable {
+    string name;            ///< The name of the table.
+    size_t rows = 0;        ///< The number of rows.
+    vector<Column> columns; ///< The columns.
+};
+
+/**
+ * @class ColumnarExporter
+ * @brief Writes tables to a self-describing columnar binary file, encoding the columns in parallel on a thread pool.
+ *
+ * Each column is stored on its own, as a chunk that starts on a 4096 byte boundary, so a reader can map
+ * a single column with mmap and page in nothing else. The file is:
+ *
+ *     "LEICCOL1"  [chunk]...  footer  [footer size: u32] [footer CRC-32: u32]  "LEICCOL1"
+ *
+ * Every value is in the byte order of the machine that wrote it, recorded in the footer. The footer is
+ * the schema: [version: u32 = 1] [byte order mark: u32 = 0x01020304] [alignment: u32 = 4096]
+ * [table count: u32], then for each table [name] [rows: u64] [column count: u32], and for each column
+ * [name] [type: u8] [encoding: u8] [value width: u8] [run end width: u8] [base: i64] [runs: u64]
+ * [dictionary count: u32] [dictionary size: u64] [offset: u64] [size: u64] [CRC-32 of the chunk: u32].
+ * A name is [length: u32] followed by its bytes.
+ *
+ * An integer column (type 0) stores its values; a string column (type 1) starts its chunk with a
+ * dictionary of its distinct strings in byte order, [offsets: u32 x (count + 1)] followed by their bytes,
+ * padded to 8 bytes, and stores the index of each value in the dictionary. The values are then encoded
+ * as differences from the base (the smallest value), bit-packed in the value width, in 64-bit words from
+ * their low bits, a value possibly spanning two words (a width of 0 stores no bits, every value is the base):
+ * - bit-packed (encoding 0): a value per row.
+ * - run-length (encoding 1): the end of each run, the row after its last one, bit-packed in the run end
+ *   width, then the value of each run; a row is found by binary search of the run ends.
+ * The encoding of each column is the smaller of the two, so sorted and repeated columns become runs.
+ */
+class ColumnarExporter {
+private:
+    /**
+     * @struct EncodedColumn
+     * @brief A column encoded as its chunk of the file, with what the footer says about it.
+     */
+    struct EncodedColumn {
+        uint8_t encoding = 0;         ///< 0 for bit-packed, 1 for run-length.
+        uint8_t valueWidth = 0;       ///< The number of bits of each value.
+        uint8_t runEndWidth = 0;      ///< The number of bits of each run end, 0 when bit-packed.
+        int64_t base = 0;             ///< The smallest value, which the values are stored as differences from.
+        uint64_t runs = 0;            ///< The number of runs, 0 when bit-packed.
+        uint32_t dictionaryCount = 0; ///< The number of strings in the dictionary, 0 for an integer column.
+        uint64_t dictionarySize = 0;  ///< The size of the dictionary at the start of the chunk, with its padding.
+        string chunk;                 ///< The bytes of the column in the file.
+    };
+
+    static const size_t Alignment = 4096; ///< The boundary every chunk starts on, the size of a page.
+    static const size_t PrefetchDistance = 16; ///< How many rows ahead the strings of a column are loaded.
+
+    ThreadPool& pool; ///< The threads the columns are encoded on.
+
+    /**
+     * @brief Encode a column.
+     * @param column The column.
+     * @return The encoded column.
+     */
+    static EncodedColumn encode(const Column& column);
+
+    /**
+     * @brief Encode integer values, bit-packed or as runs, whichever is smaller.
+     * @param values The values.
+     * @param encoded Receives the encoding, appended to its chunk.
+     */
+    static void encodeValues(const vector<int64_t>& values, EncodedColumn& encoded);
+
+public:
+    /**
+     * @brief Constructor for the ColumnarExporter class.
+     * @param pool The threads the columns are encoded on.
+     */
+    explicit ColumnarExporter(ThreadPool& pool);
+
+    /**
+     * @brief Build the enrollment table: a row per enrollment of each student, in the order of the roster CSV file.
+     * @param students The roster.
+     * @return The table, with StudentCode, StudentName, UcCode and ClassCode columns.
+     */
+    static ColumnTable enrollmentTable(const StudentBST& students);
+
+    /**
+     * @brief Build the schedule table: a row per schedule of the catalog, with its times in minutes.
+     * @param catalog The catalog.
+     * @return The table, with UcCode, ClassCode, WeekDay, StartMinute, DurationMinutes and Type columns.
+     */
+    static ColumnTable scheduleTable(const Catalog& catalog);
+
+    /**
+     * @brief Build the change log table: a row per entry, with the columns of the change log export.
+     * @param log The change log.
+     * @param catalog The catalog the UC and class codes are read from.
+     * @return The table, with empty strings and zeros for the fields an entry doesn't have.
+     */
+    static ColumnTable changeLogTable(const ChangeLog& log, const Catalog& catalog);
+
+    /**
+     * @brief Write tables to a columnar file, atomically.
+     * @param tables The tables.
+     * @param path The path of the file.
+     * @param bytes Receives the size of the file.
+     * @return True if the file was written, otherwise false.
+     */
+    bool exportTables(const vector<ColumnTable>& tables, const string& path, uint64_t& bytes) const;
+};
+
+#endif //PROJETO_AED_COLUMNAREXPORTER_H
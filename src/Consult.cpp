@@ -4,6 +4,7 @@
  */
 
 #include "Consult.h"
+#include "Terminal.h"
 #include <limits>
 
 /**
@@ -14,37 +15,24 @@ Consult::Consult() {}
 
 /**
  * @brief Parameterized constructor for the Consult class.
- * Initializes the Consult object with the provided Global data.
+ * Initializes the Consult object with the shared data context.
  *
- * @param global The Global data to initialize the Consult.
+ * @param context The shared data context to consult.
  */
-Consult::Consult(Global global) {
-    globalData = global;
-}
-
-/**
- * @brief Updates the Consult's data with new Global data.
- *
- * @param data A Global object containing new data.
- */
-void Consult::updateData(Global data) {
-    globalData = data;
-}
+Consult::Consult(shared_ptr<DataContext> context) : context(std::move(context)) {}
 
 /**
  * @brief Lists students by name.
  *
- * @complexity O(log N) for searching students by code in the binary search tree.
+ * @complexity The search of the index of the names, and O(r) to list the r students found.
  */
 void Consult::listStudentsByName() {
     cout << "Enter the student you want to search for: ";
     string searchName;
     cin >> searchName;
 
-    vector<Student> matchingStudents;
-
-    // Search for students with the exact same name using the binary search tree
-    globalData.Students.searchAllByName(searchName, matchingStudents);
+    // Search for students whose name contains "searchName", only their handles are kept
+    StudentView matchingStudents = context->studentsNamed(searchName);
 
     // Student not found
     if (matchingStudents.empty()) {
@@ -53,13 +41,14 @@ void Consult::listStudentsByName() {
     }
 
     // List all students with "searchName" and allow user to select one
-    system("clear"); // Unix-like system
+    vector<const Student*> listed = matchingStudents.page(0, matchingStudents.size());
+    Terminal::clear();
     cout << "\033[1mSearch criteria:\033[0m (Name: " << searchName << ")" << endl;
     cout << "\n";
     cout << "\033[1mResults of the search:\033[0m " << endl;
-    for (int i = 0; i < matchingStudents.size(); i++) {
-        cout << i + 1 << ". " << "Student Code: " << matchingStudents[i].StudentCode
-             << "     Name: " << matchingStudents[i].StudentName << endl;
+    for (int i = 0; i < listed.size(); i++) {
+        cout << i + 1 << ". " << "Student Code: " << listed[i]->StudentCode
+             << "     Name: " << listed[i]->StudentName << endl;
     }
     cout << "\n";
 
@@ -71,8 +60,8 @@ void Consult::listStudentsByName() {
         cin >> choice;
 
         // Check if user's choice is valid
-        if (choice >= 1 && choice <= matchingStudents.size()) {
-            system("clear");
+        if (choice >= 1 && choice <= listed.size()) {
+            Terminal::clear();
             validChoice = true; // Set flag to exit the loop
         } else {
             cerr << "Invalid input. Please enter a valid number." << endl;
@@ -83,7 +72,7 @@ void Consult::listStudentsByName() {
     }
 
     // Output chosen student's information
-    const Student chosenStudent = matchingStudents[choice - 1];
+    const Student& chosenStudent = *listed[choice - 1];
     cout << "\n";
     cout << "\033[1mSelected student information:\033[0m " << endl;
     cout << "Student Code: " << chosenStudent.StudentCode << endl;
@@ -120,10 +109,10 @@ void Consult::findStudentByCode() {
     }
 
     // Calls searchByCode function defined in Student BST class
-    Student* student = globalData.Students.searchByCode(searchCode);
+    const Student* student = context->getStudents().searchByCode(searchCode);
 
     if (student) {
-        system("clear");
+        Terminal::clear();
         cout << "\033[1mSearch criteria:\033[0m (Code: " << searchCode << ")" << endl;
 
         // Output chosen student's information
@@ -144,6 +133,8 @@ void Consult::findStudentByCode() {
 /**
  * @brief Prints the schedule for a given set of schedules.
  *
+ * The schedule is built in the report buffer and written at once.
+ *
  * @param schedules A vector of Schedule objects to print.
  *
  * @complexity O(S log S), where S is the number of schedules in the input vector
@@ -155,17 +146,20 @@ void Consult::printSchedule(vector<Schedule> schedules) {
     for (const Schedule& schedule : schedules){
         if (weekDay != schedule.WeekDay){
             weekDay = schedule.WeekDay;
-            cout << "-------------------------------------------------" << endl;
-            cout << weekDay << endl;
-            cout << "-------------------------------------------------" << endl;
+            report << "-------------------------------------------------\n";
+            report << weekDay << '\n';
+            report << "-------------------------------------------------\n";
         }
-        cout << "     " << schedule.UcToClasses.UcCode << ", " << schedule.UcToClasses.ClassCode << "" << endl;
-        cout << "   Start Hour: " << floatToHours(schedule.StartHour) << endl;
-        cout << "     End Hour: " << floatToHours(schedule.StartHour + schedule.Duration) << endl;
-        cout << "     Duration: " << schedule.Duration << "h" << endl;
-        cout << "         Type: " << schedule.Type << endl << endl;
-    }
-    cout << "-----------------END OF THE LIST-----------------" << endl;
+        report << "     " << schedule.UcToClasses.UcCode << ", " << schedule.UcToClasses.ClassCode << '\n';
+        report << "   Start Hour: ";
+        report.hours(schedule.StartHour) << '\n';
+        report << "     End Hour: ";
+        report.hours(schedule.StartHour + schedule.Duration) << '\n';
+        report << "     Duration: " << schedule.Duration << "h\n";
+        report << "         Type: " << schedule.Type << "\n\n";
+    }
+    report << "-----------------END OF THE LIST-----------------\n";
+    report.flush();
 }
 
 /**
@@ -174,20 +168,15 @@ void Consult::printSchedule(vector<Schedule> schedules) {
  * @param student The Student for which to retrieve the schedule.
  * @return A vector of Schedule objects representing the student's schedule.
  *
- * @complexity O(N log N)
+ * @complexity O(K log S + K log K), where K is the number of classes of the student and S the number of schedules.
  */
 vector<Schedule> Consult::getStudentSchedule(const Student& student) {
     vector<Schedule> studentSchedule;
     // Loops through all classes student is enrolled in
     for (const Class &studentClass: student.UcToClasses) {
-        // Loops through all schedules
-        for (const Schedule& schedule: globalData.Schedules) {
-            // Find student's schedules
-            if (studentClass.ClassCode == schedule.UcToClasses.ClassCode && studentClass.UcCode == schedule.UcToClasses.UcCode) {
-                // Populate the vector that contains student's schedules
-                studentSchedule.push_back(schedule);
-            }
-        }
+        // Populate the vector that contains student's schedules from the class schedules index
+        const vector<Schedule>& classSchedules = context->getClassSchedules(studentClass.UcCode, studentClass.ClassCode);
+        studentSchedule.insert(studentSchedule.end(), classSchedules.begin(), classSchedules.end());
     }
     // Sort the vector that contains student's schedules
     sort(studentSchedule.begin(), studentSchedule.end());
@@ -211,7 +200,7 @@ void Consult::consultTheScheduleOfStudent() {
         return;
     }
 
-    Student* student = globalData.Students.searchByCode(studentCode);
+    const Student* student = context->getStudents().searchByCode(studentCode);
 
     // Find the student with the given student code
     if (student) {
@@ -243,7 +232,7 @@ void Consult::consultTheScheduleOfClass() {
 
     vector<Schedule> schedules;
     // Loop through all schedules
-    for (const Schedule& schedule : globalData.Schedules){
+    for (const Schedule& schedule : context->getSchedules()){
         // Find the given class schedules
         if (classCode == schedule.UcToClasses.ClassCode) {
             // Populate the vector that contains class schedules
@@ -258,10 +247,65 @@ void Consult::consultTheScheduleOfClass() {
     }
 }
 
+/**
+ * @brief Lists the students of a view a page at a time, asking for the next one while there are more.
+ *
+ * Only the students of the pages shown are read. A listing that fits in a page is shown without asking;
+ * asking for a page past the first or the last one says so and asks again.
+ *
+ * @param students The students to list, in their order.
+ * @param ucCounts True to show the number of UCs of each student.
+ *
+ * @complexity O(P) for each page of P students, and the ordering of the view up to it.
+ */
+void Consult::listStudentPages(StudentView& students, bool ucCounts) {
+    size_t offset = 0;
+    while (true) {
+        size_t index = offset + 1;
+        for (const Student* student : students.page(offset, PageSize)) {
+            report << index++ << ". ";
+            if (ucCounts) {
+                report << '[' << student->UcToClasses.size() << "] ";
+            }
+            report << student->StudentCode << ' ' << student->StudentName << '\n';
+        }
+        if (students.size() <= PageSize) {
+            report.flush();
+            return;
+        }
+        report << "\nShowing " << offset + 1 << '-' << index - 1 << " of " << students.size()
+               << ". Enter n for the next page, p for the previous one, or anything else to stop: ";
+        report.flush();
+
+        // Ask again until the answer is a page that exists, or to stop
+        string answer;
+        while (true) {
+            if (!(cin >> answer)) {
+                return;
+            }
+            bool next = answer == "n" || answer == "N", previous = answer == "p" || answer == "P";
+            if (!next && !previous) {
+                return;
+            }
+            if (next && offset + PageSize < students.size()) {
+                offset += PageSize;
+                break;
+            }
+            if (previous && offset > 0) {
+                offset -= PageSize;
+                break;
+            }
+            cout << (next ? "This is the last page, there is no next page." : "This is the first page, there is no previous page.")
+                 << " Enter n, p, or anything else to stop: ";
+        }
+        report << '\n';
+    }
+}
+
 /**
  * @brief Lists students registered in at least N UCs.
  *
- * @complexity O(N)
+ * @complexity O(N) over the number of UCs of each student, and O(P) for each page of P students.
  */
 void Consult::listOfStudentsInAtLeastNUCs() {
     cout << "\033[1mEnter the number of students registered in at least \n" <<
@@ -275,35 +319,22 @@ void Consult::listOfStudentsInAtLeastNUCs() {
         return;
     }
 
-    int result = 0;
-    set<Student> matchingStudents;
-
-    globalData.Students.searchStudentsInAtLeastNUCs(n, matchingStudents);
+    StudentView matchingStudents = context->studentsInAtLeastNUcs(n);
 
-    cout << "Number of students registered in at least [" << n
-         << "] UCs: " << matchingStudents.size() << endl;
-
-    int i = 1;
-    for (const Student& student : matchingStudents) {
-        cout << i++ << ". [" << student.UcToClasses.size()
-             << "] "<< student.StudentCode << " "
-             << student.StudentName << endl;
-    }
+    report << "Number of students registered in at least [" << n
+           << "] UCs: " << matchingStudents.size() << '\n';
+    listStudentPages(matchingStudents, true);
 }
 
 /**
- * @brief Lists students in a specific class, UC, or year, and returns the list of students.
+ * @brief Lists students in a specific class, UC, or year, in the order the user chooses, a page at a time.
  *
  * @param identifier The identifier (class, UC, year) for which to list students.
- * @param searchCriteria A function to filter students based on the identifier.
+ * @param students The students of the class, UC or year.
  *
- * @complexity O(N)
+ * @complexity O(P) for each page of P students in name order, O(n log P) for the first page of n students in code order.
  */
-void Consult::listOfStudentsInXBySortOrder(const string& identifier, const function<bool(const Class&)> searchCriteria) {
-    set<Student> students;
-
-    globalData.Students.searchStudentsWithin(searchCriteria, students);
-
+void Consult::listOfStudentsInXBySortOrder(const string& identifier, StudentView students) {
     if (students.empty()) {
         cerr << "ERROR: " << identifier << " not valid or empty." << endl;
         return;
@@ -316,28 +347,26 @@ void Consult::listOfStudentsInXBySortOrder(const string& identifier, const funct
     do {
         cout << "1. Ascending order" << endl;
         cout << "2. Descending order" << endl;
+        cout << "3. Student code ascending order" << endl;
+        cout << "4. Student code descending order" << endl;
         cout << "\n";
         cout << "Choose the order: ";
-        cin >> orderChoice;
-    } while (orderChoice != 1 && orderChoice != 2);
-
-    int index = 1;
-
-    if (orderChoice == 1) {
-        cout << " [Ascending order]:" << endl;
-        cout << "\n";
-        for (const Student& student : students) {
-            cout << index << ". " << student.StudentCode << " " << student.StudentName << endl;
-            index++;
-        }
-    } else {
-        cout << " [Descending order]:" << endl;
-        cout << "\n";
-        for (set<Student>::reverse_iterator rit = students.rbegin(); rit != students.rend(); ++rit) {
-            cout << index << ". " << rit->StudentCode << " " << rit->StudentName << endl;
-            index++;
+        if (!(cin >> orderChoice)) {
+            if (cin.eof()) {
+                return;
+            }
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            orderChoice = 0;
         }
-    }
+    } while (orderChoice < 1 || orderChoice > 4);
+
+    const char* orderNames[] = {" [Ascending order]:\n", " [Descending order]:\n",
+                                " [Student code ascending order]:\n", " [Student code descending order]:\n"};
+    students.orderBy(orderChoice <= 2 ? StudentOrder::Name : StudentOrder::Code, orderChoice % 2 == 0);
+    report << orderNames[orderChoice - 1];
+    report << "\n";
+    listStudentPages(students, false);
 }
 
 /**
@@ -358,10 +387,7 @@ void Consult::listOfStudentsInClass() {
         return;
     }
 
-    auto searchCriteria = [&classCode](const Class& ucClass) {
-        return ucClass.ClassCode == classCode;
-    };
-    listOfStudentsInXBySortOrder("class " + classCode, searchCriteria);
+    listOfStudentsInXBySortOrder("class " + classCode, context->studentsInClass(classCode));
 }
 
 /**
@@ -375,10 +401,7 @@ void Consult::listOfStudentsInUc() {
     string ucCode;
     cin >> ucCode;
 
-    auto searchCriteria = [&ucCode](const Class& ucClass) {
-        return ucClass.UcCode == ucCode;
-    };
-    listOfStudentsInXBySortOrder("UC " + ucCode, searchCriteria);
+    listOfStudentsInXBySortOrder("UC " + ucCode, context->studentsInUc(ucCode));
 }
 
 /**
@@ -397,10 +420,7 @@ void Consult::listOfStudentsInYear() {
         return;
     }
 
-    auto searchCriteria = [&year](const Class& ucClass) {
-        return (ucClass.ClassCode[0] == year[0]);
-    };
-    listOfStudentsInXBySortOrder("year " + year, searchCriteria);
+    listOfStudentsInXBySortOrder("year " + year, context->studentsInYear(year[0]));
 }
 
 /**
@@ -421,11 +441,11 @@ void Consult::showSortingMenu(const map<string, int>& studentsCount, const strin
     displayOrder[3] = " occupation ascending order";
     displayOrder[4] = " occupation descending order";
 
-    cout << "Choose a sorting option: " << endl;
-    cout << "1. by " << identifier << displayOrder[1] << endl;
-    cout << "2. by " << identifier << displayOrder[2] << endl;
-    cout << "3. by " << identifier << displayOrder[3] << endl;
-    cout << "4. by " << identifier << displayOrder[4] << endl;
+    report << "Choose a sorting option: \n";
+    for (int option = 1; option <= 4; option++) {
+        report << option << ". by " << identifier << displayOrder[option] << '\n';
+    }
+    report.flush();
 
     int choice;
     cin >> choice;
@@ -456,17 +476,18 @@ void Consult::showSortingMenu(const map<string, int>& studentsCount, const strin
             return;
     }
 
-    cout << "[" << displayOrder[choice] << " ]:" << endl;
+    report << '[' << displayOrder[choice] << " ]:\n";
 
     if (identifier == "year") {
         for (const auto& entry : result) {
-            cout << "Year " << entry.first << ": " << entry.second << " students" << endl;
+            report << "Year " << entry.first << ": " << entry.second << " students\n";
         }
     } else {
         for (const auto& entry : result) {
-            cout << entry.first << ": " << entry.second << " students" << endl;
+            report << entry.first << ": " << entry.second << " students\n";
         }
     }
+    report.flush();
 }
 
 /**
@@ -476,10 +497,10 @@ void Consult::showSortingMenu(const map<string, int>& studentsCount, const strin
  */
 void Consult::occupationInClasses() {
     map<string, int> studentsCount;
-    StudentBST& studentBST = globalData.Students;
+    const StudentBST& studentBST = context->getStudents();
     set<string> processedClassCodes; // Track the processed class codes
 
-    for (const auto& ucClass : globalData.Classes) {
+    for (const auto& ucClass : context->getClasses()) {
         string classCode = ucClass.ClassCode;
         // Check if the class code has already been processed
         if (processedClassCodes.find(classCode) == processedClassCodes.end()) {
@@ -501,10 +522,10 @@ void Consult::occupationInClasses() {
  */
 void Consult::occupationInUcs() {
     map<string, int> studentsCount;
-    StudentBST& studentBST = globalData.Students;
+    const StudentBST& studentBST = context->getStudents();
     set<string> processedUCCodes; // Track the processed UC codes
 
-    for (const auto& ucClass : globalData.Classes) {
+    for (const auto& ucClass : context->getClasses()) {
         string ucCode = ucClass.UcCode;
         // Check if the UC code has already been processed
         if (processedUCCodes.find(ucCode) == processedUCCodes.end()) {
@@ -526,10 +547,10 @@ void Consult::occupationInUcs() {
  */
 void Consult::occupationInYears() {
     map<string, int> studentsCount;
-    StudentBST& studentBST = globalData.Students;
+    const StudentBST& studentBST = context->getStudents();
     set<string> processedYears; // Track the processed years
 
-    for (const auto& ucClass : globalData.Classes) {
+    for (const auto& ucClass : context->getClasses()) {
         string classCode = ucClass.ClassCode;
 
         // Extract the year from the first character of the class code
@@ -618,7 +639,7 @@ void Consult::consultUcOccupation() {
 
     map<string, int> classStudentsCount;
 
-    globalData.Students.getStudentsCountInClass(ucCode, classStudentsCount);
+    context->getStudents().getStudentsCountInClass(ucCode, classStudentsCount);
 
     if (classStudentsCount.empty()){
         cerr << "ERROR: Invalid UC Code or no students registered in UC, please Enter a valid UC (L.EIC001-L.EIC005 / L.EIC011-L.EIC015 / L.EIC021-L.EIC025 / UP001)" << endl;
@@ -639,7 +660,7 @@ void Consult::consultUcOccupation() {
 set<string> Consult::ucsOfTheYear(int year){
     set<string> ucsOfTheYear;
 
-    for (auto classObj : globalData.Classes){
+    for (const auto& classObj : context->getClasses()){
         if (classObj.ClassCode[0] == '0' + year){
             ucsOfTheYear.insert(classObj.UcCode);
         }
@@ -673,7 +694,7 @@ void Consult::consultYearOccupation() {
     map<string, int> ucStudentsCount;
 
     for (const auto& uc : ucsOfTheYear_) {
-        globalData.Students.getStudentsCountInUc(uc, ucStudentsCount);
+        context->getStudents().getStudentsCountInUc(uc, ucStudentsCount);
     }
 
     string year_ = to_string(year);
@@ -7,6 +7,8 @@
 #define PROJETO_AED_CONSULT_H
 
 #include "ReadData.h"
+#include "DataContext.h"
+#include "ReportBuffer.h"
 
 /**
  * @class Consult
@@ -14,6 +16,18 @@
  */
 class Consult {
 private:
+    ReportBuffer report; ///< The buffer the listings are built in and written from at once, reused between them.
+
+    static const size_t PageSize = 50; ///< The number of students listed at a time.
+
+    /**
+     * @brief Lists the students of a view a page at a time, asking for the next one while there are more.
+     *
+     * @param students The students to list, in their order.
+     * @param ucCounts True to show the number of UCs of each student.
+     */
+    void listStudentPages(StudentView& students, bool ucCounts);
+
     /**
      * @brief Retrieves a set of UCs for a given year.
      *
@@ -23,7 +37,7 @@ private:
     set<string> ucsOfTheYear(int year);
 
 public:
-    Global globalData;
+    shared_ptr<DataContext> context; ///< The data context shared with the rest of the application.
 
     /**
      * @brief Default constructor for the Consult class.
@@ -35,20 +49,11 @@ public:
     /**
      * @brief Parameterized constructor for the Consult class.
      *
-     * This constructor initializes the Consult object with the provided Global data.
-     *
-     * @param global The Global data to initialize the Consult.
-     */
-    Consult(Global global);
-
-    /**
-     * @brief Updates the Consult's data with new Global data.
-     *
-     * This function updates the Consult's data with the provided Global data.
+     * This constructor initializes the Consult object with the shared data context, no data is copied.
      *
-     * @param data A Global object containing new data.
+     * @param context The shared data context to consult.
      */
-    void updateData(Global data);
+    Consult(shared_ptr<DataContext> context);
 
     /**
      * @brief Lists students by name.
@@ -94,9 +99,9 @@ public:
      * @brief Lists students in a specific class, UC, or year, and returns the list of students.
      *
      * @param identifier The identifier (class, UC, year) for which to list students.
-     * @param searchCriteria A function to filter students based on the identifier.
+     * @param students The students of the class, UC or year.
      */
-    void listOfStudentsInXBySortOrder(const string& identifier, const function<bool(const Class&)> searchCriteria);
+    void listOfStudentsInXBySortOrder(const string& identifier, StudentView students);
 
     /**
      * @brief Lists students in a specific class.
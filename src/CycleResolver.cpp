@@ -0,0 +1,141 @@
+/**
+ * @file CycleResolver.cpp
+ * @brief Implementation of the CycleResolver class.
+ */
+
+#include "CycleResolver.h"
+#include <queue>
+
+/**
+ * @brief Constructor for the CycleResolver class.
+ *
+ * @param context The shared data context to read from.
+ */
+CycleResolver::CycleResolver(shared_ptr<DataContext> context) : context(std::move(context)) {}
+
+/**
+ * @brief Checks if a class change request can take part in a cycle.
+ *
+ * The student must still be in the class the request was made from, and the schedule with the
+ * new class must have no conflicts. Capacity and balance are not checked, a cycle doesn't change them.
+ *
+ * @param request The class change request.
+ * @return True if the request can be part of a cycle, otherwise false.
+ */
+bool CycleResolver::isMovable(const ChangeClassRequest& request) const {
+    const Student* student = context->findStudent(request.studentCode);
+    if (student == nullptr || request.currentClass == request.newClass) {
+        return false;
+    }
+
+    vector<Class> enrollment = student->UcToClasses;
+    auto current = find(enrollment.begin(), enrollment.end(), Class(context->getUcCode(request.currentUc), context->getClassCode(request.currentClass)));
+    if (current == enrollment.end()) {
+        return false;
+    }
+    current->ClassCode = context->getClassCode(request.newClass);
+    return !Change(context).hasScheduleConflict(enrollment);
+}
+
+/**
+ * @brief Finds edge-disjoint cycles of class change requests.
+ *
+ * The requests are tried in queue order, for each one a breadth-first search over the unused requests of
+ * the same UC looks for the shortest way back from its new class to its current class, so implicit swaps
+ * (2-cycles) are found before longer cycles. A cycle is only kept if every student in it is different.
+ *
+ * @param requests The pending change requests, in queue order.
+ * @return The cycles found, each one as the positions of its requests in the given vector.
+ *
+ * @complexity O(R * (C + R)), where R is the number of class change requests of a UC and C its number of classes.
+ */
+vector<vector<size_t>> CycleResolver::findCycles(const vector<ChangeRequest>& requests) const {
+    // Group the movable class change requests by UC, in queue order
+    map<UcId, vector<size_t>> requestsOfUc;
+    for (size_t i = 0; i < requests.size(); i++) {
+        const ChangeClassRequest* request = get_if<ChangeClassRequest>(&requests[i].requestData);
+        if (request != nullptr && isMovable(*request)) {
+            requestsOfUc[request->currentUc].push_back(i);
+        }
+    }
+
+    vector<vector<size_t>> cycles;
+
+    for (const auto& uc : requestsOfUc) {
+        const vector<size_t>& edges = uc.second;
+        auto edge = [&](size_t k) -> const ChangeClassRequest& {
+            return get<ChangeClassRequest>(requests[edges[k]].requestData);
+        };
+
+        // Outgoing edges of each class, in queue order
+        map<ClassId, vector<size_t>> outgoing;
+        for (size_t k = 0; k < edges.size(); k++) {
+            outgoing[edge(k).currentClass].push_back(k);
+        }
+
+        vector<bool> used(edges.size(), false);
+
+        for (size_t k = 0; k < edges.size(); k++) {
+            if (used[k]) {
+                continue;
+            }
+            ClassId start = edge(k).newClass;
+            ClassId target = edge(k).currentClass;
+
+            // Breadth-first search from the new class back to the current class
+            map<ClassId, size_t> parentEdge;
+            set<ClassId> visited = {start};
+            queue<ClassId> frontier;
+            frontier.push(start);
+            bool found = false;
+
+            while (!frontier.empty() && !found) {
+                ClassId classId = frontier.front();
+                frontier.pop();
+                for (size_t e : outgoing[classId]) {
+                    ClassId next = edge(e).newClass;
+                    if (used[e] || e == k || visited.count(next)) {
+                        continue;
+                    }
+                    parentEdge[next] = e;
+                    if (next == target) {
+                        found = true;
+                        break;
+                    }
+                    visited.insert(next);
+                    frontier.push(next);
+                }
+            }
+
+            if (!found) {
+                continue;
+            }
+
+            // Rebuild the cycle, starting with the request k
+            vector<size_t> path;
+            for (ClassId classId = target; classId != start; classId = edge(parentEdge[classId]).currentClass) {
+                path.push_back(parentEdge[classId]);
+            }
+            path.push_back(k);
+            reverse(path.begin(), path.end());
+
+            // Every student of the cycle must be different
+            set<int> students;
+            for (size_t e : path) {
+                students.insert(edge(e).studentCode);
+            }
+            if (students.size() != path.size()) {
+                continue;
+            }
+
+            vector<size_t> cycle;
+            for (size_t e : path) {
+                used[e] = true;
+                cycle.push_back(edges[e]);
+            }
+            cycles.push_back(cycle);
+        }
+    }
+
+    return cycles;
+}
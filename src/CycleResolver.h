@@ -0,0 +1,48 @@
+/**
+ * @file CycleResolver.h
+ * @brief Header file for the CycleResolver class.
+ */
+
+#ifndef PROJETO_AED_CYCLERESOLVER_H
+#define PROJETO_AED_CYCLERESOLVER_H
+
+#include "Change.h"
+#include "ChangeRequest.h"
+
+/**
+ * @class CycleResolver
+ * @brief Finds cycles of class change requests that can only be accepted together.
+ *
+ * For each UC, the pending ChangeClassRequests form a directed graph where the nodes are the classes
+ * and each request is an edge from the current class to the new class of the student. A cycle of
+ * requests (A wants B's class, B wants C's, C wants A's; or two students that want each other's class)
+ * leaves the number of students of every class unchanged, so the capacity and balance rules can't
+ * deny it, and it can be committed as a whole if every member's new schedule has no conflicts.
+ */
+class CycleResolver {
+private:
+    shared_ptr<DataContext> context; ///< The data context shared with the rest of the application.
+
+    /**
+     * @brief Check if a class change request can take part in a cycle.
+     * @param request The class change request.
+     * @return True if the student is still in the current class and the new schedule has no conflicts.
+     */
+    bool isMovable(const ChangeClassRequest& request) const;
+
+public:
+    /**
+     * @brief Constructor for the CycleResolver class.
+     * @param context The shared data context to read from.
+     */
+    CycleResolver(shared_ptr<DataContext> context);
+
+    /**
+     * @brief Find edge-disjoint cycles of class change requests, shortest cycles and oldest requests first.
+     * @param requests The pending change requests, in queue order.
+     * @return The cycles found, each one as the positions of its requests in the given vector.
+     */
+    vector<vector<size_t>> findCycles(const vector<ChangeRequest>& requests) const;
+};
+
+#endif //PROJETO_AED_CYCLERESOLVER_H
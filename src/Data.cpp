@@ -100,13 +100,16 @@ Student::Student(const int studentCode, const string studentName) :
     StudentCode(studentCode), StudentName(studentName){}
 
 /**
- * @brief Less than operator for comparing Student objects.
+ * @brief Less than operator for comparing Student objects, by name and then by code.
+ *
+ * The code breaks the ties, so that students with the same name are different students.
  *
  * @param other The Student object to compare with.
  * @return True if this object is less than the other object, false otherwise.
  */
 bool Student::operator<(const Student &other) const {
-    return StudentName < other.StudentName;
+    int byName = StudentName.compare(other.StudentName);
+    return byName < 0 || (byName == 0 && StudentCode < other.StudentCode);
 }
 
 /**
@@ -146,7 +149,7 @@ Node* StudentBST::insertStudent(Node* root, const Student& student) {
  * @param node The current node in the traversal.
  * @param action The action to be executed for each node.
  */
-void StudentBST::inOrderTraversal(Node* node, function<void(const Student&)> action) {
+void StudentBST::inOrderTraversal(Node* node, function<void(const Student&)> action) const {
     if (node == nullptr) {
         return;
     }
@@ -197,7 +200,7 @@ StudentBST::StudentBST() : root(nullptr) {}
  *
  * @return A pointer to the root node of the BST.
  */
-Node* StudentBST::getRoot() {
+Node* StudentBST::getRoot() const {
     return root;
 }
 
@@ -240,6 +243,25 @@ Student* StudentBST::searchByCode(const int& studentCode) {
     return searchByCode(root, studentCode);
 }
 
+/**
+ * @brief Search for a student with a specific student code in the BST without allowing modifications.
+ *
+ * @param studentCode The student code to search for.
+ * @return A pointer to the constant Student object if found, or nullptr if not found.
+ */
+const Student* StudentBST::searchByCode(const int& studentCode) const {
+    return const_cast<StudentBST*>(this)->searchByCode(root, studentCode);
+}
+
+/**
+ * @brief Perform an action on every student of the BST, in name order.
+ *
+ * @param action The action to be executed for each student.
+ */
+void StudentBST::forEachStudent(function<void(const Student&)> action) const {
+    inOrderTraversal(root, action);
+}
+
 /**
  * @brief Search for students by name and store matching students in a vector.
  *
@@ -249,11 +271,13 @@ Student* StudentBST::searchByCode(const int& studentCode) {
  * @param searchName The name or part of the name to search for.
  * @param matchingStudents A vector to store the matching Student objects.
  */
-void StudentBST::searchAllByName(const string& searchName, vector<Student>& matchingStudents) {
+void StudentBST::searchAllByName(const string& searchName, vector<Student>& matchingStudents) const {
+    // The search term doesn't change, it is lowered once
+    string searchNameLowered = ToLower(searchName);
+
     // Define a lambda function to perform the search by name
-    auto searchByNameAction = [&matchingStudents, &searchName](const Student& student) {
+    auto searchByNameAction = [&matchingStudents, &searchNameLowered](const Student& student) {
         // Action to perform on each node (in this case, searching by name)
-        string searchNameLowered = ToLower(searchName);
         string studentNameLowered = ToLower(student.StudentName);
 
         if (studentNameLowered.find(searchNameLowered) != string::npos) {
@@ -274,7 +298,7 @@ void StudentBST::searchAllByName(const string& searchName, vector<Student>& matc
  * @param n The minimum number of UCs a student must be registered in to be considered a match.
  * @param matchingStudents A set to store the matching Student objects.
  */
-void StudentBST::searchStudentsInAtLeastNUCs(const int n, set<Student>& matchingStudents) {
+void StudentBST::searchStudentsInAtLeastNUCs(const int n, set<Student>& matchingStudents) const {
     // Define a lambda function to perform the search for students registered in at least n UCs
     auto searchStudentsInAtLeastNUCsAction = [&matchingStudents, &n](const Student& student) {
         // Action to perform on each node (in this case, searching for students registered in at least n UCs)
@@ -296,7 +320,7 @@ void StudentBST::searchStudentsInAtLeastNUCs(const int n, set<Student>& matching
  * @param searchCriteria A function that defines the custom search criteria for Class objects.
  * @param matchingStudents A set to store the matching Student objects.
  */
-void StudentBST::searchStudentsWithin(const function<bool(const Class&)> searchCriteria, set<Student>& matchingStudents) {
+void StudentBST::searchStudentsWithin(const function<bool(const Class&)> searchCriteria, set<Student>& matchingStudents) const {
     // Define a lambda function to perform the search by class code
     auto searchStudentsAction = [&matchingStudents, &searchCriteria](const Student& student) {
         // Action to perform on each node
@@ -322,7 +346,7 @@ void StudentBST::searchStudentsWithin(const function<bool(const Class&)> searchC
  * @param ucCode The unique code of the UC.
  * @param classStudentsCount A map to store the counts of students in each class.
  */
-void StudentBST::getStudentsCountInClass(const string& ucCode, map<string, int>& classStudentsCount) {
+void StudentBST::getStudentsCountInClass(const string& ucCode, map<string, int>& classStudentsCount) const {
     // Define a lambda function to perform the counting
     auto countAction = [&classStudentsCount, &ucCode](const Student& student) {
         // Action to perform on each node (in this case, searching by uc code)
@@ -347,7 +371,7 @@ void StudentBST::getStudentsCountInClass(const string& ucCode, map<string, int>&
  * @param ucCode The unique code of the UC.
  * @param ucStudentsCount A map to store the counts of students in each UC.
  */
-void StudentBST::getStudentsCountInUc(const string& ucCode, map<string, int>& ucStudentsCount) {
+void StudentBST::getStudentsCountInUc(const string& ucCode, map<string, int>& ucStudentsCount) const {
     // Perform the counting using an in-order traversal
     auto countAction = [&ucStudentsCount, &ucCode](const Student& student) {
         for (const Class& studentClass : student.UcToClasses) {
@@ -370,7 +394,7 @@ void StudentBST::getStudentsCountInUc(const string& ucCode, map<string, int>& uc
  * @param classCode The class code to count students in.
  * @return The number of students in the specified class.
  */
-int StudentBST::countStudentsInClass(const string& classCode) {
+int StudentBST::countStudentsInClass(const string& classCode) const {
     int count = 0;
 
     // Define a lambda function to perform the counting
@@ -398,7 +422,7 @@ int StudentBST::countStudentsInClass(const string& classCode) {
  * @param ucCode The UC code to count students in.
  * @return The number of students in the specified UC (course).
  */
-int StudentBST::countStudentsInUC(const string& ucCode) {
+int StudentBST::countStudentsInUC(const string& ucCode) const {
     int count = 0;
 
     // Define a lambda function to perform the counting
@@ -426,7 +450,7 @@ int StudentBST::countStudentsInUC(const string& ucCode) {
  * @param year The character representing the class code's year (e.g., 'A', 'B').
  * @return The number of students with class codes starting with the specified character.
  */
-int StudentBST::countStudentsInYear(const string& year) {
+int StudentBST::countStudentsInYear(const string& year) const {
     int count = 0;
 
     // Define a lambda function to perform the counting
@@ -452,7 +476,7 @@ int StudentBST::countStudentsInYear(const string& year) {
  *
  * @param filename The name of the CSV file to save the data to.
  */
-void StudentBST::saveToCSV(const string& filename) {
+void StudentBST::saveToCSV(const string& filename) const {
     ofstream csvFile(filename);
 
     if (!csvFile.is_open()) {
@@ -7,9 +7,11 @@
 #define PROJETO_AED_DATA_H
 
 #include "UtilityFunctions.h"
+#include <cstdint>
 #include <iostream>
 #include <algorithm>
 #include <fstream>
+#include <functional>
 #include <map>
 #include <set>
 #include <stack>
@@ -17,6 +19,26 @@
 #include <unordered_map>
 #include <vector>
 
+/**
+ * @brief The position of a UC code in the catalog, a compact and stable id for the UC.
+ */
+typedef uint16_t UcId;
+
+/**
+ * @brief The position of a class code in the catalog, a compact and stable id for the class.
+ */
+typedef uint16_t ClassId;
+
+/**
+ * @brief The id given to codes that are not in the catalog.
+ */
+const uint16_t InvalidId = UINT16_MAX;
+
+/**
+ * @brief An enrollment stored as the UC and class ids of each class, a fraction of the size of the codes.
+ */
+typedef vector<pair<UcId, ClassId>> PackedEnrollment;
+
 /**
  * @class Class
  * @brief A class to represent a course Class.
@@ -111,7 +133,7 @@ public:
     Student(const int studentCode, const string studentName);
 
     /**
-    * @brief Less than operator for comparing two Student objects.
+    * @brief Less than operator for comparing two Student objects, by name and then by code.
     * @param other The Student object to compare with.
     * @return True if this Student object is less than the other, otherwise false.
     */
@@ -176,7 +198,7 @@ private:
      * @param node The current node being processed.
      * @param action The action to perform on each Student object.
      */
-    void inOrderTraversal(Node* node, function<void(const Student&)> action);
+    void inOrderTraversal(Node* node, function<void(const Student&)> action) const;
 
 public:
     /**
@@ -188,7 +210,7 @@ public:
      * @brief Get the root of the BST.
      * @return Pointer to the root node.
      */
-    Node* getRoot();
+    Node* getRoot() const;
 
     /**
      * @brief Set the root of the BST.
@@ -211,67 +233,80 @@ public:
      */
     Student* searchByCode(const int& studentCode);
 
+    /**
+     * @brief Search for a student with a specific StudentCode (read-only).
+     * @param studentCode The unique code of the student to search for.
+     * @return Pointer to the found Student object, or nullptr if not found.
+     */
+    const Student* searchByCode(const int& studentCode) const;
+
+    /**
+     * @brief Perform an action on every student, in name order.
+     * @param action The action to perform on each Student object.
+     */
+    void forEachStudent(function<void(const Student&)> action) const;
+
     /**
      * @brief Search for all students with a specific name or partial name (case insensitive).
      * @param searchName The name to search for.
      * @param matchingStudents The list of matching Student objects.
      */
-    void searchAllByName(const string& searchName, vector<Student>& matchingStudents);
+    void searchAllByName(const string& searchName, vector<Student>& matchingStudents) const;
 
     /**
      * @brief Search for students who are enrolled in at least 'n' course units.
      * @param n The minimum number of course units a student is enrolled.
      * @param matchingStudents The list of matching Student objects.
      */
-    void searchStudentsInAtLeastNUCs(const int n, set<Student>& matchingStudents);
+    void searchStudentsInAtLeastNUCs(const int n, set<Student>& matchingStudents) const;
 
     /**
      * @brief Search for students who meet a custom search criteria.
      * @param searchCriteria The custom search criteria function.
      * @param matchingStudents The list of matching Student objects.
      */
-    void searchStudentsWithin(const function<bool(const Class&)> searchCriteria, set<Student>& matchingStudents);
+    void searchStudentsWithin(const function<bool(const Class&)> searchCriteria, set<Student>& matchingStudents) const;
 
     /**
      * @brief Get the count of students in each class for a specific course unit.
      * @param ucCode The code of the course unit to count students in.
      * @param classStudentsCount A map containing class codes as keys and the number of students in each class.
      */
-    void getStudentsCountInClass(const string& ucCode, map<string, int>& classStudentsCount);
+    void getStudentsCountInClass(const string& ucCode, map<string, int>& classStudentsCount) const;
 
     /**
      * @brief Get the count of students in a specific course unit.
      * @param ucCode The code of the course unit to count students in.
      * @param ucStudentsCount A map containing the course unit codes as keys and the number of students in each course unit.
      */
-    void getStudentsCountInUc(const string& ucCode, map<string, int>& ucStudentsCount);
+    void getStudentsCountInUc(const string& ucCode, map<string, int>& ucStudentsCount) const;
 
     /**
      * @brief Count the number of students in a specific class.
      * @param classCode The code of the class to count students in.
      * @return The number of students in the class.
      */
-    int countStudentsInClass(const string& classCode);
+    int countStudentsInClass(const string& classCode) const;
 
     /**
      * @brief Count the number of students in a specific course unit.
      * @param ucCode The code of the course unit to count students in.
      * @return The number of students in the course unit.
      */
-    int countStudentsInUC(const string& ucCode);
+    int countStudentsInUC(const string& ucCode) const;
 
     /**
      * @brief Count the number of students in a specific academic year.
      * @param year The academic year to count students in.
      * @return The number of students in the academic year.
      */
-    int countStudentsInYear(const string& year);
+    int countStudentsInYear(const string& year) const;
 
     /**
      * @brief Save the student data to a CSV file.
      * @param filename The name of the CSV file to save the data to.
      */
-    void saveToCSV(const string& filename);
+    void saveToCSV(const string& filename) const;
 };
 
 #endif //PROJETO_AED_DATA_H
\ No newline at end of file
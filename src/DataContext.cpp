@@ -0,0 +1,578 @@
+/**
+ * @file DataContext.cpp
+ * @brief Implementation of the classes and functions defined in DataContext.h.
+ */
+
+#include "DataContext.h"
+#include <algorithm>
+
+/**
+ * @brief Constructor for the DataContext class, the catalog is built from the classes and schedules of the data.
+ *
+ * @param data The initial data of the context.
+ */
+DataContext::DataContext(Global data)
+    : DataContext(make_shared<const Catalog>(std::move(data.Classes), std::move(data.Schedules)), data.Students) {}
+
+/**
+ * @brief Constructor for the DataContext class, on a catalog shared with other contexts.
+ *
+ * @param catalog The catalog, shared with the contexts built on it.
+ * @param students The roster of the context.
+ */
+DataContext::DataContext(shared_ptr<const Catalog> catalog, StudentBST students)
+    : catalog(std::move(catalog)), students(students), version(0), writing(false), nextObserverId(0) {
+    rebuildOccupancy();
+    rebuildStudentIndex();
+}
+
+/**
+ * @brief Recount the number of students in each class.
+ *
+ * @complexity O(N)
+ */
+void DataContext::rebuildOccupancy() {
+    classOccupancy.clear();
+    students.forEachStudent([this](const Student& student) {
+        updateOccupancy({}, student.UcToClasses);
+    });
+}
+
+/**
+ * @brief Rebuild the indexes of the students.
+ *
+ * The handles are given in name order, so the handles of each UC and class are appended already
+ * sorted; a student enrolled in a class code in several UCs is only added once to that class. The
+ * names only change with the whole tree, so the index of the names is only built here.
+ *
+ * @complexity O(N (c + L)), where c is the number of classes of each student and L the length of the names.
+ */
+void DataContext::rebuildStudentIndex() {
+    studentsByName.clear();
+    studentCodes.clear();
+    studentUcCounts.clear();
+    studentsByCode.clear();
+    ucStudents.clear();
+    classStudents.clear();
+    students.forEachStudent([this](const Student& student) {
+        StudentHandle handle = (StudentHandle) studentsByName.size();
+        // The tree is owned by this context, the const only comes from the traversal
+        studentsByName.push_back(const_cast<Student*>(&student));
+        studentCodes.push_back(student.StudentCode);
+        studentUcCounts.push_back((uint32_t) student.UcToClasses.size());
+        studentsByCode[student.StudentCode] = handle;
+        for (const Class& ucClass : student.UcToClasses) {
+            UcId ucId = getUcId(ucClass.UcCode);
+            ClassId classId = getClassId(ucClass.ClassCode);
+            if (ucId != InvalidId) {
+                if (ucId >= ucStudents.size()) {
+                    ucStudents.resize(ucId + 1);
+                }
+                if (ucStudents[ucId].empty() || ucStudents[ucId].back() != handle) {
+                    ucStudents[ucId].push_back(handle);
+                }
+            }
+            if (classId != InvalidId) {
+                if (classId >= classStudents.size()) {
+                    classStudents.resize(classId + 1);
+                }
+                if (classStudents[classId].empty() || classStudents[classId].back() != handle) {
+                    classStudents[classId].push_back(handle);
+                }
+            }
+        }
+    });
+    studentNames.build(studentsByName);
+}
+
+/**
+ * @brief Removes a handle from the sorted handles of the UCs or classes a student left, and adds it to the ones it joined.
+ *
+ * @param index The handles of each UC or class, by id.
+ * @param handle The handle of the student.
+ * @param oldIds The ids of the UCs or classes before the change, sorted and without repetitions.
+ * @param newIds The ids of the UCs or classes after the change, sorted and without repetitions.
+ *
+ * @complexity O(c m), where c is the number of ids and m the number of students of the UCs or classes.
+ */
+static void moveHandle(vector<vector<StudentHandle>>& index, StudentHandle handle, const vector<uint16_t>& oldIds, const vector<uint16_t>& newIds) {
+    for (uint16_t id : oldIds) {
+        if (!binary_search(newIds.begin(), newIds.end(), id) && id < index.size()) {
+            auto it = lower_bound(index[id].begin(), index[id].end(), handle);
+            if (it != index[id].end() && *it == handle) {
+                index[id].erase(it);
+            }
+        }
+    }
+    for (uint16_t id : newIds) {
+        if (!binary_search(oldIds.begin(), oldIds.end(), id)) {
+            if (id >= index.size()) {
+                index.resize(id + 1);
+            }
+            index[id].insert(lower_bound(index[id].begin(), index[id].end(), handle), handle);
+        }
+    }
+}
+
+/**
+ * @brief Move a student from the UCs and classes of one enrollment to the ones of another, in the indexes of the students.
+ *
+ * @param handle The handle of the student.
+ * @param oldClasses The enrollment of the student before the change.
+ * @param newClasses The enrollment of the student after the change.
+ *
+ * @complexity O(c m), where c is the number of classes of the student and m the number of students of its UCs.
+ */
+void DataContext::updateStudentIndex(StudentHandle handle, const vector<Class>& oldClasses, const vector<Class>& newClasses) {
+    auto ids = [this](const vector<Class>& classes, vector<uint16_t>& ucIds, vector<uint16_t>& classIds) {
+        for (const Class& ucClass : classes) {
+            UcId ucId = getUcId(ucClass.UcCode);
+            ClassId classId = getClassId(ucClass.ClassCode);
+            if (ucId != InvalidId) {
+                ucIds.push_back(ucId);
+            }
+            if (classId != InvalidId) {
+                classIds.push_back(classId);
+            }
+        }
+        for (vector<uint16_t>* list : {&ucIds, &classIds}) {
+            sort(list->begin(), list->end());
+            list->erase(unique(list->begin(), list->end()), list->end());
+        }
+    };
+    vector<uint16_t> oldUcs, oldClassIds, newUcs, newClassIds;
+    ids(oldClasses, oldUcs, oldClassIds);
+    ids(newClasses, newUcs, newClassIds);
+    moveHandle(ucStudents, handle, oldUcs, newUcs);
+    moveHandle(classStudents, handle, oldClassIds, newClassIds);
+    studentUcCounts[handle] = (uint32_t) newClasses.size();
+}
+
+/**
+ * @brief Make a view of students from a list of handles of the indexes.
+ *
+ * @param handles The handles, sorted and without repetitions.
+ * @return The view, in name order.
+ */
+StudentView DataContext::makeView(vector<StudentHandle> handles) const {
+    return StudentView(studentsByName, studentCodes, std::move(handles));
+}
+
+/**
+ * @brief Move a student's contribution in the occupancy from one enrollment to another.
+ *
+ * Classes left without students are removed, as StudentBST::getStudentsCountInClass doesn't report them.
+ *
+ * @param oldClasses The enrollment of the student before the change.
+ * @param newClasses The enrollment of the student after the change.
+ */
+void DataContext::updateOccupancy(const vector<Class>& oldClasses, const vector<Class>& newClasses) {
+    for (const Class& ucClass : oldClasses) {
+        map<string, int>& ucOccupancy = classOccupancy[ucClass.UcCode];
+        if (--ucOccupancy[ucClass.ClassCode] <= 0) {
+            ucOccupancy.erase(ucClass.ClassCode);
+        }
+    }
+    for (const Class& ucClass : newClasses) {
+        classOccupancy[ucClass.UcCode][ucClass.ClassCode]++;
+    }
+}
+
+/**
+ * @brief Retrieves the shared catalog.
+ *
+ * @return A shared pointer to the catalog.
+ */
+shared_ptr<const Catalog> DataContext::getCatalog() const {
+    return catalog;
+}
+
+/**
+ * @brief Retrieves the classes data.
+ *
+ * @return A constant reference to the vector of Class objects.
+ */
+const vector<Class>& DataContext::getClasses() const {
+    return catalog->getClasses();
+}
+
+/**
+ * @brief Retrieves the schedules data.
+ *
+ * @return A constant reference to the vector of Schedule objects.
+ */
+const vector<Schedule>& DataContext::getSchedules() const {
+    return catalog->getSchedules();
+}
+
+/**
+ * @brief Retrieves the students data.
+ *
+ * @return A constant reference to the StudentBST.
+ */
+const StudentBST& DataContext::getStudents() const {
+    return students;
+}
+
+/**
+ * @brief Get the codes of every UC in the catalog.
+ *
+ * @return The UC codes, in catalog order.
+ */
+const vector<string>& DataContext::getUcCodes() const {
+    return catalog->getUcCodes();
+}
+
+/**
+ * @brief Get the class codes of a UC in the catalog.
+ *
+ * @param ucCode The code of the UC.
+ * @return The class codes of the UC, empty if the UC doesn't exist.
+ */
+const vector<string>& DataContext::getClassesOfUc(const string& ucCode) const {
+    return catalog->getClassesOfUc(ucCode);
+}
+
+/**
+ * @brief Get the schedules of a class of a UC.
+ *
+ * @param ucCode The code of the UC.
+ * @param classCode The code of the class.
+ * @return The schedules of the class, empty if the class doesn't exist.
+ *
+ * @complexity O(log S)
+ */
+const vector<Schedule>& DataContext::getClassSchedules(const string& ucCode, const string& classCode) const {
+    return catalog->getClassSchedules(ucCode, classCode);
+}
+
+/**
+ * @brief Get the number of students in each class of a UC.
+ *
+ * @param ucCode The code of the UC.
+ * @return A map of class codes to number of students, classes without students are absent.
+ *
+ * @complexity O(log U)
+ */
+const map<string, int>& DataContext::getClassOccupancy(const string& ucCode) const {
+    static const map<string, int> none;
+    auto it = classOccupancy.find(ucCode);
+    return it != classOccupancy.end() ? it->second : none;
+}
+
+/**
+ * @brief Get the students of a UC, from the index of the students of each UC.
+ *
+ * @param ucCode The code of the UC.
+ * @return A view of the students, empty if the UC doesn't exist.
+ *
+ * @complexity O(m), where m is the number of students of the UC, no student is read.
+ */
+StudentView DataContext::studentsInUc(const string& ucCode) const {
+    UcId ucId = getUcId(ucCode);
+    return makeView(ucId < ucStudents.size() ? ucStudents[ucId] : vector<StudentHandle>());
+}
+
+/**
+ * @brief Get the students of a class, in any of its UCs, from the index of the students of each class.
+ *
+ * @param classCode The code of the class.
+ * @return A view of the students, empty if the class doesn't exist.
+ *
+ * @complexity O(m), where m is the number of students of the class, no student is read.
+ */
+StudentView DataContext::studentsInClass(const string& classCode) const {
+    ClassId classId = getClassId(classCode);
+    return makeView(classId < classStudents.size() ? classStudents[classId] : vector<StudentHandle>());
+}
+
+/**
+ * @brief Get the students of a year, the union of the students of its classes.
+ *
+ * @param year The year, the first character of the codes of its classes.
+ * @return A view of the students.
+ *
+ * @complexity O(m log m), where m is the number of enrollments in the classes of the year, no student is read.
+ */
+StudentView DataContext::studentsInYear(char year) const {
+    vector<StudentHandle> handles;
+    for (size_t classId = 0; classId < classStudents.size(); classId++) {
+        const string& classCode = getClassCode((ClassId) classId);
+        if (!classCode.empty() && classCode[0] == year) {
+            handles.insert(handles.end(), classStudents[classId].begin(), classStudents[classId].end());
+        }
+    }
+    sort(handles.begin(), handles.end());
+    handles.erase(unique(handles.begin(), handles.end()), handles.end());
+    return makeView(std::move(handles));
+}
+
+/**
+ * @brief Get the students enrolled in at least a number of UCs, from the number of UCs of each student.
+ *
+ * @param n The minimum number of UCs.
+ * @return A view of the students.
+ *
+ * @complexity O(N), no student is read.
+ */
+StudentView DataContext::studentsInAtLeastNUcs(int n) const {
+    vector<StudentHandle> handles;
+    for (StudentHandle handle = 0; handle < studentUcCounts.size(); handle++) {
+        if ((int64_t) studentUcCounts[handle] >= n) {
+            handles.push_back(handle);
+        }
+    }
+    return makeView(std::move(handles));
+}
+
+/**
+ * @brief Get the students whose name contains a text, ignoring case, from the index of the names.
+ *
+ * @param searchName The text to search for.
+ * @return A view of the students.
+ *
+ * @complexity The search of the index of the names, only the names of the candidates are read.
+ */
+StudentView DataContext::studentsNamed(const string& searchName) const {
+    vector<StudentHandle> handles;
+    studentNames.search(searchName, handles);
+    return makeView(std::move(handles));
+}
+
+/**
+ * @brief Get the id of a UC code.
+ *
+ * @param ucCode The code of the UC.
+ * @return The id of the UC, or InvalidId if it is not in the catalog.
+ *
+ * @complexity O(1) on average
+ */
+UcId DataContext::getUcId(const string& ucCode) const {
+    return catalog->getUcId(ucCode);
+}
+
+/**
+ * @brief Get the code of a UC id.
+ *
+ * @param ucId The id of the UC.
+ * @return The code of the UC, empty if the id is not valid.
+ */
+const string& DataContext::getUcCode(UcId ucId) const {
+    return catalog->getUcCode(ucId);
+}
+
+/**
+ * @brief Get the id of a class code.
+ *
+ * @param classCode The code of the class.
+ * @return The id of the class, or InvalidId if it is not in the catalog.
+ *
+ * @complexity O(1) on average
+ */
+ClassId DataContext::getClassId(const string& classCode) const {
+    return catalog->getClassId(classCode);
+}
+
+/**
+ * @brief Get the code of a class id.
+ *
+ * @param classId The id of the class.
+ * @return The code of the class, empty if the id is not valid.
+ */
+const string& DataContext::getClassCode(ClassId classId) const {
+    return catalog->getClassCode(classId);
+}
+
+/**
+ * @brief Pack an enrollment as UC and class ids.
+ *
+ * @param classes The enrollment, as UC and class codes.
+ * @return The enrollment as ids, InvalidId for the codes that are not in the catalog.
+ *
+ * @complexity O(c) on average, where c is the number of classes.
+ */
+PackedEnrollment DataContext::pack(const vector<Class>& classes) const {
+    return catalog->pack(classes);
+}
+
+/**
+ * @brief Unpack an enrollment of UC and class ids.
+ *
+ * @param classes The enrollment, as ids.
+ * @return The enrollment as UC and class codes.
+ *
+ * @complexity O(c), where c is the number of classes.
+ */
+vector<Class> DataContext::unpack(const PackedEnrollment& classes) const {
+    return catalog->unpack(classes);
+}
+
+/**
+ * @brief Get the current node of a student, through the index of the students by code.
+ *
+ * The student itself must only be modified inside a WriteTransaction.
+ *
+ * @param studentCode The unique code of the student.
+ * @return Pointer to the Student object, or nullptr if not found.
+ *
+ * @complexity O(1) on average
+ */
+Student* DataContext::findStudent(const int& studentCode) {
+    auto it = studentsByCode.find(studentCode);
+    return it != studentsByCode.end() ? studentsByName[it->second] : nullptr;
+}
+
+/**
+ * @brief Get the number of committed write transactions.
+ *
+ * @return The current version of the data.
+ */
+unsigned long DataContext::getVersion() const {
+    return version;
+}
+
+/**
+ * @brief Add a function called after each commit with the students whose enrollment changed.
+ *
+ * After a bulk change every student is passed, as the tree itself may have been replaced. The
+ * observers are called in the order they were added.
+ *
+ * @param observer The function to call.
+ * @return The id of the observer, to remove it.
+ */
+size_t DataContext::addCommitObserver(function<void(const vector<const Student*>&)> observer) {
+    commitObservers.emplace(nextObserverId, std::move(observer));
+    return nextObserverId++;
+}
+
+/**
+ * @brief Stop calling an observer of the commits.
+ *
+ * @param id The id returned when the observer was added.
+ */
+void DataContext::removeCommitObserver(size_t id) {
+    commitObservers.erase(id);
+}
+
+/**
+ * @brief Opens a write transaction on a context.
+ *
+ * Only one transaction can be open at a time on the same context.
+ *
+ * @param context The DataContext to modify.
+ */
+WriteTransaction::WriteTransaction(DataContext& context) : context(context), finished(false), bulkChanged(false) {
+    if (context.writing) {
+        throw logic_error("A write transaction is already open on this context");
+    }
+    context.writing = true;
+}
+
+/**
+ * @brief Rolls back the transaction if it was neither committed nor rolled back.
+ */
+WriteTransaction::~WriteTransaction() {
+    if (!finished) {
+        rollback();
+    }
+}
+
+/**
+ * @brief Register a student that is going to be modified.
+ *
+ * The enrollment of the student is only recorded the first time it is edited in the transaction.
+ *
+ * @param student The Student object to modify.
+ * @return A reference to the same Student object.
+ */
+Student& WriteTransaction::edit(Student& student) {
+    originalClasses.emplace(&student, student.UcToClasses);
+    return student;
+}
+
+/**
+ * @brief Mutable access to the whole Students binary search tree.
+ *
+ * @return A reference to the StudentBST.
+ */
+StudentBST& WriteTransaction::students() {
+    bulkChanged = true;
+    return context.students;
+}
+
+/**
+ * @brief Check if any student was edited in this transaction.
+ *
+ * @return True if at least one student was edited, otherwise false.
+ */
+bool WriteTransaction::hasChanges() const {
+    return !originalClasses.empty();
+}
+
+/**
+ * @brief Get the enrollment before and after the transaction of the students it changed.
+ *
+ * @return The delta of each edited student whose enrollment is different.
+ *
+ * @complexity O(k), where k is the number of edited students.
+ */
+vector<StudentDelta> WriteTransaction::changes() const {
+    vector<StudentDelta> deltas;
+    for (const auto& it : originalClasses) {
+        if (!(it.second == it.first->UcToClasses)) {
+            deltas.push_back({it.first->StudentCode, context.pack(it.second), context.pack(it.first->UcToClasses)});
+        }
+    }
+    return deltas;
+}
+
+/**
+ * @brief Make the changes permanent, update the occupancy and close the transaction.
+ */
+void WriteTransaction::commit() {
+    if (finished) {
+        return;
+    }
+    vector<const Student*> changed;
+    if (bulkChanged) {
+        context.rebuildOccupancy();
+        context.rebuildStudentIndex();
+        context.students.forEachStudent([&changed](const Student& student) { changed.push_back(&student); });
+    } else {
+        for (const auto& it : originalClasses) {
+            context.updateOccupancy(it.second, it.first->UcToClasses);
+            context.updateStudentIndex(context.studentsByCode.at(it.first->StudentCode), it.second, it.first->UcToClasses);
+            if (!(it.second == it.first->UcToClasses)) {
+                changed.push_back(it.first);
+            }
+        }
+    }
+    context.version++;
+    context.writing = false;
+    finished = true;
+    if (!changed.empty()) {
+        for (const auto& observer : context.commitObservers) {
+            observer.second(changed);
+        }
+    }
+}
+
+/**
+ * @brief Restore every edited student to its original enrollment and close the transaction.
+ */
+void WriteTransaction::rollback() {
+    if (finished) {
+        return;
+    }
+    for (auto& it : originalClasses) {
+        it.first->UcToClasses = it.second;
+    }
+    originalClasses.clear();
+    // Bulk changes can't be undone, but the indexes must follow them
+    if (bulkChanged) {
+        context.rebuildOccupancy();
+        context.rebuildStudentIndex();
+    }
+    context.writing = false;
+    finished = true;
+}
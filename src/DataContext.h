@@ -0,0 +1,324 @@
+/**
+ * @file DataContext.h
+ * @brief Header file containing class definitions for DataContext and WriteTransaction.
+ */
+
+#ifndef PROJETO_AED_DATACONTEXT_H
+#define PROJETO_AED_DATACONTEXT_H
+
+#include "ReadData.h"
+#include "Catalog.h"
+#include "NameIndex.h"
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+
+/**
+ * @class DataContext
+ * @brief The single shared data context of the application.
+ *
+ * Script, System, Consult and Change all hold a shared pointer to the same DataContext,
+ * so reading the Classes, Schedules and Students never copies them. Every modification
+ * of the data goes through a WriteTransaction.
+ *
+ * The catalog is immutable and shared with the other contexts built on it (such as the roster
+ * of a past time), only the students and their occupancy belong to each context.
+ */
+class DataContext {
+private:
+    shared_ptr<const Catalog> catalog; ///< The catalog, shared by every context built on it.
+    StudentBST students;   ///< The roster of this context.
+    unsigned long version; ///< Incremented every time a WriteTransaction is committed.
+    bool writing;          ///< True while a WriteTransaction is open.
+
+    map<string, map<string, int>> classOccupancy; ///< The number of students in each class of each UC.
+    vector<Student*> studentsByName; ///< The students in name order, indexed by their handle.
+    vector<int> studentCodes;        ///< The code of each student, by handle.
+    vector<uint32_t> studentUcCounts; ///< The number of UCs each student is enrolled in, by handle.
+    unordered_map<int, StudentHandle> studentsByCode; ///< The handle of the student with each student code.
+    vector<vector<StudentHandle>> ucStudents;    ///< The sorted handles of the students of each UC, by UC id.
+    vector<vector<StudentHandle>> classStudents; ///< The sorted handles of the students of each class code in any UC, by class id.
+    NameIndex studentNames; ///< The index of the substrings of the names of the students.
+    map<size_t, function<void(const vector<const Student*>&)>> commitObservers; ///< Called with the students changed by each commit, by id.
+    size_t nextObserverId; ///< The id of the next observer added.
+
+    friend class WriteTransaction;
+
+    /**
+     * @brief Recount the number of students in each class from the Students binary search tree.
+     */
+    void rebuildOccupancy();
+
+    /**
+     * @brief Rebuild the indexes of the students (handles, codes, UCs, classes and names), the nodes change when the whole tree is replaced.
+     */
+    void rebuildStudentIndex();
+
+    /**
+     * @brief Move a student from the UCs and classes of one enrollment to the ones of another, in the indexes of the students.
+     * @param handle The handle of the student.
+     * @param oldClasses The enrollment of the student before the change.
+     * @param newClasses The enrollment of the student after the change.
+     */
+    void updateStudentIndex(StudentHandle handle, const vector<Class>& oldClasses, const vector<Class>& newClasses);
+
+    /**
+     * @brief Make a view of students from a list of handles of the indexes.
+     * @param handles The handles, sorted and without repetitions.
+     * @return The view, in name order.
+     */
+    StudentView makeView(vector<StudentHandle> handles) const;
+
+    /**
+     * @brief Move a student's contribution in the occupancy from one enrollment to another.
+     * @param oldClasses The enrollment of the student before the change.
+     * @param newClasses The enrollment of the student after the change.
+     */
+    void updateOccupancy(const vector<Class>& oldClasses, const vector<Class>& newClasses);
+
+public:
+    /**
+     * @brief Constructor for the DataContext class, with a new catalog.
+     * @param data The initial data of the context.
+     */
+    explicit DataContext(Global data);
+
+    /**
+     * @brief Constructor for the DataContext class, on an existing catalog.
+     * @param catalog The catalog, shared with the contexts built on it.
+     * @param students The roster of the context.
+     */
+    DataContext(shared_ptr<const Catalog> catalog, StudentBST students);
+
+    /**
+     * @brief Get the catalog, to build other contexts on it.
+     * @return A shared pointer to the catalog.
+     */
+    shared_ptr<const Catalog> getCatalog() const;
+
+    /**
+     * @brief Get the vector of Class objects.
+     * @return A constant reference to the Classes vector.
+     */
+    const vector<Class>& getClasses() const;
+
+    /**
+     * @brief Get the vector of Schedule objects.
+     * @return A constant reference to the Schedules vector.
+     */
+    const vector<Schedule>& getSchedules() const;
+
+    /**
+     * @brief Get the Students binary search tree.
+     * @return A constant reference to the StudentBST.
+     */
+    const StudentBST& getStudents() const;
+
+    /**
+     * @brief Get the codes of every UC in the catalog.
+     * @return The UC codes, in catalog order.
+     */
+    const vector<string>& getUcCodes() const;
+
+    /**
+     * @brief Get the class codes of a UC in the catalog.
+     * @param ucCode The code of the UC.
+     * @return The class codes of the UC, empty if the UC doesn't exist.
+     */
+    const vector<string>& getClassesOfUc(const string& ucCode) const;
+
+    /**
+     * @brief Get the schedules of a class of a UC.
+     * @param ucCode The code of the UC.
+     * @param classCode The code of the class.
+     * @return The schedules of the class, empty if the class doesn't exist.
+     */
+    const vector<Schedule>& getClassSchedules(const string& ucCode, const string& classCode) const;
+
+    /**
+     * @brief Get the number of students in each class of a UC.
+     *
+     * Equivalent to StudentBST::getStudentsCountInClass, but kept up to date on every commit,
+     * so it does not traverse the students.
+     *
+     * @param ucCode The code of the UC.
+     * @return A map of class codes to number of students, classes without students are absent.
+     */
+    const map<string, int>& getClassOccupancy(const string& ucCode) const;
+
+    /**
+     * @brief Get the students of a UC.
+     * @param ucCode The code of the UC.
+     * @return A view of the students, empty if the UC doesn't exist.
+     */
+    StudentView studentsInUc(const string& ucCode) const;
+
+    /**
+     * @brief Get the students of a class, in any of its UCs.
+     * @param classCode The code of the class.
+     * @return A view of the students, empty if the class doesn't exist.
+     */
+    StudentView studentsInClass(const string& classCode) const;
+
+    /**
+     * @brief Get the students of a year, the ones in a class of the year in any UC.
+     * @param year The year, the first character of the codes of its classes.
+     * @return A view of the students.
+     */
+    StudentView studentsInYear(char year) const;
+
+    /**
+     * @brief Get the students enrolled in at least a number of UCs.
+     * @param n The minimum number of UCs.
+     * @return A view of the students.
+     */
+    StudentView studentsInAtLeastNUcs(int n) const;
+
+    /**
+     * @brief Get the students whose name contains a text, ignoring case.
+     * @param searchName The text to search for.
+     * @return A view of the students.
+     */
+    StudentView studentsNamed(const string& searchName) const;
+
+    /**
+     * @brief Get the id of a UC code.
+     * @param ucCode The code of the UC.
+     * @return The id of the UC, or InvalidId if it is not in the catalog.
+     */
+    UcId getUcId(const string& ucCode) const;
+
+    /**
+     * @brief Get the code of a UC id.
+     * @param ucId The id of the UC.
+     * @return The code of the UC, empty if the id is not valid.
+     */
+    const string& getUcCode(UcId ucId) const;
+
+    /**
+     * @brief Get the id of a class code.
+     * @param classCode The code of the class.
+     * @return The id of the class, or InvalidId if it is not in the catalog.
+     */
+    ClassId getClassId(const string& classCode) const;
+
+    /**
+     * @brief Get the code of a class id.
+     * @param classId The id of the class.
+     * @return The code of the class, empty if the id is not valid.
+     */
+    const string& getClassCode(ClassId classId) const;
+
+    /**
+     * @brief Pack an enrollment as UC and class ids.
+     * @param classes The enrollment, as UC and class codes.
+     * @return The enrollment as ids, InvalidId for the codes that are not in the catalog.
+     */
+    PackedEnrollment pack(const vector<Class>& classes) const;
+
+    /**
+     * @brief Unpack an enrollment of UC and class ids.
+     * @param classes The enrollment, as ids.
+     * @return The enrollment as UC and class codes.
+     */
+    vector<Class> unpack(const PackedEnrollment& classes) const;
+
+    /**
+     * @brief Get the current node of a student, used to resolve change requests when they are processed.
+     *
+     * The pointer is only valid until the next write transaction that replaces the whole tree (e.g. an undo),
+     * so it must not be stored.
+     *
+     * @param studentCode The unique code of the student.
+     * @return Pointer to the Student object, or nullptr if not found.
+     */
+    Student* findStudent(const int& studentCode);
+
+    /**
+     * @brief Get the number of committed write transactions.
+     * @return The current version of the data.
+     */
+    unsigned long getVersion() const;
+
+    /**
+     * @brief Add a function called after each commit with the students whose enrollment changed.
+     * @param observer The function to call.
+     * @return The id of the observer, to remove it.
+     */
+    size_t addCommitObserver(function<void(const vector<const Student*>&)> observer);
+
+    /**
+     * @brief Stop calling an observer of the commits.
+     * @param id The id returned when the observer was added.
+     */
+    void removeCommitObserver(size_t id);
+};
+
+/**
+ * @class WriteTransaction
+ * @brief An explicit write transaction over a DataContext.
+ *
+ * Before a student is modified it must be registered with edit(), which records its original
+ * enrollment. The transaction is then either committed, making the changes permanent, or rolled
+ * back, restoring every edited student. A transaction that is destroyed without being committed
+ * is rolled back.
+ */
+class WriteTransaction {
+private:
+    DataContext& context;                          ///< The context being modified.
+    map<Student*, vector<Class>> originalClasses;  ///< The enrollment of each edited student before the transaction.
+    bool finished;                                 ///< True once the transaction was committed or rolled back.
+    bool bulkChanged;                              ///< True if the whole StudentBST was accessed for modification.
+
+public:
+    /**
+     * @brief Opens a write transaction on a context.
+     * @param context The DataContext to modify.
+     */
+    explicit WriteTransaction(DataContext& context);
+
+    WriteTransaction(const WriteTransaction&) = delete;
+    WriteTransaction& operator=(const WriteTransaction&) = delete;
+
+    /**
+     * @brief Rolls back the transaction if it was not finished.
+     */
+    ~WriteTransaction();
+
+    /**
+     * @brief Register a student that is going to be modified.
+     * @param student The Student object to modify.
+     * @return A reference to the same Student object.
+     */
+    Student& edit(Student& student);
+
+    /**
+     * @brief Mutable access to the whole Students binary search tree, used for bulk operations.
+     * @return A reference to the StudentBST.
+     */
+    StudentBST& students();
+
+    /**
+     * @brief Check if any student was edited in this transaction.
+     * @return True if at least one student was edited, otherwise false.
+     */
+    bool hasChanges() const;
+
+    /**
+     * @brief Get the enrollment before and after the transaction of the students it changed.
+     * @return The delta of each edited student whose enrollment is different.
+     */
+    vector<StudentDelta> changes() const;
+
+    /**
+     * @brief Make the changes permanent.
+     */
+    void commit();
+
+    /**
+     * @brief Restore every edited student to its original enrollment.
+     */
+    void rollback();
+};
+
+#endif //PROJETO_AED_DATACONTEXT_H
@@ -0,0 +1,359 @@
+/**
+ * @file JournalFile.cpp
+ * @brief Implementation of the JournalFile class.
+ */
+
+#include "JournalFile.h"
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief The size of the header of a record: the size and the checksum of its payload.
+ */
+static const size_t RecordHeaderSize = 2 * sizeof(uint32_t);
+
+/**
+ * @brief Frames a payload as a record: its size, its checksum and the payload itself.
+ *
+ * @param out The buffer the record is appended to.
+ * @param payload The payload of the record.
+ */
+static void putRecord(string& out, const string& payload) {
+    BinaryWriter writer(out);
+    writer.put<uint32_t>((uint32_t) payload.size());
+    writer.put<uint32_t>(crc32(payload.data(), payload.size()));
+    out.append(payload);
+}
+
+/**
+ * @brief Writes a whole buffer to a file, retrying on partial writes.
+ *
+ * @param fd The file descriptor.
+ * @param data The buffer.
+ * @return True if every byte was written, otherwise false.
+ */
+bool writeAll(int fd, const string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t result = ::write(fd, data.data() + written, data.size() - written);
+        if (result < 0) {
+            return false;
+        }
+        written += (size_t) result;
+    }
+    return true;
+}
+
+/**
+ * @brief Syncs the directory of a file, so that a file created or renamed in it survives a crash.
+ *
+ * @param path The path of the file.
+ */
+void syncDirectoryOf(const string& path) {
+    size_t slash = path.find_last_of('/');
+    string directory = slash == string::npos ? "." : path.substr(0, slash + 1);
+    int dirFd = ::open(directory.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+}
+
+/**
+ * @brief Replaces a file with the given content, through a synced temporary file and a rename.
+ *
+ * @param path The path of the file.
+ * @param data The new content of the file.
+ * @return True if the file was replaced, otherwise false.
+ */
+bool replaceFile(const string& path, const string& data) {
+    string temporaryPath = path + ".tmp";
+    int temporaryFd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (temporaryFd < 0) {
+        return false;
+    }
+    bool ok = writeAll(temporaryFd, data) && ::fdatasync(temporaryFd) == 0;
+    ::close(temporaryFd);
+    if (!ok || ::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        ::unlink(temporaryPath.c_str());
+        return false;
+    }
+    syncDirectoryOf(path);
+    return true;
+}
+
+/**
+ * @brief Constructor for the JournalFile class, the file is neither read nor created yet.
+ *
+ * @param path The path of the file.
+ * @param magic The 8 bytes that start a file of this format.
+ */
+JournalFile::JournalFile(string path, string magic)
+    : path(std::move(path)), magic(std::move(magic)), fd(-1), validMagic(false), torn(false), end(0),
+      appended(0), durable(0), writing(false), stopping(false), failed(false) {}
+
+/**
+ * @brief Destructor for the JournalFile class, the buffered records are written before the file is closed.
+ */
+JournalFile::~JournalFile() {
+    if (flusher.joinable()) {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wakeUp.notify_one();
+        flusher.join();
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+/**
+ * @brief Reads the file, if it exists, and finds its complete and valid records.
+ *
+ * @return The payloads of the records, in order, valid until open is called.
+ *
+ * @complexity O(n), where n is the size of the file.
+ */
+const vector<string_view>& JournalFile::load() {
+    contents.clear();
+    loaded.clear();
+    ifstream in(path, ios::binary | ios::ate);
+    if (in) {
+        contents.resize((size_t) in.tellg());
+        in.seekg(0);
+        in.read(&contents[0], (streamsize) contents.size());
+    }
+    in.close();
+
+    validMagic = contents.size() >= magic.size() && contents.compare(0, magic.size(), magic) == 0;
+    if (!contents.empty() && !validMagic) {
+        cerr << "ERROR: " << path << " is not in the expected format, a new one is started." << endl;
+    }
+    if (!validMagic) {
+        torn = false;
+        return loaded;
+    }
+
+    const char* data = contents.data();
+    size_t size = contents.size();
+    size_t offset = magic.size();
+    while (size - offset >= RecordHeaderSize) {
+        uint32_t payloadSize, checksum;
+        memcpy(&payloadSize, data + offset, sizeof(uint32_t));
+        memcpy(&checksum, data + offset + sizeof(uint32_t), sizeof(uint32_t));
+        const char* payload = data + offset + RecordHeaderSize;
+        if (payloadSize == 0 || payloadSize > size - offset - RecordHeaderSize || crc32(payload, payloadSize) != checksum) {
+            break;
+        }
+        loaded.emplace_back(payload, payloadSize);
+        offset += RecordHeaderSize + payloadSize;
+    }
+    torn = offset != size;
+    return loaded;
+}
+
+/**
+ * @brief Checks if the loaded file ends with an incomplete or corrupted record.
+ *
+ * @return True if the tail of the file was torn, otherwise false.
+ */
+bool JournalFile::tornTail() const {
+    return torn;
+}
+
+/**
+ * @brief Gets the offset of a loaded record in the file.
+ *
+ * @param payload The payload of the record, as returned by load.
+ * @return The offset of the start of the record, its header.
+ */
+uint64_t JournalFile::offsetOf(string_view payload) const {
+    return (uint64_t) (payload.data() - contents.data()) - RecordHeaderSize;
+}
+
+/**
+ * @brief Opens the file for appending and starts the flusher.
+ *
+ * A file that doesn't exist or isn't in the expected format is replaced by an empty one, otherwise
+ * it is cut after the kept records. The loaded content is released.
+ *
+ * @param keptRecords The number of loaded records to keep, the file is cut after them.
+ * @return True if the file was opened, otherwise false.
+ */
+bool JournalFile::open(size_t keptRecords) {
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    end = validMagic ? contents.size() : magic.size();
+    if (fd >= 0 && !validMagic) {
+        bool ok = ::ftruncate(fd, 0) == 0 && writeAll(fd, magic) && ::fdatasync(fd) == 0;
+        syncDirectoryOf(path);
+        if (!ok) {
+            ::close(fd);
+            fd = -1;
+        }
+    } else if (fd >= 0 && (torn || keptRecords < loaded.size())) {
+        end = magic.size();
+        if (keptRecords > 0) {
+            const string_view& last = loaded[min(keptRecords, loaded.size()) - 1];
+            end = (uint64_t) (last.data() + last.size() - contents.data());
+        }
+        if (::ftruncate(fd, (off_t) end) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    loaded.clear();
+    loaded.shrink_to_fit();
+    contents.clear();
+    contents.shrink_to_fit();
+
+    if (fd < 0) {
+        cerr << "ERROR: Could not open " << path << ", its records won't survive a restart." << endl;
+        failed = true;
+    }
+    flusher = thread(&JournalFile::flushLoop, this);
+    return fd >= 0;
+}
+
+/**
+ * @brief Appends a record to the buffer and wakes the flusher.
+ *
+ * @param payload The payload of the record.
+ * @return The offset the record will have in the file.
+ *
+ * @complexity O(p), where p is the size of the payload.
+ */
+uint64_t JournalFile::append(const string& payload) {
+    uint64_t offset;
+    {
+        lock_guard<mutex> guard(lock);
+        putRecord(buffer, payload);
+        appended++;
+        offset = end;
+        end += RecordHeaderSize + payload.size();
+    }
+    wakeUp.notify_one();
+    return offset;
+}
+
+/**
+ * @brief Reads back consecutive records that are already on the disk, with a single read.
+ *
+ * @param first The offset of the first record.
+ * @param last The offset of the last record.
+ * @param payloads The payloads of the records read, in order.
+ * @return True if every record from the first to the last one is complete and valid, otherwise false.
+ *
+ * @complexity O(b), where b is the number of bytes from the first record to the end of the last one.
+ */
+bool JournalFile::read(uint64_t first, uint64_t last, vector<string>& payloads) const {
+    int readFd = ::open(path.c_str(), O_RDONLY);
+    if (readFd < 0) {
+        return false;
+    }
+    uint32_t lastSize = 0;
+    bool ok = ::pread(readFd, &lastSize, sizeof(lastSize), (off_t) last) == (ssize_t) sizeof(lastSize);
+    string data;
+    if (ok && first <= last) {
+        data.resize((size_t) (last - first) + RecordHeaderSize + lastSize);
+        ok = ::pread(readFd, &data[0], data.size(), (off_t) first) == (ssize_t) data.size();
+    }
+    ::close(readFd);
+
+    size_t offset = 0;
+    while (ok && offset < data.size()) {
+        uint32_t payloadSize, checksum;
+        ok = data.size() - offset >= RecordHeaderSize;
+        if (ok) {
+            memcpy(&payloadSize, data.data() + offset, sizeof(uint32_t));
+            memcpy(&checksum, data.data() + offset + sizeof(uint32_t), sizeof(uint32_t));
+            const char* payload = data.data() + offset + RecordHeaderSize;
+            ok = payloadSize <= data.size() - offset - RecordHeaderSize && crc32(payload, payloadSize) == checksum;
+            if (ok) {
+                payloads.emplace_back(payload, payloadSize);
+                offset += RecordHeaderSize + payloadSize;
+            }
+        }
+    }
+    return ok && first <= last;
+}
+
+/**
+ * @brief Writes and syncs the buffer each time it has records, until the file is closed.
+ *
+ * The buffer is swapped out before the lock is released, so the records appended during a write
+ * and its sync are gathered in the next group.
+ */
+void JournalFile::flushLoop() {
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        wakeUp.wait(guard, [this]() { return stopping || !buffer.empty(); });
+        if (buffer.empty()) {
+            break; // stopping, with every record written
+        }
+        string group;
+        group.swap(buffer);
+        uint64_t groupEnd = appended;
+        bool skip = failed;
+        writing = true;
+
+        guard.unlock();
+        bool ok = skip || (writeAll(fd, group) && ::fdatasync(fd) == 0);
+        guard.lock();
+
+        if (!ok) {
+            failed = true;
+            cerr << "ERROR: Could not write to " << path << ", the next records won't survive a restart." << endl;
+        }
+        writing = false;
+        durable = groupEnd;
+        flushed.notify_all();
+    }
+}
+
+/**
+ * @brief Waits until every record appended so far is on the disk.
+ *
+ * Several threads waiting at the same time are released by the same sync.
+ */
+void JournalFile::sync() {
+    unique_lock<mutex> guard(lock);
+    uint64_t target = appended;
+    flushed.wait(guard, [this, target]() { return durable >= target; });
+}
+
+/**
+ * @brief Replaces the file with the given records, once the buffered records were written.
+ *
+ * @param payloads The payloads of the records of the new file.
+ * @return True if the file was replaced, otherwise false.
+ *
+ * @complexity O(p), where p is the size of the payloads.
+ */
+bool JournalFile::rewrite(const vector<string>& payloads) {
+    unique_lock<mutex> guard(lock);
+    flushed.wait(guard, [this]() { return buffer.empty() && !writing; });
+    if (fd < 0) {
+        return false;
+    }
+
+    string data = magic;
+    for (const string& payload : payloads) {
+        putRecord(data, payload);
+    }
+    if (!replaceFile(path, data)) {
+        return false;
+    }
+    int newFd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+    if (newFd < 0) {
+        return false;
+    }
+    ::close(fd);
+    fd = newFd;
+    end = data.size();
+    return true;
+}
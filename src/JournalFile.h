@@ -0,0 +1,154 @@
+/**
+ * @file JournalFile.h
+ * @brief Header file for the JournalFile class.
+ */
+
+#ifndef PROJETO_AED_JOURNALFILE_H
+#define PROJETO_AED_JOURNALFILE_H
+
+#include "BinaryIO.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <string_view>
+#include <condition_variable>
+
+/**
+ * @class JournalFile
+ * @brief An append-only file of checksummed records, synced to the disk in groups.
+ *
+ * The file starts with an 8 byte magic identifying its format, followed by records written as
+ * [payload size][CRC-32 of the payload][payload]. The meaning of the payloads is left to the owner.
+ *
+ * The file is first loaded, giving the payload of every complete and valid record; the first
+ * incomplete or corrupted record can only be the tail of a write interrupted by a crash. It is then
+ * opened, which cuts the file after the records the owner accepted. Records are appended to a buffer
+ * in memory and a background thread writes and syncs the buffer: the records appended while a sync is
+ * running are written together by the next one (group commit), so a burst of records costs a few
+ * syncs instead of one each.
+ */
+class JournalFile {
+private:
+    string path;                  ///< The path of the file.
+    string magic;                 ///< The first 8 bytes of the file.
+    int fd;                       ///< The file descriptor, -1 before open or if the file couldn't be opened.
+    string contents;              ///< The content of the file while it is loaded.
+    vector<string_view> loaded;   ///< The payloads of the valid records of the loaded file.
+    bool validMagic;              ///< True if the loaded file starts with the magic.
+    bool torn;                    ///< True if the loaded file ends with an incomplete or corrupted record.
+    uint64_t end;                 ///< The offset of the end of the file, once every appended record is written.
+
+    mutex lock;                   ///< Protects the buffer and the counters shared with the flusher.
+    condition_variable wakeUp;    ///< Signals the flusher that there are records to write or that the file is closing.
+    condition_variable flushed;   ///< Signals the writers that a group of records reached the disk.
+    string buffer;                ///< The records appended and not yet written.
+    uint64_t appended;            ///< The number of records appended.
+    uint64_t durable;             ///< The number of records written and synced.
+    bool writing;                 ///< True while the flusher writes a group without holding the lock.
+    bool stopping;                ///< True when the file is being closed.
+    bool failed;                  ///< True after a write error, the following records are dropped.
+    thread flusher;               ///< Writes and syncs the buffered records.
+
+    /**
+     * @brief Write and sync the buffer each time it has records, until the file is closed.
+     */
+    void flushLoop();
+
+public:
+    /**
+     * @brief Constructor for the JournalFile class, the file is neither read nor created yet.
+     * @param path The path of the file.
+     * @param magic The 8 bytes that start a file of this format.
+     */
+    JournalFile(string path, string magic);
+
+    /**
+     * @brief Destructor for the JournalFile class, writes the remaining records and closes the file.
+     */
+    ~JournalFile();
+
+    JournalFile(const JournalFile&) = delete;
+    JournalFile& operator=(const JournalFile&) = delete;
+
+    /**
+     * @brief Read the file, if it exists.
+     * @return The payloads of its complete and valid records, in order, valid until open is called.
+     */
+    const vector<string_view>& load();
+
+    /**
+     * @brief Check if the loaded file ends with an incomplete or corrupted record.
+     * @return True if the tail of the file was torn, otherwise false.
+     */
+    bool tornTail() const;
+
+    /**
+     * @brief Get the offset of a loaded record in the file.
+     * @param payload The payload of the record, as returned by load.
+     * @return The offset of the start of the record.
+     */
+    uint64_t offsetOf(string_view payload) const;
+
+    /**
+     * @brief Open the file for appending, keeping only the first loaded records.
+     * @param keptRecords The number of loaded records to keep, the file is cut after them.
+     * @return True if the file was opened, otherwise false.
+     */
+    bool open(size_t keptRecords);
+
+    /**
+     * @brief Append a record to the buffer and wake the flusher.
+     * @param payload The payload of the record.
+     * @return The offset the record will have in the file.
+     */
+    uint64_t append(const string& payload);
+
+    /**
+     * @brief Read back consecutive records that are already on the disk.
+     * @param first The offset of the first record.
+     * @param last The offset of the last record.
+     * @param payloads The payloads of the records read, in order.
+     * @return True if every record from the first to the last one is complete and valid, otherwise false.
+     */
+    bool read(uint64_t first, uint64_t last, vector<string>& payloads) const;
+
+    /**
+     * @brief Wait until every record appended so far is on the disk.
+     */
+    void sync();
+
+    /**
+     * @brief Replace the file with the given records.
+     *
+     * The new file is written and synced to a temporary file that then replaces the file, so a crash
+     * leaves either the old records or the new ones. Appends wait until the file is replaced.
+     *
+     * @param payloads The payloads of the records of the new file.
+     * @return True if the file was replaced, otherwise false.
+     */
+    bool rewrite(const vector<string>& payloads);
+};
+
+/**
+ * @brief Writes a whole buffer to a file, retrying on partial writes.
+ * @param fd The file descriptor.
+ * @param data The buffer.
+ * @return True if every byte was written, otherwise false.
+ */
+bool writeAll(int fd, const string& data);
+
+/**
+ * @brief Syncs the directory of a file, so that a file created or renamed in it survives a crash.
+ * @param path The path of the file.
+ */
+void syncDirectoryOf(const string& path);
+
+/**
+ * @brief Replaces a file with the given content, through a synced temporary file and a rename.
+ * @param path The path of the file.
+ * @param data The new content of the file.
+ * @return True if the file was replaced, otherwise false.
+ */
+bool replaceFile(const string& path, const string& data);
+
+#endif //PROJETO_AED_JOURNALFILE_H
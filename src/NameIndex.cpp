@@ -0,0 +1,124 @@
+/**
+ * @file NameIndex.cpp
+ * @brief Implementation of the NameIndex class.
+ */
+
+#include "NameIndex.h"
+#include "UtilityFunctions.h"
+#include <algorithm>
+#include <numeric>
+#include <string_view>
+
+/**
+ * @brief Get the key of a substring of one to three characters.
+ *
+ * @param text The text the substring is in.
+ * @param start The position of the substring.
+ * @param length The length of the substring, from 1 to 3.
+ * @return The key, its length in the high byte and its characters in the others.
+ */
+uint32_t NameIndex::key(const string& text, size_t start, size_t length) {
+    uint32_t result = (uint32_t) length << 24;
+    for (size_t i = 0; i < length; i++) {
+        result |= (uint32_t) (unsigned char) text[start + i] << (16 - 8 * i);
+    }
+    return result;
+}
+
+/**
+ * @brief Build the index of the names of the students.
+ *
+ * The students are visited in handle order, so each list is built sorted, and a substring found
+ * twice in the same name adds its student once.
+ *
+ * @param students The students, by handle.
+ *
+ * @complexity O(N L), where L is the length of the names.
+ */
+void NameIndex::build(const vector<Student*>& students) {
+    loweredNames.clear();
+    nameOffsets.clear();
+    grams.clear();
+    nameOffsets.reserve(students.size() + 1);
+    for (StudentHandle handle = 0; handle < students.size(); handle++) {
+        string name = ToLower(students[handle]->StudentName);
+        nameOffsets.push_back((uint32_t) loweredNames.size());
+        loweredNames += name;
+        for (size_t length = 1; length <= 3; length++) {
+            for (size_t start = 0; start + length <= name.size(); start++) {
+                vector<StudentHandle>& list = grams[key(name, start, length)];
+                if (list.empty() || list.back() != handle) {
+                    list.push_back(handle);
+                }
+            }
+        }
+    }
+    nameOffsets.push_back((uint32_t) loweredNames.size());
+}
+
+/**
+ * @brief Find the students whose name contains a text, ignoring case.
+ *
+ * Up to three characters, the text is a key of the index and its list is the result. Longer, the
+ * lists of its trigrams are intersected, starting from the shortest one and looking each candidate up
+ * in the next list by galloping (exponential and then binary search) from the previous position, and the names of the candidates left
+ * are checked, as having every trigram of the text doesn't mean having them in the same order.
+ *
+ * @param searchName The text to search for.
+ * @param handles Receives the handles of the students, in name order.
+ *
+ * @complexity O(r) up to three characters, where r is the number of results; otherwise O(c log m) to
+ * intersect the lists, where c is the length of the shortest list and m of the longest, and O(c' L) to
+ * check the c' candidates left.
+ */
+void NameIndex::search(const string& searchName, vector<StudentHandle>& handles) const {
+    handles.clear();
+    string searchNameLowered = ToLower(searchName);
+    if (searchNameLowered.empty()) {
+        handles.resize(nameOffsets.empty() ? 0 : nameOffsets.size() - 1);
+        iota(handles.begin(), handles.end(), 0);
+        return;
+    }
+
+    size_t length = min(searchNameLowered.size(), (size_t) 3);
+    vector<const vector<StudentHandle>*> lists;
+    for (size_t start = 0; start + length <= searchNameLowered.size(); start++) {
+        auto it = grams.find(key(searchNameLowered, start, length));
+        if (it == grams.end()) {
+            return;
+        }
+        lists.push_back(&it->second);
+    }
+    sort(lists.begin(), lists.end(), [](const vector<StudentHandle>* a, const vector<StudentHandle>* b) {
+        return a->size() < b->size();
+    });
+    lists.erase(unique(lists.begin(), lists.end()), lists.end());
+
+    handles = *lists[0];
+    if (searchNameLowered.size() <= 3) {
+        return;
+    }
+    for (size_t i = 1; i < lists.size() && !handles.empty(); i++) {
+        auto position = lists[i]->begin();
+        size_t kept = 0;
+        for (StudentHandle handle : handles) {
+            // Gallop from the previous position, the next candidate is usually close to it
+            size_t step = 1;
+            while ((size_t) (lists[i]->end() - position) > step && position[step] < handle) {
+                step *= 2;
+            }
+            position = lower_bound(position + step / 2, position + min(step + 1, (size_t) (lists[i]->end() - position)), handle);
+            if (position == lists[i]->end()) {
+                break;
+            }
+            if (*position == handle) {
+                handles[kept++] = handle;
+            }
+        }
+        handles.resize(kept);
+    }
+    string_view names(loweredNames);
+    handles.erase(remove_if(handles.begin(), handles.end(), [this, names, &searchNameLowered](StudentHandle handle) {
+        return names.substr(nameOffsets[handle], nameOffsets[handle + 1] - nameOffsets[handle]).find(searchNameLowered) == string_view::npos;
+    }), handles.end());
+}
@@ -0,0 +1,56 @@
+/**
+ * @file NameIndex.h
+ * @brief Header file for the NameIndex class.
+ */
+
+#ifndef PROJETO_AED_NAMEINDEX_H
+#define PROJETO_AED_NAMEINDEX_H
+
+#include "StudentView.h"
+#include <unordered_map>
+
+/**
+ * @class NameIndex
+ * @brief An index of the substrings of the names of the students, to search them by part of the name.
+ *
+ * The names are lowered once, when the index is built, and kept one after the other in a single
+ * string, so checking the names of the candidates reads memory in order. Every substring of one to three characters
+ * of a lowered name (its unigrams, bigrams and trigrams) lists the handles of the students whose name has
+ * it, in handle order, i.e. in name order. A search for up to three characters is then the list of that
+ * substring itself. A longer search intersects the lists of its trigrams, from the shortest one, and only
+ * checks the names of the students left, so it reads the candidates and nothing else.
+ *
+ * The characters are the bytes of the names, lowered as ToLower does, so a search ignores the case of
+ * the ASCII letters only, as StudentBST::searchAllByName.
+ */
+class NameIndex {
+private:
+    string loweredNames;          ///< The lowered names of the students, one after the other in handle order.
+    vector<uint32_t> nameOffsets; ///< The position of the lowered name of each student, by handle, and the end of the last one.
+    unordered_map<uint32_t, vector<StudentHandle>> grams; ///< The handles of the students whose name has each substring, by key.
+
+    /**
+     * @brief Get the key of a substring of one to three characters.
+     * @param text The text the substring is in.
+     * @param start The position of the substring.
+     * @param length The length of the substring, from 1 to 3.
+     * @return The key, its length and its characters.
+     */
+    static uint32_t key(const string& text, size_t start, size_t length);
+
+public:
+    /**
+     * @brief Build the index of the names of the students.
+     * @param students The students, by handle.
+     */
+    void build(const vector<Student*>& students);
+
+    /**
+     * @brief Find the students whose name contains a text, ignoring case.
+     * @param searchName The text to search for.
+     * @param handles Receives the handles of the students, in name order.
+     */
+    void search(const string& searchName, vector<StudentHandle>& handles) const;
+};
+
+#endif //PROJETO_AED_NAMEINDEX_H
@@ -4,6 +4,7 @@
  */
 
 #include "ReadData.h"
+#include "DataContext.h"
 
 /**
  * @brief Initializes the ReadData class by reading data from CSV files.
@@ -186,124 +187,356 @@ StudentBST ReadData::ReadStudents(const string studentCsv){
 }
 
 /**
- * @brief Default constructor for the System class.
+ * @brief Computes the memory used by the deltas and the ids of a change of the undo history.
+ *
+ * @param change The change.
+ * @return The memory of the deltas and the ids of the change, in bytes.
+ *
+ * @complexity O(k), where k is the number of students changed.
+ */
+static size_t deltaBytes(const ChangeDelta& change) {
+    size_t bytes = change.idRuns.capacity() * sizeof(pair<size_t, size_t>) + change.students.capacity() * sizeof(StudentDelta);
+    for (const StudentDelta& delta : change.students) {
+        bytes += (delta.before.capacity() + delta.after.capacity()) * sizeof(pair<UcId, ClassId>);
+    }
+    return bytes;
+}
+
+/**
+ * @brief Appends the ids of a change to a list.
  *
- * This constructor initializes the System object by reading data from external sources and saving the current state.
+ * @param change The change.
+ * @param ids The list the ids are appended to.
+ * @param newestFirst True to append them from the newest to the oldest, false for the opposite order.
  */
-System::System() {
-    ReadData dataReader;
-    Classes = dataReader.global.Classes;
-    Schedules = dataReader.global.Schedules;
-    Students = dataReader.global.Students;
-    saveCurrentState();
+static void appendIds(const ChangeDelta& change, vector<size_t>& ids, bool newestFirst) {
+    if (newestFirst) {
+        for (auto run = change.idRuns.rbegin(); run != change.idRuns.rend(); run++) {
+            for (size_t id = run->second + 1; id-- > run->first;) {
+                ids.push_back(id);
+            }
+        }
+    } else {
+        for (const auto& run : change.idRuns) {
+            for (size_t id = run.first; id <= run.second; id++) {
+                ids.push_back(id);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Squashes consecutive changes into a checkpoint.
+ *
+ * The deltas of the checkpoint and of the changes are sorted by student code, keeping their order for
+ * a same student, so that each student is merged in a single pass: it keeps the enrollment before its
+ * first delta and takes the one after its last delta, and is dropped if the two are equal, as the
+ * changes cancel out for it. The ids of the changes are appended to the runs of the checkpoint,
+ * extending its last run if they follow it.
+ *
+ * @param checkpoint The checkpoint, applied right before the changes.
+ * @param first The first change squashed.
+ * @param last The end of the changes squashed.
+ *
+ * @complexity O(m log m), where m is the number of deltas of the checkpoint and of the changes.
+ */
+static void squash(ChangeDelta& checkpoint, vector<ChangeDelta>::iterator first, vector<ChangeDelta>::iterator last) {
+    vector<StudentDelta> deltas = std::move(checkpoint.students);
+    for (auto change = first; change != last; change++) {
+        move(change->students.begin(), change->students.end(), back_inserter(deltas));
+        for (const auto& run : change->idRuns) {
+            if (!checkpoint.idRuns.empty() && checkpoint.idRuns.back().second + 1 == run.first) {
+                checkpoint.idRuns.back().second = run.second;
+            } else {
+                checkpoint.idRuns.push_back(run);
+            }
+        }
+    }
+    stable_sort(deltas.begin(), deltas.end(), [](const StudentDelta& a, const StudentDelta& b) { return a.studentCode < b.studentCode; });
+
+    vector<StudentDelta> merged;
+    for (size_t i = 0, j = 0; i < deltas.size(); i = j) {
+        while (j < deltas.size() && deltas[j].studentCode == deltas[i].studentCode) {
+            j++;
+        }
+        if (!(deltas[i].before == deltas[j - 1].after)) {
+            merged.push_back({deltas[i].studentCode, std::move(deltas[i].before), std::move(deltas[j - 1].after)});
+        }
+    }
+    merged.shrink_to_fit();
+    checkpoint.students = std::move(merged);
+    checkpoint.idRuns.shrink_to_fit();
 }
 
+/**
+ * @brief Default constructor for the System class.
+ *
+ * This constructor initializes the System object by reading data from external sources, with an empty undo history.
+ */
+System::System() : System(make_shared<DataContext>(ReadData().global)) {}
+
 /**
  * @brief Parameterized constructor for the System class.
  *
- * This constructor initializes the System object with the provided data and saves the current state.
+ * This constructor initializes the System object with the shared data context and an empty undo history.
  *
- * @param data A Global object containing data to initialize the System.
+ * @param context The shared data context the system operates on.
+ * @param historyBudget The maximum memory of the undo history, in bytes.
  */
-System::System(Global data) {
-    Classes = data.Classes;
-    Schedules = data.Schedules;
-    Students = data.Students;
-    saveCurrentState();
+System::System(shared_ptr<DataContext> context, size_t historyBudget)
+    : context(std::move(context)), applied(0), nextChangeId(0), historyBudget(historyBudget), historyBytes(0), checkpointed(false) {}
+
+/**
+ * @brief Retrieves the shared data context.
+ *
+ * @return A shared pointer to the DataContext.
+ */
+shared_ptr<DataContext> System::getContext() {
+    return context;
 }
 
 /**
- * @brief Recursively deep copies a StudentBST.
+ * @brief Applies a change, or its inverse, to the students it changed.
+ *
+ * Each student must still have the enrollment the change left (to undo it) or found (to redo it),
+ * which holds as long as every change of the roster is recorded.
  *
- * This function recursively creates a deep copy of the given StudentBST and stores it in the provided 'copy' StudentBST object.
+ * @param transaction The write transaction.
+ * @param change The change.
+ * @param forward True to redo the change, false to undo it.
+ * @return True if every student of the change was in the expected state, otherwise false.
  *
- * @param currentNode The current node to copy.
- * @param copy The StudentBST object to copy into.
+ * @complexity O(k), where k is the number of students changed, independent of the size of the roster.
  */
-void System::deepCopyStudentBST(Node* currentNode, StudentBST& copy) {
-    if (currentNode == nullptr) {
-        return;
+bool System::apply(WriteTransaction& transaction, const ChangeDelta& change, bool forward) {
+    for (const StudentDelta& delta : change.students) {
+        Student* student = context->findStudent(delta.studentCode);
+        const PackedEnrollment& expected = forward ? delta.before : delta.after;
+        if (student == nullptr || !(context->pack(student->UcToClasses) == expected)) {
+            return false;
+        }
+        transaction.edit(*student).UcToClasses = context->unpack(forward ? delta.after : delta.before);
     }
+    return true;
+}
 
-    // Insert the student into the copy
-    copy.insertStudent(currentNode->data.StudentCode, currentNode->data.StudentName, currentNode->data.UcToClasses);
-
-    // Recursively copy the left and right subtrees
-    deepCopyStudentBST(currentNode->left, copy);
-    deepCopyStudentBST(currentNode->right, copy);
+/**
+ * @brief Drops the changes of the history from a position on.
+ *
+ * @param position The position of the first change dropped.
+ */
+void System::truncateHistory(size_t position) {
+    for (size_t i = position; i < history.size(); i++) {
+        historyBytes -= deltaBytes(history[i]);
+    }
+    history.erase(history.begin() + (long) position, history.end());
+    applied = min(applied, position);
+    checkpointed = checkpointed && position > 0;
 }
 
 /**
- * @brief Saves the current state by creating deep copies of the data.
+ * @brief Squashes the oldest changes into the checkpoint until the history fits in the budget.
+ *
+ * The undone changes are dropped first. Then the oldest changes after the checkpoint are squashed into
+ * it, as many as needed for the history to use at most three quarters of the budget, so that the next
+ * changes are recorded without squashing again. As the checkpoint holds at most one delta per student,
+ * it can only exceed the budget if the budget is smaller than a change of the whole roster; if only the
+ * checkpoint is left and it still doesn't fit, it is dropped.
+ *
+ * @complexity O(m log m), where m is the number of deltas squashed, amortized over the changes recorded since the last squash.
  */
-void System::saveCurrentState() {
-    // Create a deep copy of the StudentBST
-    StudentBST copiedStudents;
-    deepCopyStudentBST(Students.getRoot(), copiedStudents);
+void System::enforceBudget() {
+    if (historyMemory() <= historyBudget) {
+        return;
+    }
+    truncateHistory(applied);
+    size_t target = historyBudget - historyBudget / 4;
+    while (historyMemory() > target && applied > 1) {
+        size_t next = 1, squashedBytes = 0;
+        while (next < applied && historyMemory() - squashedBytes > target) {
+            squashedBytes += deltaBytes(history[next++]);
+        }
+        historyBytes -= deltaBytes(history[0]) + squashedBytes;
+        squash(history[0], history.begin() + 1, history.begin() + (long) next);
+        historyBytes += deltaBytes(history[0]);
+        history.erase(history.begin() + 1, history.begin() + (long) next);
+        history.shrink_to_fit();
+        applied = history.size();
+        checkpointed = true;
+    }
+    if (historyMemory() > target && applied == 1) {
+        truncateHistory(0);
+        history.shrink_to_fit();
+    }
+}
 
-    // Push the deep copies onto the undoStack
-    undoStack.push(copiedStudents);
+/**
+ * @brief Records a committed change in the undo history.
+ *
+ * The changes that were undone are dropped, as they no longer follow the current state. If the
+ * history then exceeds its memory budget, its oldest changes are squashed.
+ *
+ * @param transaction The committed write transaction.
+ * @return The id of the change, or NoChange if the transaction didn't change any student.
+ *
+ * @complexity O(k log k), where k is the number of students changed, amortized over the squashes.
+ */
+size_t System::recordChange(const WriteTransaction& transaction) {
+    vector<StudentDelta> students = transaction.changes();
+    if (students.empty()) {
+        return NoChange;
+    }
+    sort(students.begin(), students.end(), [](const StudentDelta& a, const StudentDelta& b) { return a.studentCode < b.studentCode; });
+    truncateHistory(applied);
+    size_t changeId = nextChangeId++;
+    history.push_back({{{changeId, changeId}}, std::move(students)});
+    historyBytes += deltaBytes(history.back());
+    applied++;
+    enforceBudget();
+    return changeId;
 }
 
 /**
- * @brief Updates the System's data with new Global data.
+ * @brief Undoes the last applied change, by writing back the enrollment its students had before it.
  *
- * This function updates the System's data with the provided Global data.
+ * @return The ids of the undone changes, newest first, empty if there is no change to undo.
  *
- * @param global A Global object containing new data.
+ * @complexity O(k), where k is the number of students changed.
  */
-void System::updateData(Global global){
-    Classes = global.Classes;
-    Schedules = global.Schedules;
-    Students = global.Students;
+vector<size_t> System::undoAction() {
+    if (applied == 0) {
+        return {};
+    }
+    return undoTo(history[applied - 1].idRuns.back().second);
 }
 
 /**
- * @brief Undoes the last action by restoring the previous state.
+ * @brief Redoes the last undone change, by writing again the enrollment its students had after it.
+ *
+ * @return The ids of the redone changes, oldest first, empty if there is no change to redo.
  *
- * This function removes the previous state from the undoStack and restores the System's data to that previous state.
+ * @complexity O(k), where k is the number of students changed.
  */
-void System::undoAction() {
-    if (!undoStack.empty()) {
-        undoStack.pop();  // Remove the previous state from the stack
+vector<size_t> System::redoAction() {
+    vector<size_t> redone;
+    if (applied == history.size()) {
+        return redone;
+    }
+    WriteTransaction transaction(*context);
+    if (!apply(transaction, history[applied], true)) {
+        transaction.rollback();
+        return redone;
+    }
+    transaction.commit();
+    appendIds(history[applied++], redone, false);
+    return redone;
+}
 
-        // Get the root of the StudentBST from the previous state
-        Node* previousRoot = undoStack.top().getRoot();
+/**
+ * @brief Undoes a change and every change applied after it, newest first, in a single transaction.
+ *
+ * @param changeId The id of the oldest change to undo.
+ * @return The ids of the undone changes, newest first, empty if the change isn't applied.
+ *
+ * @complexity O(k), where k is the number of students changed by the undone changes.
+ */
+vector<size_t> System::undoTo(size_t changeId) {
+    vector<size_t> undone;
+    if (!isApplied(changeId)) {
+        return undone;
+    }
+    WriteTransaction transaction(*context);
+    size_t position = applied;
+    while (position > 0 && history[position - 1].idRuns.back().second >= changeId) {
+        if (!apply(transaction, history[position - 1], false)) {
+            transaction.rollback();
+            return {};
+        }
+        appendIds(history[--position], undone, true);
+    }
+    transaction.commit();
+    applied = position;
+    return undone;
+}
 
-        // Update the current Students object's root to the previous root
-        Students.setRoot(previousRoot);
+/**
+ * @brief Checks if a change is applied, by binary search on the ids of the applied changes and then on the runs of ids of the one found.
+ *
+ * @param changeId The id of the change.
+ * @return True if the change is applied, otherwise false.
+ *
+ * @complexity O(log n + log r), where n is the number of applied changes and r the number of runs of ids of the checkpoint.
+ */
+bool System::isApplied(size_t changeId) const {
+    auto end = history.begin() + (long) applied;
+    auto change = lower_bound(history.begin(), end, changeId,
+                              [](const ChangeDelta& change, size_t id) { return change.idRuns.back().second < id; });
+    if (change == end) {
+        return false;
     }
+    auto run = lower_bound(change->idRuns.begin(), change->idRuns.end(), changeId,
+                           [](const pair<size_t, size_t>& run, size_t id) { return run.second < id; });
+    return run != change->idRuns.end() && run->first <= changeId;
 }
 
 /**
- * @brief Retrieves the classes data.
+ * @brief Sets the memory budget of the undo history, squashing it if it no longer fits.
  *
- * This function returns the vector of Class objects representing class data.
+ * @param budget The maximum memory of the history, in bytes.
+ */
+void System::setHistoryBudget(size_t budget) {
+    historyBudget = budget;
+    enforceBudget();
+}
+
+/**
+ * @brief Retrieves the memory budget of the undo history.
  *
- * @return A vector of Class objects.
+ * @return The maximum memory of the history, in bytes.
  */
-vector<Class> System::get_Classes() {
-    return Classes;
+size_t System::getHistoryBudget() const {
+    return historyBudget;
 }
 
 /**
- * @brief Retrieves the schedules data.
+ * @brief Retrieves the memory used by the undo history.
  *
- * This function returns the vector of Schedule objects representing schedule data.
+ * @return The memory of the history, in bytes.
+ */
+size_t System::historyMemory() const {
+    return historyBytes + history.capacity() * sizeof(ChangeDelta);
+}
+
+/**
+ * @brief Counts the changes that can be undone.
  *
- * @return A vector of Schedule objects.
+ * @return The number of applied changes in the history, including the ones squashed in the checkpoint.
+ *
+ * @complexity O(n + r), where n is the number of applied changes and r the number of runs of ids of the checkpoint.
  */
-vector<Schedule> System::get_Schedules() {
-    return Schedules;
+size_t System::historyDepth() const {
+    size_t depth = 0;
+    for (size_t i = 0; i < applied; i++) {
+        for (const auto& run : history[i].idRuns) {
+            depth += run.second - run.first + 1;
+        }
+    }
+    return depth;
 }
 
 /**
- * @brief Retrieves the students data.
+ * @brief Counts the changes squashed in the checkpoint.
  *
- * This function returns the StudentBST object representing student data.
+ * @return The number of changes in the checkpoint, 0 if there is none.
  *
- * @return A StudentBST object.
+ * @complexity O(r), where r is the number of runs of ids of the checkpoint.
  */
-StudentBST System::get_Students() {
-    return Students;
-}
\ No newline at end of file
+size_t System::checkpointDepth() const {
+    size_t depth = 0;
+    if (checkpointed) {
+        for (const auto& run : history[0].idRuns) {
+            depth += run.second - run.first + 1;
+        }
+    }
+    return depth;
+}
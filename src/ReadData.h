@@ -9,6 +9,7 @@
 #include "Data.h"
 #include "UtilityFunctions.h"
 #include <list>
+#include <memory>
 #include <sstream>
 #include <unordered_map>
 #include <variant>
@@ -23,21 +24,75 @@ struct Global {
     StudentBST Students;        ///< A binary search tree for storing Student objects.
 };
 
+class DataContext;
+class WriteTransaction;
+
+/**
+ * @brief The id given to change log entries that have no change in the undo history.
+ */
+const size_t NoChange = SIZE_MAX;
+
+/**
+ * @enum RequestType
+ * @brief The types of the change requests, as recorded in the change logs.
+ */
+enum class RequestType : uint8_t {
+    ChangeClass,      ///< Change the class of a UC.
+    ChangeUc,         ///< Change a UC and its class.
+    LeaveUcAndClass,  ///< Leave a UC and its class.
+    JoinUcAndClass,   ///< Join a UC, in a class with vacancy.
+    SwapClass         ///< Swap the class of a UC with another student.
+};
+
+/**
+ * @brief The number of request types.
+ */
+const size_t RequestTypeCount = 5;
+
+/**
+ * @enum LogReason
+ * @brief The reason recorded in a change log entry: why its request was denied or how its state came to be.
+ */
+enum class LogReason : uint8_t {
+    None,                    ///< Accepted, without anything to note.
+    AlreadyEnrolled,         ///< The student is already in the new class or UC.
+    NotEnrolled,             ///< The student is not in the class or UC to change.
+    CapacityExceeded,        ///< The new class would exceed its capacity.
+    BalanceDisturbed,        ///< The balance between the classes of the UC would be disturbed.
+    ScheduleConflict,        ///< The new schedule would have overlapping classes.
+    MaxUcsExceeded,          ///< The student would be registered in more than 7 UCs.
+    NoVacancy,               ///< No class of the new UC has vacancy.
+    AcceptedInCycle,         ///< Accepted in a cycle of class changes.
+    ReversedByAdministrator, ///< The accepted change was undone by the administrator.
+    RestoredByAdministrator  ///< The undone change was redone by the administrator.
+};
+
+/**
+ * @brief The number of change log reasons.
+ */
+const size_t LogReasonCount = 11;
+
 /**
  * @struct ChangeLogEntry
  * @brief A structure to represent a change log entry for the application.
+ *
+ * The entry is a fixed-size record: the UCs and classes are catalog ids (InvalidId when the request has
+ * none) and the students are their codes. The codes, names and notes are only formatted when the entry
+ * is displayed or exported.
  */
 struct ChangeLogEntry {
-    string timestamp;        ///< The timestamp of the log entry.
-    string requestType;      ///< The type of the request.
-    int studentCode;         ///< The student code.
-    string studentName;      ///< The name of the student.
-    string currentUcCode;    ///< The current UC code.
-    string currentClassCode; ///< The current class code.
-    string newUcCode;        ///< The new UC code.
-    string newClassCode;     ///< The new class code.
-    string extraNotes = "-"; ///< Additional notes or reason for the request.
-    bool accepted;           ///< A flag indicating whether the request was accepted.
+    int64_t timestamp = 0;                    ///< The time of the log entry, in nanoseconds since the epoch.
+    size_t changeId = NoChange;               ///< The id of the accepted change in the undo history of this run, or NoChange.
+    int32_t studentCode = 0;                  ///< The student code.
+    int32_t otherStudentCode = 0;             ///< The code of the other student of a swap, otherwise 0.
+    UcId currentUc = InvalidId;               ///< The current UC.
+    ClassId currentClass = InvalidId;         ///< The current class.
+    UcId newUc = InvalidId;                   ///< The new UC.
+    ClassId newClass = InvalidId;             ///< The new class.
+    uint16_t cycleLength = 0;                 ///< The number of class changes of the cycle the request was accepted in, otherwise 0.
+    RequestType requestType = RequestType::ChangeClass; ///< The type of the request.
+    LogReason reason = LogReason::None;       ///< The reason of the state of the request.
+    bool accepted = false;                    ///< A flag indicating whether the request was accepted.
 };
 
 /**
@@ -87,16 +142,69 @@ public:
 };
 
 
+/**
+ * @struct StudentDelta
+ * @brief The enrollment of a student before and after a change, as UC and class ids.
+ */
+struct StudentDelta {
+    int studentCode;         ///< The code of the student.
+    PackedEnrollment before; ///< The enrollment before the change.
+    PackedEnrollment after;  ///< The enrollment after the change.
+};
+
+/**
+ * @struct ChangeDelta
+ * @brief One or more consecutive committed changes, as the deltas of the students they changed, that can be undone and redone.
+ *
+ * A recorded change has a single id. When the history is squashed, consecutive changes are merged in a
+ * checkpoint that keeps one delta per student, and their ids are kept as runs of consecutive ids.
+ */
+struct ChangeDelta {
+    vector<pair<size_t, size_t>> idRuns; ///< The ids of the changes, as increasing runs of first and last id.
+    vector<StudentDelta> students;       ///< The deltas of the students changed, sorted by student code.
+};
+
 /**
  * @class System
  * @brief A class representing the system and its operations.
+ *
+ * The system keeps the undo history: every committed change is recorded as the enrollment of the
+ * students it changed before and after it, so undoing or redoing it only touches those students.
+ *
+ * The history has a memory budget. When it is exceeded, the oldest changes are squashed into a
+ * checkpoint at the start of the history, which is undone and redone as a whole and holds at most one
+ * delta per student. If the checkpoint alone still exceeds the budget, it is dropped and its changes
+ * can no longer be undone.
  */
 class System {
 private:
-    vector<Class> Classes;  ///< A vector of Class objects.
-    vector<Schedule> Schedules; ///< A vector of Schedule objects.
-    StudentBST Students;    ///< A binary search tree for storing Student objects.
-    stack<StudentBST> undoStack; ///< A stack to store previous StudentBST states.
+    shared_ptr<DataContext> context; ///< The data context shared with the rest of the application.
+    vector<ChangeDelta> history;     ///< The applied changes, oldest first, followed by the undone changes that can be redone.
+    size_t applied;                  ///< The number of applied changes at the start of the history.
+    size_t nextChangeId;             ///< The id of the next recorded change.
+    size_t historyBudget;            ///< The maximum memory of the history, in bytes.
+    size_t historyBytes;             ///< The memory of the history, in bytes.
+    bool checkpointed;               ///< True if the first change of the history is a checkpoint of squashed changes.
+
+    /**
+     * @brief Apply a change, or its inverse, in a write transaction.
+     * @param transaction The write transaction.
+     * @param change The change.
+     * @param forward True to redo the change, false to undo it.
+     * @return True if every student of the change was in the expected state, otherwise false.
+     */
+    bool apply(WriteTransaction& transaction, const ChangeDelta& change, bool forward);
+
+    /**
+     * @brief Squash the oldest changes into the checkpoint until the history fits in the budget.
+     */
+    void enforceBudget();
+
+    /**
+     * @brief Drop the changes of the history from a position on.
+     * @param position The position of the first change dropped.
+     */
+    void truncateHistory(size_t position);
 
 public:
     /**
@@ -107,55 +215,80 @@ public:
     /**
     * @brief Constructor for the System class.
     *
-    * @param data A Global object containing initial data for the system.
+    * @param context The shared data context the system operates on.
+    * @param historyBudget The maximum memory of the undo history, in bytes.
     */
-    System(Global data);
+    System(shared_ptr<DataContext> context, size_t historyBudget = 16 * 1024 * 1024);
 
     /**
-     * @brief Get the Classes vector.
+     * @brief Get the shared data context.
      *
-     * @return A vector of Class objects.
+     * @return A shared pointer to the DataContext.
      */
-    vector<Class> get_Classes();
+    shared_ptr<DataContext> getContext();
 
     /**
-     * @brief Get the Schedules vector.
-     *
-     * @return A vector of Schedule objects.
+     * @brief Record a committed change in the undo history, the undone changes can no longer be redone.
+     * @param transaction The committed write transaction.
+     * @return The id of the change, or NoChange if the transaction didn't change any student.
      */
-    vector<Schedule> get_Schedules();
+    size_t recordChange(const WriteTransaction& transaction);
 
     /**
-     * @brief Get the Students binary search tree.
-     *
-     * @return A StudentBST containing Student objects.
+     * @brief Undo the last applied change, or the whole checkpoint if it is the last one.
+     * @return The ids of the undone changes, newest first, empty if there is no change to undo.
      */
-    StudentBST get_Students();
+    vector<size_t> undoAction();
 
     /**
-     * @brief Deep copy a StudentBST.
-     *
-     * @param currentNode The current node in the source StudentBST.
-     * @param copy The StudentBST to which the data should be copied.
+     * @brief Redo the last undone change, or the whole checkpoint if it is the last one.
+     * @return The ids of the redone changes, oldest first, empty if there is no change to redo.
      */
-    void deepCopyStudentBST(Node* currentNode, StudentBST& copy);
+    vector<size_t> redoAction();
 
     /**
-     * @brief Save the current state of the StudentBST to the undo stack.
+     * @brief Undo a change and every change applied after it, in a single transaction.
+     * @param changeId The id of the oldest change to undo, if it is in the checkpoint the whole checkpoint is undone.
+     * @return The ids of the undone changes, newest first, empty if the change isn't applied.
      */
-    void saveCurrentState();
+    vector<size_t> undoTo(size_t changeId);
 
     /**
-     * @brief Undo the last action by restoring the previous state from the undo stack.
+     * @brief Check if a change is applied, and so can be undone.
+     * @param changeId The id of the change.
+     * @return True if the change is applied, otherwise false.
      */
-    void undoAction();
+    bool isApplied(size_t changeId) const;
 
     /**
-     * @brief Update the system data with new Global data.
-     *
-     * @param global A Global object containing new data.
+     * @brief Set the memory budget of the undo history, squashing it if it no longer fits.
+     * @param budget The maximum memory of the history, in bytes.
+     */
+    void setHistoryBudget(size_t budget);
+
+    /**
+     * @brief Get the memory budget of the undo history.
+     * @return The maximum memory of the history, in bytes.
+     */
+    size_t getHistoryBudget() const;
+
+    /**
+     * @brief Get the memory used by the undo history.
+     * @return The memory of the history, in bytes.
+     */
+    size_t historyMemory() const;
+
+    /**
+     * @brief Get the number of changes that can be undone.
+     * @return The number of applied changes in the history, including the ones squashed in the checkpoint.
+     */
+    size_t historyDepth() const;
+
+    /**
+     * @brief Get the number of changes squashed in the checkpoint, which can only be undone together.
+     * @return The number of changes in the checkpoint, 0 if there is none.
      */
-    void updateData(Global global);
+    size_t checkpointDepth() const;
 };
 
 
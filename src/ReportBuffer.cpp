@@ -0,0 +1,79 @@
+/**
+ * @file ReportBuffer.cpp
+ * @brief Implementation of the ReportBuffer class.
+ */
+
+#include "ReportBuffer.h"
+#include "UtilityFunctions.h"
+
+/**
+ * @brief Appends a string.
+ *
+ * @param text The string.
+ * @return This report.
+ */
+ReportBuffer& ReportBuffer::operator<<(const string& text) {
+    buffer += text;
+    return *this;
+}
+
+/**
+ * @brief Appends a null-terminated string.
+ *
+ * @param text The string.
+ * @return This report.
+ */
+ReportBuffer& ReportBuffer::operator<<(const char* text) {
+    buffer += text;
+    return *this;
+}
+
+/**
+ * @brief Appends a character.
+ *
+ * @param c The character.
+ * @return This report.
+ */
+ReportBuffer& ReportBuffer::operator<<(char c) {
+    buffer += c;
+    return *this;
+}
+
+/**
+ * @brief Appends a floating-point number, as cout writes it by default.
+ *
+ * cout writes with 6 significant digits in the shorter of the fixed and scientific notations, which is
+ * the general format of to_chars with a precision of 6.
+ *
+ * @param value The number.
+ * @return This report.
+ */
+ReportBuffer& ReportBuffer::operator<<(double value) {
+    char text[32];
+    buffer.append(text, to_chars(text, text + sizeof(text), value, chars_format::general, 6).ptr);
+    return *this;
+}
+
+/**
+ * @brief Appends a time of the day in "hh:mm" format.
+ *
+ * @param hours The time, in hours.
+ * @return This report.
+ */
+ReportBuffer& ReportBuffer::hours(float hours) {
+    appendHours(buffer, hours);
+    return *this;
+}
+
+/**
+ * @brief Writes the report to a stream with one write, and empties the buffer, keeping its capacity.
+ *
+ * @param out The stream.
+ *
+ * @complexity O(n), where n is the size of the report.
+ */
+void ReportBuffer::flush(ostream& out) {
+    out.write(buffer.data(), (streamsize) buffer.size());
+    out.flush();
+    buffer.clear();
+}
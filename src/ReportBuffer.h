@@ -0,0 +1,87 @@
+/**
+ * @file ReportBuffer.h
+ * @brief Header file for the ReportBuffer class.
+ */
+
+#ifndef PROJETO_AED_REPORTBUFFER_H
+#define PROJETO_AED_REPORTBUFFER_H
+
+#include <charconv>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+using namespace std;
+
+/**
+ * @class ReportBuffer
+ * @brief Builds a report in memory and writes it to the terminal at once.
+ *
+ * Writing a report line by line with endl flushes the stream on every line, a write to the terminal
+ * each; a listing of thousands of students then takes thousands of writes. The report is instead
+ * appended to a buffer, with the numbers formatted by to_chars, and written with a single write when
+ * it is flushed. The buffer keeps its capacity, so a ReportBuffer reused for the next report doesn't
+ * allocate again.
+ *
+ * Whatever asks the user for input must flush the report first, so that it is shown before the prompt.
+ */
+class ReportBuffer {
+private:
+    string buffer; ///< The report not yet written.
+
+public:
+    /**
+     * @brief Append a string.
+     * @param text The string.
+     * @return This report.
+     */
+    ReportBuffer& operator<<(const string& text);
+
+    /**
+     * @brief Append a null-terminated string.
+     * @param text The string.
+     * @return This report.
+     */
+    ReportBuffer& operator<<(const char* text);
+
+    /**
+     * @brief Append a character.
+     * @param c The character.
+     * @return This report.
+     */
+    ReportBuffer& operator<<(char c);
+
+    /**
+     * @brief Append a floating-point number, as cout writes it by default (6 significant digits).
+     * @param value The number.
+     * @return This report.
+     */
+    ReportBuffer& operator<<(double value);
+
+    /**
+     * @brief Append an integer, formatted with to_chars.
+     * @param value The integer.
+     * @return This report.
+     */
+    template<typename T, typename enable_if<is_integral<T>::value && !is_same<T, char>::value && !is_same<T, bool>::value, int>::type = 0>
+    ReportBuffer& operator<<(T value) {
+        char text[24];
+        buffer.append(text, to_chars(text, text + sizeof(text), value).ptr);
+        return *this;
+    }
+
+    /**
+     * @brief Append a time of the day in "hh:mm" format, as floatToHours formats it.
+     * @param hours The time, in hours.
+     * @return This report.
+     */
+    ReportBuffer& hours(float hours);
+
+    /**
+     * @brief Write the report to a stream with one write, and empty the buffer, keeping its capacity.
+     * @param out The stream, cout by default.
+     */
+    void flush(ostream& out = cout);
+};
+
+#endif //PROJETO_AED_REPORTBUFFER_H
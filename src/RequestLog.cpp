@@ -0,0 +1,302 @@
+/**
+ * @file RequestLog.cpp
+ * @brief Implementation of the RequestLog class.
+ */
+
+#include "RequestLog.h"
+#include <iostream>
+#include <unordered_map>
+
+/**
+ * @brief The first bytes of a request log file, identifying its format.
+ */
+static const char LogMagic[8] = {'A', 'E', 'D', 'R', 'Q', 'L', 'G', '2'};
+
+/**
+ * @brief Appends a change log entry to a record payload, as fixed-size fields.
+ *
+ * @param writer The writer of the payload.
+ * @param entry The change log entry.
+ */
+static void putEntry(BinaryWriter& writer, const ChangeLogEntry& entry) {
+    writer.put<int64_t>(entry.timestamp);
+    writer.put<int32_t>(entry.studentCode);
+    writer.put<int32_t>(entry.otherStudentCode);
+    writer.put<UcId>(entry.currentUc);
+    writer.put<ClassId>(entry.currentClass);
+    writer.put<UcId>(entry.newUc);
+    writer.put<ClassId>(entry.newClass);
+    writer.put<uint16_t>(entry.cycleLength);
+    writer.put<uint8_t>((uint8_t) entry.requestType);
+    writer.put<uint8_t>((uint8_t) entry.reason);
+    writer.put<uint8_t>(entry.accepted);
+}
+
+/**
+ * @brief Reads a change log entry written by putEntry.
+ *
+ * @param reader The reader of the payload.
+ * @param entry The change log entry read.
+ * @return True if the entry was read and its enums are valid, otherwise false.
+ */
+static bool getEntry(BinaryReader& reader, ChangeLogEntry& entry) {
+    uint8_t requestType = 0, reason = 0, accepted = 0;
+    bool ok = reader.get(entry.timestamp) && reader.get(entry.studentCode) && reader.get(entry.otherStudentCode)
+              && reader.get(entry.currentUc) && reader.get(entry.currentClass) && reader.get(entry.newUc)
+              && reader.get(entry.newClass) && reader.get(entry.cycleLength) && reader.get(requestType)
+              && reader.get(reason) && reader.get(accepted);
+    if (!ok || requestType >= RequestTypeCount || reason >= LogReasonCount) {
+        return false;
+    }
+    entry.requestType = (RequestType) requestType;
+    entry.reason = (LogReason) reason;
+    entry.accepted = accepted != 0;
+    return true;
+}
+
+/**
+ * @brief Constructor for the RequestLog class.
+ *
+ * The log is loaded and replayed, its torn tail is cut, and it is compacted if most of its records
+ * are no longer needed.
+ *
+ * @param path The path of the log file, created if it doesn't exist.
+ */
+RequestLog::RequestLog(const string& path) : file(path, string(LogMagic, sizeof(LogMagic))) {
+    const vector<string_view>& records = file.load();
+    recovered = replay(records);
+    recovered.tornTail = file.tornTail() || recovered.records < records.size();
+    if (recovered.tornTail) {
+        cerr << "ERROR: The request log ends with an incomplete record, it was dropped." << endl;
+    }
+    file.open(recovered.records);
+
+    size_t live = recovered.pending.size() + recovered.changeLogs.size();
+    if (recovered.records > 1024 && recovered.records > 2 * live) {
+        file.rewrite(compactRecords(recovered));
+    }
+}
+
+/**
+ * @brief Replays the records of a log, in order.
+ *
+ * The request of a cancel or process record is found by its id in an index of the pending requests,
+ * which are only filtered once at the end. The ids are not required to increase: a log written before
+ * the next id was recorded may reuse the ids of an earlier run, and those records are still valid, so
+ * they must not be taken for a corrupted tail. The records are counted first, so that the requests and
+ * the change logs are allocated once.
+ *
+ * @param records The payloads of the records, in order.
+ * @return The recovered state, its records are the number of records that could be replayed.
+ *
+ * @complexity O(n) on average, where n is the number of records.
+ */
+RequestLog::Recovery RequestLog::replay(const vector<string_view>& records) {
+    Recovery state;
+    vector<bool> live;
+    unordered_map<RequestId, size_t> pendingIndex; // The position of the last request enqueued with each id
+
+    size_t enqueued = 0, processed = 0;
+    for (const string_view& record : records) {
+        enqueued += !record.empty() && (RecordType) record[0] == RecordType::Enqueued;
+        processed += !record.empty() && (RecordType) record[0] == RecordType::Processed;
+    }
+    state.pending.reserve(enqueued);
+    live.reserve(enqueued);
+    state.changeLogs.reserve(processed);
+
+    pendingIndex.reserve(enqueued);
+
+    auto removePending = [&](RequestId id) {
+        auto it = pendingIndex.find(id);
+        if (it != pendingIndex.end()) {
+            live[it->second] = false;
+            pendingIndex.erase(it);
+        }
+    };
+
+    for (const string_view& record : records) {
+        BinaryReader reader(record.data(), record.size());
+        uint8_t type = 0;
+        if (!reader.get(type)) {
+            break;
+        }
+        bool ok = false;
+        RequestId id = 0;
+        switch ((RecordType) type) {
+            case RecordType::Enqueued: {
+                ChangeRequest request;
+                ok = reader.get(id) && reader.get(request);
+                if (ok) {
+                    pendingIndex[id] = state.pending.size();
+                    state.pending.emplace_back(id, request);
+                    live.push_back(true);
+                    state.nextId = max(state.nextId, id + 1);
+                }
+                break;
+            }
+            case RecordType::Canceled:
+                ok = reader.get(id);
+                if (ok) {
+                    removePending(id);
+                }
+                break;
+            case RecordType::Processed: {
+                uint8_t hasEntry = 0;
+                ChangeLogEntry entry;
+                ok = reader.get(id) && reader.get(hasEntry) && (!hasEntry || getEntry(reader, entry));
+                if (ok) {
+                    removePending(id);
+                    if (hasEntry) {
+                        state.changeLogs.push_back(std::move(entry));
+                    }
+                }
+                break;
+            }
+            case RecordType::LogUpdated: {
+                uint64_t index = 0;
+                ChangeLogEntry entry;
+                ok = reader.get(index) && getEntry(reader, entry) && index < state.changeLogs.size();
+                if (ok) {
+                    state.changeLogs[index] = std::move(entry);
+                }
+                break;
+            }
+            case RecordType::IdsUsed: {
+                RequestId next = 0;
+                ok = reader.get(next);
+                if (ok) {
+                    state.nextId = max(state.nextId, next);
+                }
+                break;
+            }
+        }
+        if (!ok || !reader.atEnd()) {
+            break;
+        }
+        state.records++;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < state.pending.size(); i++) {
+        if (live[i]) {
+            state.pending[kept++] = state.pending[i];
+        }
+    }
+    state.pending.resize(kept);
+    return state;
+}
+
+/**
+ * @brief Builds the records needed to recover a given state: the next request id, the change logs, then the pending requests.
+ *
+ * The next id is kept even when no request is pending, so the ids of the requests processed before are
+ * never given again.
+ *
+ * @param state The recovered state.
+ * @return The payloads of the records.
+ */
+vector<string> RequestLog::compactRecords(const Recovery& state) {
+    vector<string> records;
+    records.reserve(1 + state.changeLogs.size() + state.pending.size());
+    string ids;
+    BinaryWriter idsWriter(ids);
+    idsWriter.put<uint8_t>((uint8_t) RecordType::IdsUsed);
+    idsWriter.put(state.nextId);
+    records.push_back(std::move(ids));
+    for (const ChangeLogEntry& entry : state.changeLogs) {
+        string payload;
+        BinaryWriter writer(payload);
+        writer.put<uint8_t>((uint8_t) RecordType::Processed);
+        writer.put<RequestId>(0); // written before any request is enqueued, so it only carries the entry
+        writer.put<uint8_t>(1);
+        putEntry(writer, entry);
+        records.push_back(std::move(payload));
+    }
+    for (const auto& request : state.pending) {
+        string payload;
+        BinaryWriter writer(payload);
+        writer.put<uint8_t>((uint8_t) RecordType::Enqueued);
+        writer.put(request.first);
+        writer.put(request.second);
+        records.push_back(std::move(payload));
+    }
+    return records;
+}
+
+/**
+ * @brief Takes the state replayed when the log was opened.
+ *
+ * @return The recovered pending requests and change logs.
+ */
+RequestLog::Recovery RequestLog::takeRecovered() {
+    return std::move(recovered);
+}
+
+/**
+ * @brief Records that a request was added to the store.
+ *
+ * @param id The id of the request.
+ * @param request The request.
+ */
+void RequestLog::logEnqueued(RequestId id, const ChangeRequest& request) {
+    string payload;
+    BinaryWriter writer(payload);
+    writer.put<uint8_t>((uint8_t) RecordType::Enqueued);
+    writer.put(id);
+    writer.put(request);
+    file.append(payload);
+}
+
+/**
+ * @brief Records that a request was canceled.
+ *
+ * @param id The id of the request.
+ */
+void RequestLog::logCanceled(RequestId id) {
+    string payload;
+    BinaryWriter writer(payload);
+    writer.put<uint8_t>((uint8_t) RecordType::Canceled);
+    writer.put(id);
+    file.append(payload);
+}
+
+/**
+ * @brief Records that a request was processed, with its change log entry in the same record.
+ *
+ * @param id The id of the request.
+ * @param entry The change log entry of the request, null if it didn't produce one.
+ */
+void RequestLog::logProcessed(RequestId id, const ChangeLogEntry* entry) {
+    string payload;
+    BinaryWriter writer(payload);
+    writer.put<uint8_t>((uint8_t) RecordType::Processed);
+    writer.put(id);
+    writer.put<uint8_t>(entry != nullptr);
+    if (entry != nullptr) {
+        putEntry(writer, *entry);
+    }
+    file.append(payload);
+}
+
+/**
+ * @brief Records that a change log entry was changed.
+ *
+ * @param index The position of the entry in the change logs.
+ * @param entry The new entry.
+ */
+void RequestLog::logUpdated(size_t index, const ChangeLogEntry& entry) {
+    string payload;
+    BinaryWriter writer(payload);
+    writer.put<uint8_t>((uint8_t) RecordType::LogUpdated);
+    writer.put<uint64_t>(index);
+    putEntry(writer, entry);
+    file.append(payload);
+}
+
+/**
+ * @brief Waits until every record appended so far is on the disk.
+ */
+void RequestLog::sync() {
+    file.sync();
+}
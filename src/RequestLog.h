@@ -0,0 +1,111 @@
+/**
+ * @file RequestLog.h
+ * @brief Header file for the RequestLog class.
+ */
+
+#ifndef PROJETO_AED_REQUESTLOG_H
+#define PROJETO_AED_REQUESTLOG_H
+
+#include "RequestStore.h"
+#include "ReadData.h"
+#include "JournalFile.h"
+
+/**
+ * @class RequestLog
+ * @brief A journal of the requests enqueued, canceled and processed, and of the change logs.
+ *
+ * Each record of the JournalFile starts with its RecordType. When the log is opened, it is replayed to
+ * recover the pending requests and the change logs, up to the first incomplete or corrupted record.
+ * If most of the records are no longer needed, the log is rewritten with only the pending requests
+ * and the change logs.
+ */
+class RequestLog {
+public:
+    /**
+     * @brief The type of a record, stored in its first byte.
+     */
+    enum class RecordType : uint8_t {
+        Enqueued = 1, ///< A request was added to the store: its id and the request.
+        Canceled,     ///< A request was canceled: its id.
+        Processed,    ///< A request was processed: its id and its change log entry, if any.
+        LogUpdated,   ///< A change log entry was changed: its position and the new entry.
+        IdsUsed       ///< The ids below a value were given to requests: the next id, written when the log is compacted.
+    };
+
+    /**
+     * @struct Recovery
+     * @brief The state rebuilt by replaying the log.
+     */
+    struct Recovery {
+        vector<pair<RequestId, ChangeRequest>> pending; ///< The pending requests, in arrival order.
+        vector<ChangeLogEntry> changeLogs;              ///< The change logs, in order.
+        RequestId nextId = 0;                           ///< One past the greatest id ever given to a request, the first id of the next ones.
+        size_t records = 0;                             ///< The number of valid records replayed.
+        bool tornTail = false;                          ///< True if an incomplete or corrupted tail was dropped.
+    };
+
+private:
+    JournalFile file;   ///< The file of the log.
+    Recovery recovered; ///< The state replayed when the log was opened.
+
+    /**
+     * @brief Replay the records of a log.
+     * @param records The payloads of the records, in order.
+     * @return The recovered state, its records are the number of records that could be replayed.
+     */
+    static Recovery replay(const vector<string_view>& records);
+
+    /**
+     * @brief Build the records needed to recover a given state.
+     * @param state The recovered state.
+     * @return The payloads of the records.
+     */
+    static vector<string> compactRecords(const Recovery& state);
+
+public:
+    /**
+     * @brief Constructor for the RequestLog class, opens the log and replays it.
+     * @param path The path of the log file, created if it doesn't exist.
+     */
+    explicit RequestLog(const string& path);
+
+    /**
+     * @brief Take the state replayed when the log was opened.
+     * @return The recovered pending requests and change logs.
+     */
+    Recovery takeRecovered();
+
+    /**
+     * @brief Record that a request was added to the store.
+     * @param id The id of the request.
+     * @param request The request.
+     */
+    void logEnqueued(RequestId id, const ChangeRequest& request);
+
+    /**
+     * @brief Record that a request was canceled.
+     * @param id The id of the request.
+     */
+    void logCanceled(RequestId id);
+
+    /**
+     * @brief Record that a request was processed.
+     * @param id The id of the request.
+     * @param entry The change log entry of the request, null if it didn't produce one.
+     */
+    void logProcessed(RequestId id, const ChangeLogEntry* entry);
+
+    /**
+     * @brief Record that a change log entry was changed.
+     * @param index The position of the entry in the change logs.
+     * @param entry The new entry.
+     */
+    void logUpdated(size_t index, const ChangeLogEntry& entry);
+
+    /**
+     * @brief Wait until every record appended so far is on the disk.
+     */
+    void sync();
+};
+
+#endif //PROJETO_AED_REQUESTLOG_H
@@ -0,0 +1,249 @@
+/**
+ * @file RequestStore.cpp
+ * @brief Implementation of the RequestStore class.
+ */
+
+#include "RequestStore.h"
+
+/**
+ * @brief Constructor for the RequestStore class.
+ *
+ * @param priorityClasses The number of priority classes.
+ * @param priorityOf Gives the priority class of a request, all requests are in class 0 if empty.
+ */
+RequestStore::RequestStore(size_t priorityClasses, function<size_t(const ChangeRequest&)> priorityOf)
+    : lanes(max<size_t>(priorityClasses, 1)), priorityOf(std::move(priorityOf)), nextId(0) {}
+
+/**
+ * @brief Removes the tombstones at the front of every priority class.
+ *
+ * @complexity O(1) amortized, each tombstone is removed once.
+ */
+void RequestStore::skipTombstones() {
+    for (deque<RequestId>& lane : lanes) {
+        while (!lane.empty() && requests.find(lane.front()) == requests.end()) {
+            lane.pop_front();
+        }
+    }
+}
+
+/**
+ * @brief Removes a request from the student index.
+ *
+ * @param id The id of the request.
+ * @param request The request.
+ */
+void RequestStore::unindex(RequestId id, const ChangeRequest& request) {
+    for (int studentCode : studentsOf(request)) {
+        auto it = requestsOfStudent.find(studentCode);
+        if (it == requestsOfStudent.end()) {
+            continue;
+        }
+        vector<RequestId>& ids = it->second;
+        ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+        if (ids.empty()) {
+            requestsOfStudent.erase(it);
+        }
+    }
+}
+
+/**
+ * @brief Adds a request at the back of its priority class.
+ *
+ * @param request The change request.
+ * @return The id of the request.
+ *
+ * @complexity O(1) amortized
+ */
+RequestId RequestStore::push(const ChangeRequest& request) {
+    RequestId id = nextId;
+    restore(id, request);
+    return id;
+}
+
+/**
+ * @brief Makes sure the next requests get ids that were never given, in this run or a previous one.
+ *
+ * @param nextId The first id that was never given.
+ */
+void RequestStore::reserveIds(RequestId nextId) {
+    this->nextId = max(this->nextId, nextId);
+}
+
+/**
+ * @brief Adds a request recovered from a previous run at the back of its priority class, keeping its id.
+ * The following requests get greater ids.
+ *
+ * @param id The id of the request, greater than the id of every request in the store.
+ * @param request The change request.
+ *
+ * @complexity O(1) amortized
+ */
+void RequestStore::restore(RequestId id, const ChangeRequest& request) {
+    nextId = max(nextId, id + 1);
+    size_t priority = priorityOf ? min(priorityOf(request), lanes.size() - 1) : 0;
+    requests.emplace(id, request);
+    lanes[priority].push_back(id);
+    for (int studentCode : studentsOf(request)) {
+        vector<RequestId>& ids = requestsOfStudent[studentCode];
+        if (find(ids.begin(), ids.end(), id) == ids.end()) {
+            ids.push_back(id);
+        }
+    }
+}
+
+/**
+ * @brief Checks if there are no pending requests.
+ *
+ * @return True if there are no pending requests, otherwise false.
+ */
+bool RequestStore::empty() const {
+    return requests.empty();
+}
+
+/**
+ * @brief Gets the number of pending requests.
+ *
+ * @return The number of pending requests.
+ */
+size_t RequestStore::size() const {
+    return requests.size();
+}
+
+/**
+ * @brief Gets the id of the next request to process, from the first non-empty priority class.
+ *
+ * @return The id of the next request, the store must not be empty.
+ *
+ * @complexity O(P) amortized, where P is the number of priority classes.
+ */
+RequestId RequestStore::frontId() {
+    skipTombstones();
+    for (const deque<RequestId>& lane : lanes) {
+        if (!lane.empty()) {
+            return lane.front();
+        }
+    }
+    throw out_of_range("The request store is empty");
+}
+
+/**
+ * @brief Removes and returns the next request to process, from the first non-empty priority class.
+ *
+ * @return The next request, the store must not be empty.
+ *
+ * @complexity O(P) amortized, where P is the number of priority classes.
+ */
+ChangeRequest RequestStore::pop() {
+    skipTombstones();
+    for (deque<RequestId>& lane : lanes) {
+        if (lane.empty()) {
+            continue;
+        }
+        RequestId id = lane.front();
+        lane.pop_front();
+        auto it = requests.find(id);
+        ChangeRequest request = std::move(it->second);
+        requests.erase(it);
+        unindex(id, request);
+        return request;
+    }
+    throw out_of_range("The request store is empty");
+}
+
+/**
+ * @brief Removes every pending request.
+ *
+ * @return The requests, in processing order.
+ *
+ * @complexity O(N), where N is the number of requests and tombstones.
+ */
+vector<ChangeRequest> RequestStore::drain() {
+    vector<ChangeRequest> pending;
+    pending.reserve(requests.size());
+    for (deque<RequestId>& lane : lanes) {
+        for (RequestId id : lane) {
+            auto it = requests.find(id);
+            if (it != requests.end()) {
+                pending.push_back(std::move(it->second));
+            }
+        }
+        lane.clear();
+    }
+    requests.clear();
+    requestsOfStudent.clear();
+    return pending;
+}
+
+/**
+ * @brief Gets the ids of every pending request.
+ *
+ * @return The ids, in processing order.
+ *
+ * @complexity O(N), where N is the number of requests and tombstones.
+ */
+vector<RequestId> RequestStore::pendingIds() const {
+    vector<RequestId> ids;
+    ids.reserve(requests.size());
+    for (const deque<RequestId>& lane : lanes) {
+        for (RequestId id : lane) {
+            if (requests.find(id) != requests.end()) {
+                ids.push_back(id);
+            }
+        }
+    }
+    return ids;
+}
+
+/**
+ * @brief Gets a pending request.
+ *
+ * @param id The id of the request, it must be pending.
+ * @return The request.
+ */
+const ChangeRequest& RequestStore::get(RequestId id) const {
+    return requests.at(id);
+}
+
+/**
+ * @brief Removes a pending request, its id stays in the priority class as a tombstone.
+ *
+ * @param id The id of the request.
+ * @return True if the request was pending, otherwise false.
+ *
+ * @complexity O(1) on average
+ */
+bool RequestStore::remove(RequestId id) {
+    auto it = requests.find(id);
+    if (it == requests.end()) {
+        return false;
+    }
+    unindex(id, it->second);
+    requests.erase(it);
+    return true;
+}
+
+/**
+ * @brief Gets the pending requests of a student.
+ *
+ * @param studentCode The code of the student.
+ * @return The ids of the requests, in arrival order.
+ *
+ * @complexity O(1) on average
+ */
+vector<RequestId> RequestStore::requestsOf(int studentCode) const {
+    auto it = requestsOfStudent.find(studentCode);
+    return it != requestsOfStudent.end() ? it->second : vector<RequestId>();
+}
+
+/**
+ * @brief Checks if a student has pending requests.
+ *
+ * @param studentCode The code of the student.
+ * @return True if the student has at least one pending request, otherwise false.
+ *
+ * @complexity O(1) on average
+ */
+bool RequestStore::hasPending(int studentCode) const {
+    return requestsOfStudent.find(studentCode) != requestsOfStudent.end();
+}
@@ -0,0 +1,140 @@
+/**
+ * @file RequestStore.h
+ * @brief Header file for the RequestStore class.
+ */
+
+#ifndef PROJETO_AED_REQUESTSTORE_H
+#define PROJETO_AED_REQUESTSTORE_H
+
+#include "ChangeRequest.h"
+#include <deque>
+#include <unordered_map>
+
+/**
+ * @brief The identifier of a request in a RequestStore, increasing with the order of arrival.
+ */
+typedef size_t RequestId;
+
+/**
+ * @class RequestStore
+ * @brief The pending change requests, in priority and arrival order, indexed by student.
+ *
+ * Each request is placed in a priority class (0 is processed first) and, inside it, in arrival order.
+ * Every student code involved in a request is indexed, so the requests of a student can be found and
+ * canceled without going through the queue. A canceled request leaves a tombstone in its priority
+ * class, which is skipped when the queue reaches it.
+ */
+class RequestStore {
+private:
+    unordered_map<RequestId, ChangeRequest> requests;        ///< The live requests, a missing id is a tombstone.
+    vector<deque<RequestId>> lanes;                          ///< The ids of each priority class, in arrival order.
+    unordered_map<int, vector<RequestId>> requestsOfStudent; ///< The live requests of each student.
+    function<size_t(const ChangeRequest&)> priorityOf;       ///< Gives the priority class of a request.
+    RequestId nextId;                                        ///< The id of the next request.
+
+    /**
+     * @brief Remove the tombstones at the front of every priority class.
+     */
+    void skipTombstones();
+
+    /**
+     * @brief Remove a request from the student index.
+     * @param id The id of the request.
+     * @param request The request.
+     */
+    void unindex(RequestId id, const ChangeRequest& request);
+
+public:
+    /**
+     * @brief Constructor for the RequestStore class.
+     * @param priorityClasses The number of priority classes.
+     * @param priorityOf Gives the priority class of a request, all requests are in class 0 if empty.
+     */
+    explicit RequestStore(size_t priorityClasses = 1, function<size_t(const ChangeRequest&)> priorityOf = nullptr);
+
+    /**
+     * @brief Add a request at the back of its priority class.
+     * @param request The change request.
+     * @return The id of the request.
+     */
+    RequestId push(const ChangeRequest& request);
+
+    /**
+     * @brief Add a request recovered from a previous run, keeping its id.
+     * @param id The id of the request, greater than the id of every request in the store.
+     * @param request The change request.
+     */
+    void restore(RequestId id, const ChangeRequest& request);
+
+    /**
+     * @brief Make sure the next requests get ids that were never given, in this run or a previous one.
+     * @param nextId The first id that was never given.
+     */
+    void reserveIds(RequestId nextId);
+
+    /**
+     * @brief Check if there are no pending requests.
+     * @return True if there are no pending requests, otherwise false.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Get the number of pending requests.
+     * @return The number of pending requests.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the id of the next request to process.
+     * @return The id of the next request, the store must not be empty.
+     */
+    RequestId frontId();
+
+    /**
+     * @brief Remove and return the next request to process.
+     * @return The next request, the store must not be empty.
+     */
+    ChangeRequest pop();
+
+    /**
+     * @brief Remove every pending request.
+     * @return The requests, in processing order.
+     */
+    vector<ChangeRequest> drain();
+
+    /**
+     * @brief Get the ids of every pending request.
+     * @return The ids, in processing order.
+     */
+    vector<RequestId> pendingIds() const;
+
+    /**
+     * @brief Get a pending request.
+     * @param id The id of the request, it must be pending.
+     * @return The request.
+     */
+    const ChangeRequest& get(RequestId id) const;
+
+    /**
+     * @brief Remove a pending request, leaving a tombstone in its priority class.
+     * @param id The id of the request.
+     * @return True if the request was pending, otherwise false.
+     */
+    bool remove(RequestId id);
+
+    /**
+     * @brief Get the pending requests of a student.
+     * @param studentCode The code of the student.
+     * @return The ids of the requests, in arrival order.
+     */
+    vector<RequestId> requestsOf(int studentCode) const;
+
+    /**
+     * @brief Check if a student has pending requests.
+     * @param studentCode The code of the student.
+     * @return True if the student has at least one pending request, otherwise false.
+     */
+    bool hasPending(int studentCode) const;
+};
+
+#endif //PROJETO_AED_REQUESTSTORE_H
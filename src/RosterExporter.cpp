@@ -0,0 +1,200 @@
+/**
+ * @file RosterExporter.cpp
+ * @brief Implementation of the RosterExporter class.
+ */
+
+#include "RosterExporter.h"
+#include "JournalFile.h"
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief Constructor for the RosterExporter class.
+ *
+ * @param pool The threads the roster is formatted on.
+ */
+RosterExporter::RosterExporter(ThreadPool& pool) : pool(pool) {}
+
+/**
+ * @brief Cuts a tree into pieces that follow its in-order sequence.
+ *
+ * Starting from the whole tree, every subtree piece of a level is replaced by its left subtree, its
+ * root and its right subtree, until there are enough pieces or every subtree is a leaf. The subtrees of
+ * a level have about the same size in a balanced tree, so the threads get about the same work.
+ *
+ * @param root The root of the tree.
+ * @param target The number of pieces to reach, if the tree is large enough.
+ * @return The pieces, in order.
+ *
+ * @complexity O(p), where p is the number of pieces.
+ */
+vector<RosterExporter::Piece> RosterExporter::partition(const Node* root, size_t target) {
+    vector<Piece> pieces;
+    if (root != nullptr) {
+        pieces.push_back({root, true});
+    }
+    bool split = true;
+    while (pieces.size() < target && split) {
+        split = false;
+        vector<Piece> next;
+        next.reserve(pieces.size() * 3);
+        for (const Piece& piece : pieces) {
+            const Node* node = piece.node;
+            if (!piece.whole || (node->left == nullptr && node->right == nullptr)) {
+                next.push_back(piece);
+                continue;
+            }
+            if (node->left != nullptr) {
+                next.push_back({node->left, true});
+            }
+            next.push_back({node, false});
+            if (node->right != nullptr) {
+                next.push_back({node->right, true});
+            }
+            split = true;
+        }
+        pieces.swap(next);
+    }
+    return pieces;
+}
+
+/**
+ * @brief Formats the rows of a student, one per enrollment, as they are in the file.
+ *
+ * The rows of the student are sized first, so the buffer grows once and the fields are copied straight
+ * into it; the code of the student is formatted once for all of its rows.
+ *
+ * @param student The student.
+ * @param out The buffer the rows are appended to.
+ *
+ * @complexity O(r), where r is the size of the rows of the student.
+ */
+void RosterExporter::formatStudent(const Student& student, string& out) {
+    char code[16];
+    size_t codeSize = (size_t) (to_chars(code, code + sizeof(code), student.StudentCode).ptr - code);
+    const string& name = student.StudentName;
+    size_t size = 0;
+    for (const Class& ucClass : student.UcToClasses) {
+        size += codeSize + name.size() + ucClass.UcCode.size() + ucClass.ClassCode.size() + 4;
+    }
+    size_t at = out.size();
+    out.resize(at + size);
+    char* row = &out[at];
+    for (const Class& ucClass : student.UcToClasses) {
+        memcpy(row, code, codeSize);
+        row += codeSize;
+        *row++ = ',';
+        memcpy(row, name.data(), name.size());
+        row += name.size();
+        *row++ = ',';
+        memcpy(row, ucClass.UcCode.data(), ucClass.UcCode.size());
+        row += ucClass.UcCode.size();
+        *row++ = ',';
+        memcpy(row, ucClass.ClassCode.data(), ucClass.ClassCode.size());
+        row += ucClass.ClassCode.size();
+        *row++ = '\n';
+    }
+}
+
+/**
+ * @brief Formats the rows of the students of a piece, in name order, without recursion.
+ *
+ * @param piece The piece.
+ * @param out The buffer the rows are appended to.
+ * @param layout If not null, receives where the rows of each student are in the buffer.
+ *
+ * @complexity O(r), where r is the size of the rows of the piece.
+ */
+void RosterExporter::format(const Piece& piece, string& out, vector<StudentRows>* layout) {
+    auto formatNode = [&out, layout](const Node* node) {
+        size_t at = out.size();
+        formatStudent(node->data, out);
+        if (layout != nullptr) {
+            layout->push_back({node->data.StudentCode, at, (uint32_t) (out.size() - at)});
+        }
+    };
+
+    if (!piece.whole) {
+        formatNode(piece.node);
+        return;
+    }
+    vector<const Node*> path;
+    const Node* node = piece.node;
+    while (node != nullptr || !path.empty()) {
+        while (node != nullptr) {
+            path.push_back(node);
+            // The nodes are scattered in memory, start loading the ones needed next while going down
+            __builtin_prefetch(node->right);
+            __builtin_prefetch(node->data.UcToClasses.data());
+            node = node->left;
+        }
+        node = path.back();
+        path.pop_back();
+        formatNode(node);
+        node = node->right;
+    }
+}
+
+/**
+ * @brief Writes the roster to a CSV file, through a temporary file that replaces it.
+ *
+ * The pieces of each window are formatted in parallel, then their buffers are written in the order of
+ * the pieces, so the file has the rows in name order, as StudentBST::saveToCSV writes them. The buffers
+ * are reused by the next window. The layout of each piece is shifted by the offset its buffer is written at.
+ *
+ * @param students The roster.
+ * @param path The path of the file.
+ * @param layout If not null, receives where the rows of each student are in the file, in the order of the file.
+ * @return True if the file was written, otherwise false.
+ *
+ * @complexity O(r / t), where r is the size of the rows and t the number of threads, and the write of the file.
+ */
+bool RosterExporter::exportCsv(const StudentBST& students, const string& path, vector<StudentRows>* layout) const {
+    string temporaryPath = path + ".tmp";
+    int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    const string header = "StudentCode,StudentName,UcCode,ClassCode\n";
+    bool ok = writeAll(fd, header);
+    uint64_t offset = header.size();
+    if (layout != nullptr) {
+        layout->clear();
+    }
+
+    vector<Piece> pieces = partition(students.getRoot(), pool.size() * PiecesPerThread);
+    size_t windowSize = max<size_t>((pieces.size() + WindowsPerExport - 1) / WindowsPerExport, 1);
+    vector<string> chunks(min(windowSize, pieces.size()));
+    vector<vector<StudentRows>> chunkLayouts(layout != nullptr ? chunks.size() : 0);
+    for (size_t begin = 0; ok && begin < pieces.size(); begin += windowSize) {
+        size_t end = min(begin + windowSize, pieces.size());
+        pool.parallelFor(end - begin, [&](size_t i) {
+            chunks[i].clear();
+            if (layout != nullptr) {
+                chunkLayouts[i].clear();
+            }
+            format(pieces[begin + i], chunks[i], layout != nullptr ? &chunkLayouts[i] : nullptr);
+        });
+        for (size_t i = 0; ok && i < end - begin; i++) {
+            ok = writeAll(fd, chunks[i]);
+            if (layout != nullptr) {
+                for (StudentRows rows : chunkLayouts[i]) {
+                    rows.offset += offset;
+                    layout->push_back(rows);
+                }
+            }
+            offset += chunks[i].size();
+        }
+    }
+
+    ok = ok && ::fdatasync(fd) == 0;
+    ::close(fd);
+    if (!ok || ::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        ::unlink(temporaryPath.c_str());
+        return false;
+    }
+    syncDirectoryOf(path);
+    return true;
+}
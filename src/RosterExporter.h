@@ -0,0 +1,91 @@
+/**
+ * @file RosterExporter.h
+ * @brief Header file for the RosterExporter class.
+ */
+
+#ifndef PROJETO_AED_ROSTEREXPORTER_H
+#define PROJETO_AED_ROSTEREXPORTER_H
+
+#include "Data.h"
+#include "ThreadPool.h"
+
+/**
+ * @struct StudentRows
+ * @brief Where the rows of a student are in an exported roster file.
+ */
+struct StudentRows {
+    int studentCode;  ///< The code of the student.
+    uint64_t offset;  ///< The offset of the first row of the student in the file.
+    uint32_t length;  ///< The size of the rows of the student, 0 if the student has no enrollment.
+};
+
+/**
+ * @class RosterExporter
+ * @brief Writes the roster to a CSV file, formatting it in parallel on a thread pool.
+ *
+ * The file has the rows of StudentBST::saveToCSV, a row per enrollment in name order, but it is built
+ * differently. The tree is cut into pieces that follow its in-order sequence: subtrees, and the nodes
+ * between them. The pieces are formatted concurrently, each into its own buffer, with to_chars for the
+ * numbers. The buffers are then written in order with one write each, so no row is flushed on its
+ * own. The pieces are formatted a window at a time, which bounds the memory to a part of the file.
+ *
+ * The file is written to a temporary file that replaces it once it is synced, so a reader or a crash
+ * sees either the previous file or the complete new one.
+ */
+class RosterExporter {
+private:
+    /**
+     * @struct Piece
+     * @brief A part of the in-order sequence of the tree: a whole subtree, or a single node.
+     */
+    struct Piece {
+        const Node* node;  ///< The root of the subtree, or the node.
+        bool whole;        ///< True if the piece is the subtree of the node, false if it is the node only.
+    };
+
+    static const size_t PiecesPerThread = 16;  ///< The number of pieces the tree is cut into for each thread.
+    static const size_t WindowsPerExport = 4;  ///< The number of windows the pieces are formatted in.
+
+    ThreadPool& pool; ///< The threads the pieces are formatted on.
+
+    /**
+     * @brief Cut a tree into pieces that follow its in-order sequence.
+     * @param root The root of the tree.
+     * @param target The number of pieces to reach, if the tree is large enough.
+     * @return The pieces, in order.
+     */
+    static vector<Piece> partition(const Node* root, size_t target);
+
+    /**
+     * @brief Format the rows of the students of a piece, in name order.
+     * @param piece The piece.
+     * @param out The buffer the rows are appended to.
+     * @param layout If not null, receives where the rows of each student are in the buffer.
+     */
+    static void format(const Piece& piece, string& out, vector<StudentRows>* layout);
+
+public:
+    /**
+     * @brief Constructor for the RosterExporter class.
+     * @param pool The threads the roster is formatted on.
+     */
+    explicit RosterExporter(ThreadPool& pool);
+
+    /**
+     * @brief Format the rows of a student, one per enrollment, as they are in the file.
+     * @param student The student.
+     * @param out The buffer the rows are appended to.
+     */
+    static void formatStudent(const Student& student, string& out);
+
+    /**
+     * @brief Write the roster to a CSV file, atomically.
+     * @param students The roster.
+     * @param path The path of the file.
+     * @param layout If not null, receives where the rows of each student are in the file, in the order of the file.
+     * @return True if the file was written, otherwise false.
+     */
+    bool exportCsv(const StudentBST& students, const string& path, vector<StudentRows>* layout = nullptr) const;
+};
+
+#endif //PROJETO_AED_ROSTEREXPORTER_H
@@ -0,0 +1,298 @@
+/**
+ * @file RosterTracker.cpp
+ * @brief Implementation of the RosterTracker class.
+ */
+
+#include "RosterTracker.h"
+#include "JournalFile.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Constructor for the RosterTracker class, starts observing the commits of a context.
+ *
+ * The changed students are only kept once there is an export to compare them with.
+ *
+ * @param context The data context.
+ */
+RosterTracker::RosterTracker(shared_ptr<DataContext> context) : context(std::move(context)), fileSize(0), fileTime(0) {
+    observerId = this->context->addCommitObserver([this](const vector<const Student*>& students) {
+        if (!path.empty()) {
+            for (const Student* student : students) {
+                dirty.insert(student->StudentCode);
+            }
+        }
+    });
+}
+
+/**
+ * @brief Destructor for the RosterTracker class, stops observing the commits.
+ */
+RosterTracker::~RosterTracker() {
+    context->removeCommitObserver(observerId);
+}
+
+/**
+ * @brief Reads the size and modification time of the exported file.
+ *
+ * @param size Receives the size of the file.
+ * @param time Receives the modification time of the file, in nanoseconds.
+ * @return True if the file exists, otherwise false.
+ */
+bool RosterTracker::statFile(int64_t& size, int64_t& time) const {
+    struct stat status = {};
+    if (::stat(path.c_str(), &status) != 0) {
+        return false;
+    }
+    size = (int64_t) status.st_size;
+    time = (int64_t) status.st_mtim.tv_sec * 1000000000 + status.st_mtim.tv_nsec;
+    return true;
+}
+
+/**
+ * @brief Finds where the rows of a student are in the file, by binary search.
+ *
+ * @param studentCode The code of the student.
+ * @return The rows of the student, or nullptr if the student isn't in the file.
+ *
+ * @complexity O(log n), where n is the number of students.
+ */
+const StudentRows* RosterTracker::findRows(int studentCode) const {
+    auto it = lower_bound(layout.begin(), layout.end(), studentCode, [](const StudentRows& rows, int code) {
+        return rows.studentCode < code;
+    });
+    return it != layout.end() && it->studentCode == studentCode ? &*it : nullptr;
+}
+
+/**
+ * @brief Gets the enrollment of a student as of the last export.
+ *
+ * It is the one kept in memory if the rows of the student in the file are behind, otherwise it is
+ * parsed from its rows: the UC and class codes are the last two fields of each row.
+ *
+ * @param fd The descriptor of the exported file, open for reading.
+ * @param studentCode The code of the student.
+ * @param enrollment Receives the enrollment.
+ * @return True if the enrollment was read, false if the rows of the student couldn't be read.
+ *
+ * @complexity O(r + log n), where r is the size of the rows of the student and n the number of students.
+ */
+bool RosterTracker::exportedEnrollment(int fd, int studentCode, vector<Class>& enrollment) const {
+    enrollment.clear();
+    auto kept = overlay.find(studentCode);
+    if (kept != overlay.end()) {
+        enrollment = kept->second;
+        return true;
+    }
+    const StudentRows* rows = findRows(studentCode);
+    if (rows == nullptr) {
+        return false;
+    }
+    string data(rows->length, '\0');
+    if (rows->length > 0 && ::pread(fd, &data[0], data.size(), (off_t) rows->offset) != (ssize_t) data.size()) {
+        return false;
+    }
+
+    string prefix = to_string(studentCode) + ",";
+    size_t start = 0;
+    while (start < data.size()) {
+        size_t end = data.find('\n', start);
+        if (end == string::npos || data.compare(start, prefix.size(), prefix) != 0) {
+            return false;
+        }
+        size_t classComma = data.rfind(',', end);
+        size_t ucComma = classComma == string::npos || classComma <= start ? string::npos : data.rfind(',', classComma - 1);
+        if (ucComma == string::npos || ucComma <= start + prefix.size() - 1) {
+            return false;
+        }
+        enrollment.emplace_back(data.substr(ucComma + 1, classComma - ucComma - 1), data.substr(classComma + 1, end - classComma - 1));
+        start = end + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks if there is a full export of this run to compute the changes from.
+ *
+ * @return True after a full export, otherwise false.
+ */
+bool RosterTracker::hasExport() const {
+    return !path.empty();
+}
+
+/**
+ * @brief Gets the path of the file of the last full export.
+ *
+ * @return The path, empty before the first full export.
+ */
+const string& RosterTracker::getPath() const {
+    return path;
+}
+
+/**
+ * @brief Gets the number of students changed since the last export, including the ones changed back.
+ *
+ * @return The number of changed students.
+ */
+size_t RosterTracker::changedStudents() const {
+    return dirty.size();
+}
+
+/**
+ * @brief Exports the whole roster and starts tracking the changes from it.
+ *
+ * @param exporter The exporter that writes the file.
+ * @param exportPath The path of the file.
+ * @return True if the file was written, otherwise false.
+ *
+ * @complexity O(n log n), where n is the number of students, and the export of the roster.
+ */
+bool RosterTracker::exportFull(const RosterExporter& exporter, const string& exportPath) {
+    vector<StudentRows> rows;
+    if (!exporter.exportCsv(context->getStudents(), exportPath, &rows)) {
+        return false;
+    }
+    sort(rows.begin(), rows.end(), [](const StudentRows& a, const StudentRows& b) {
+        return a.studentCode < b.studentCode;
+    });
+    layout.swap(rows);
+    path = exportPath;
+    dirty.clear();
+    overlay.clear();
+    if (!statFile(fileSize, fileTime)) {
+        path.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Exports the enrollments added, removed and changed since the last export to a delta file.
+ *
+ * Each row of the delta file is an enrollment of a changed student: "added" and "removed" for a UC
+ * the student joined or left, "changed" for a UC whose class changed, with the previous class. The
+ * rows are sorted by student code and then in the order of the enrollments. The delta becomes the new
+ * starting point of the changes.
+ *
+ * When patching, the new rows of every student whose rows in the file are behind are written over the
+ * old ones if they all have the same size; otherwise the file is written again in full.
+ *
+ * @param exporter The exporter that writes the file again in full, if patching needs it.
+ * @param deltaPath The path of the delta file.
+ * @param patch True to also bring the exported file up to date, in place when the rows keep their size.
+ * @param summary Receives the counters of the delta.
+ * @param error Receives the reason of a failure.
+ * @return True if the delta was exported, otherwise false.
+ *
+ * @complexity O(c log c + c log n), where c is the number of changed students and n the number of students, or the
+ * export of the roster if the file must be written again.
+ */
+bool RosterTracker::exportDelta(const RosterExporter& exporter, const string& deltaPath, bool patch, DeltaSummary& summary, string& error) {
+    summary = DeltaSummary();
+    int64_t size, time;
+    if (path.empty()) {
+        error = "Export the whole roster first, the changes are computed from it.";
+        return false;
+    }
+    if (!statFile(size, time) || size != fileSize || time != fileTime) {
+        error = "\"" + path + "\" was modified since it was exported, export the whole roster again.";
+        return false;
+    }
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "Could not read \"" + path + "\".";
+        return false;
+    }
+
+    vector<int> codes(dirty.begin(), dirty.end());
+    sort(codes.begin(), codes.end());
+    string out = "Change,StudentCode,StudentName,UcCode,ClassCode,PreviousClassCode\n";
+    vector<Class> before;
+    for (int code : codes) {
+        const Student* student = context->findStudent(code);
+        if (student == nullptr || !exportedEnrollment(fd, code, before)) {
+            ::close(fd);
+            error = "The rows of student " + to_string(code) + " in \"" + path + "\" could not be read, export the whole roster again.";
+            return false;
+        }
+        string prefix = to_string(code) + "," + student->StudentName + ",";
+        size_t rows = out.size();
+        for (const Class& previous : before) {
+            auto now = find_if(student->UcToClasses.begin(), student->UcToClasses.end(), [&previous](const Class& ucClass) {
+                return ucClass.UcCode == previous.UcCode;
+            });
+            if (now == student->UcToClasses.end()) {
+                out += "removed," + prefix + previous.UcCode + "," + previous.ClassCode + ",\n";
+                summary.removed++;
+            } else if (now->ClassCode != previous.ClassCode) {
+                out += "changed," + prefix + previous.UcCode + "," + now->ClassCode + "," + previous.ClassCode + "\n";
+                summary.changed++;
+            }
+        }
+        for (const Class& ucClass : student->UcToClasses) {
+            bool existed = any_of(before.begin(), before.end(), [&ucClass](const Class& previous) {
+                return previous.UcCode == ucClass.UcCode;
+            });
+            if (!existed) {
+                out += "added," + prefix + ucClass.UcCode + "," + ucClass.ClassCode + ",\n";
+                summary.added++;
+            }
+        }
+        if (out.size() > rows) {
+            summary.students++;
+        }
+    }
+    ::close(fd);
+    if (!replaceFile(deltaPath, out)) {
+        error = "Could not write \"" + deltaPath + "\".";
+        return false;
+    }
+
+    for (int code : codes) {
+        overlay[code] = context->findStudent(code)->UcToClasses;
+    }
+    dirty.clear();
+    if (!patch || overlay.empty()) {
+        return true;
+    }
+
+    // Every student whose rows are behind is patched, or none is and the file is written again
+    vector<pair<const StudentRows*, string>> patches;
+    bool sameSizes = true;
+    for (const auto& kept : overlay) {
+        const StudentRows* rows = findRows(kept.first);
+        string formatted;
+        RosterExporter::formatStudent(*context->findStudent(kept.first), formatted);
+        sameSizes = sameSizes && rows != nullptr && formatted.size() == rows->length;
+        patches.emplace_back(rows, std::move(formatted));
+    }
+    if (!sameSizes) {
+        summary.rewritten = true;
+        if (!exportFull(exporter, path)) {
+            error = "Could not write \"" + path + "\" again.";
+            return false;
+        }
+        return true;
+    }
+
+    fd = ::open(path.c_str(), O_WRONLY);
+    bool ok = fd >= 0;
+    for (size_t i = 0; ok && i < patches.size(); i++) {
+        const string& rows = patches[i].second;
+        ok = ::pwrite(fd, rows.data(), rows.size(), (off_t) patches[i].first->offset) == (ssize_t) rows.size();
+    }
+    ok = ok && ::fdatasync(fd) == 0;
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    if (!ok || !statFile(fileSize, fileTime)) {
+        error = "Could not patch \"" + path + "\", export the whole roster again.";
+        path.clear();
+        return false;
+    }
+    summary.patched = patches.size();
+    overlay.clear();
+    return true;
+}
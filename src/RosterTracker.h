@@ -0,0 +1,132 @@
+/**
+ * @file RosterTracker.h
+ * @brief Header file for the RosterTracker class.
+ */
+
+#ifndef PROJETO_AED_ROSTERTRACKER_H
+#define PROJETO_AED_ROSTERTRACKER_H
+
+#include "DataContext.h"
+#include "RosterExporter.h"
+#include <unordered_set>
+
+/**
+ * @struct DeltaSummary
+ * @brief The counters of an exported delta of the roster.
+ */
+struct DeltaSummary {
+    size_t students = 0; ///< The number of students whose enrollment changed.
+    size_t added = 0;    ///< The number of enrollments added.
+    size_t removed = 0;  ///< The number of enrollments removed.
+    size_t changed = 0;  ///< The number of enrollments moved to another class of the same UC.
+    size_t patched = 0;  ///< The number of students whose rows were patched in the exported file.
+    bool rewritten = false; ///< True if the exported file was written again in full, as some rows changed size.
+};
+
+/**
+ * @class RosterTracker
+ * @brief Tracks the students changed since the roster was last exported, to export only the changes.
+ *
+ * The tracker observes the commits of the data context and keeps the codes of the students they changed.
+ * A full export records where the rows of each student are in the file, which then serves as the
+ * enrollment of every student as of the export: a delta compares the current enrollment of the changed
+ * students with their rows, read back from the file. So a delta costs a read and a comparison per
+ * changed student, whatever the size of the roster.
+ *
+ * The file can also be patched in place: the new rows of a changed student are written over its old
+ * rows if they have the same size, which is the case for a change of class. If a student's rows changed
+ * size, the file is written again in full. Without patching, the enrollments of the last delta are kept
+ * in memory for the students whose rows in the file are behind, so the next delta starts from them.
+ *
+ * The layout of the file is only known after a full export of this run, and a file modified by another
+ * program since then (a different size or modification time) must be exported again in full.
+ */
+class RosterTracker {
+private:
+    shared_ptr<DataContext> context;              ///< The data context whose commits are observed.
+    size_t observerId;                            ///< The id of the commit observer.
+    unordered_set<int> dirty;                     ///< The codes of the students changed since the last export.
+    unordered_map<int, vector<Class>> overlay;    ///< The enrollment of the last export of the students whose rows in the file are behind.
+    vector<StudentRows> layout;                   ///< Where the rows of each student are in the file, sorted by student code.
+    string path;                                  ///< The path of the file of the last full export, empty before it.
+    int64_t fileSize;                             ///< The size of the file, as last written.
+    int64_t fileTime;                             ///< The modification time of the file, in nanoseconds, as last written.
+
+    /**
+     * @brief Read the size and modification time of the exported file.
+     * @param size Receives the size of the file.
+     * @param time Receives the modification time of the file, in nanoseconds.
+     * @return True if the file exists, otherwise false.
+     */
+    bool statFile(int64_t& size, int64_t& time) const;
+
+    /**
+     * @brief Find where the rows of a student are in the file.
+     * @param studentCode The code of the student.
+     * @return The rows of the student, or nullptr if the student isn't in the file.
+     */
+    const StudentRows* findRows(int studentCode) const;
+
+    /**
+     * @brief Get the enrollment of a student as of the last export.
+     * @param fd The descriptor of the exported file, open for reading.
+     * @param studentCode The code of the student.
+     * @param enrollment Receives the enrollment.
+     * @return True if the enrollment was read, false if the rows of the student couldn't be read.
+     */
+    bool exportedEnrollment(int fd, int studentCode, vector<Class>& enrollment) const;
+
+public:
+    /**
+     * @brief Constructor for the RosterTracker class, starts observing the commits of a context.
+     * @param context The data context.
+     */
+    explicit RosterTracker(shared_ptr<DataContext> context);
+
+    /**
+     * @brief Destructor for the RosterTracker class, stops observing the commits.
+     */
+    ~RosterTracker();
+
+    RosterTracker(const RosterTracker&) = delete;
+    RosterTracker& operator=(const RosterTracker&) = delete;
+
+    /**
+     * @brief Check if there is a full export of this run to compute the changes from.
+     * @return True after a full export, otherwise false.
+     */
+    bool hasExport() const;
+
+    /**
+     * @brief Get the path of the file of the last full export.
+     * @return The path, empty before the first full export.
+     */
+    const string& getPath() const;
+
+    /**
+     * @brief Get the number of students changed since the last export, including the ones changed back.
+     * @return The number of changed students.
+     */
+    size_t changedStudents() const;
+
+    /**
+     * @brief Export the whole roster and start tracking the changes from it.
+     * @param exporter The exporter that writes the file.
+     * @param exportPath The path of the file.
+     * @return True if the file was written, otherwise false.
+     */
+    bool exportFull(const RosterExporter& exporter, const string& exportPath);
+
+    /**
+     * @brief Export the enrollments added, removed and changed since the last export to a delta file.
+     * @param exporter The exporter that writes the file again in full, if patching needs it.
+     * @param deltaPath The path of the delta file.
+     * @param patch True to also bring the exported file up to date, in place when the rows keep their size.
+     * @param summary Receives the counters of the delta.
+     * @param error Receives the reason of a failure.
+     * @return True if the delta was exported, otherwise false.
+     */
+    bool exportDelta(const RosterExporter& exporter, const string& deltaPath, bool patch, DeltaSummary& summary, string& error);
+};
+
+#endif //PROJETO_AED_ROSTERTRACKER_H
@@ -4,17 +4,33 @@
  */
 
 #include "Script.h"
+#include "Terminal.h"
 
 /**
  * @brief Constructor for the Script class.
- * Initializes the system and consult objects and their data.
+ * Reads the data once into a shared context and initializes the system and consult objects on it.
+ * The roster of the previous runs is restored by the storage engine before the system saves its first state,
+ * and the pending requests, the change logs and the next request id are recovered from the request log.
  */
 
-Script::Script() {
-    System system_;
-    system = system_;
-    global = {system.get_Classes(), system.get_Schedules(), system.get_Students()};
-    consult = Consult(global);
+Script::Script() : requestStore(3, [this](const ChangeRequest& request) { return finalYearFirst(request); }), context(make_shared<DataContext>(ReadData().global)), storage(context, "data/roster"), system(context), consult(context), requestLog("data/requests.log"), rosterTracker(context), exporter(make_unique<ChangeLogExporter>(context->getCatalog(), ExportOptions())) {
+    RequestLog::Recovery recovered = requestLog.takeRecovered();
+    for (const auto& request : recovered.pending) {
+        requestStore.restore(request.first, request.second);
+    }
+    requestStore.reserveIds(recovered.nextId);
+    changeLogs.restore(std::move(recovered.changeLogs));
+}
+
+/**
+ * @brief Adds a change request to the store and records it in the request log.
+ * Returns once the record is on the disk, so an enqueued request survives a crash.
+ * @param request The change request.
+ */
+void Script::enqueueRequest(const ChangeRequest& request) {
+    RequestId id = requestStore.push(request);
+    requestLog.logEnqueued(id, request);
+    requestLog.sync();
 }
 
 /**
@@ -39,25 +55,7 @@ void Script::run() {
         }
 
         if (mainChoice == 1) {
-            while (true) {
-                vector<MenuItem> searchMenu = {
-                        {"\033[1mSchedules\033[0m (student/class)", &Script::searchSchedule},
-                        {"\033[1mStudents Information\033[0m", &Script::searchStudent},
-                        {"\033[1mOccupation of ALL\033[0m (classes/UCs/years)", &Script::searchAllOccupations},
-                        {"\033[1mOccupation of the\033[0m (classes of a UC/UCs of a year)", &Script::searchSpecificOccupation},
-                        {"\033[1mList of students registered in a\033[0m (class/UC/year)", &Script::searchListOfStudents},
-                        {"\033[1mList of students registered in at least N UCs\033[0m", &Script::listOfStudentsInAtLeastNUCs},
-                        {"[Back]", nullptr}
-                };
-
-                int searchChoice = showMenu("Search Menu", searchMenu);
-                if (searchChoice == 7) {
-                    break;  // Go back to the main menu
-                }
-                if (searchChoice >=1 && searchChoice < 7 && searchMenu[searchChoice - 1].action != nullptr) {
-                    (this->*searchMenu[searchChoice - 1].action)();
-                }
-            }
+            searchMenu("Search Menu");
         } else if (mainChoice == 2) {
             while (true) {
                 vector<MenuItem> requestMenu = {
@@ -114,6 +112,30 @@ void Script::run() {
     cout << "Goodbye!" << endl;
 }
 
+/**
+ * @brief Gives the priority class of a change request, students of the final year first.
+ *
+ * The year of a student is the highest year of their classes (the first digit of the class code),
+ * 3rd year students are in priority class 0, 2nd year in class 1 and the others in class 2.
+ *
+ * @param request The change request.
+ * @return The priority class of the request.
+ */
+size_t Script::finalYearFirst(const ChangeRequest& request) {
+    int studentCode = studentsOf(request).front();
+
+    const Student* student = context->findStudent(studentCode);
+    int year = 0;
+    if (student != nullptr) {
+        for (const Class& ucClass : student->UcToClasses) {
+            if (!ucClass.ClassCode.empty() && isdigit(ucClass.ClassCode[0])) {
+                year = max(year, ucClass.ClassCode[0] - '0');
+            }
+        }
+    }
+    return year >= 3 ? 0 : year == 2 ? 1 : 2;
+}
+
 /**
  * @brief Draws a box around the given text.
  * @param text The text to display within the box.
@@ -156,9 +178,11 @@ int Script::showMenu(const string& menuName, const vector<MenuItem>& menuItems)
 
 /**
  * @brief Clears the console screen.
+ *
+ * The next screen replaces the current one when it is complete, see Terminal.
  */
 void Script::clearScreen() {
-    cout << "\033[2J\033[H";
+    Terminal::clear();
 }
 
 /**
@@ -178,24 +202,76 @@ void Script::backToMenu() {
 }
 
 /**
- * @brief Updates the global data and saves the current state.
- * @param global The global data to update with.
+ * @brief Commits the transaction of an accepted request, or rolls it back otherwise, and registers its change log.
+ * An accepted change is recorded in the undo history, and its log entry keeps the id of the change and the time
+ * the roster history gave to its commit.
+ * @param transaction The write transaction the request was processed in.
+ * @param logEntry The change log entry of the processed request.
+ */
+void Script::commitRequest(WriteTransaction& transaction, const ChangeLogEntry& logEntry) {
+    ChangeLogEntry entry = logEntry;
+    if (entry.accepted) {
+        transaction.commit();
+        entry.timestamp = storage.lastCommitTime();
+        entry.changeId = system.recordChange(transaction);
+    } else {
+        transaction.rollback();
+    }
+    logChange(entry);
+}
+
+/**
+ * @brief Adds an entry to the change logs and queues it for the export stream.
+ * The entry is written to the export files by the exporter thread, so logging never waits for the disk.
+ * @param entry The change log entry.
  */
-void Script::updateData(Global global) {
-    system.updateData(global);
-    system.saveCurrentState();
-    consult.updateData(global);
+void Script::logChange(const ChangeLogEntry& entry) {
+    changeLogs.append(entry);
+    exporter->push(changeLogs.size() - 1, entry);
 }
 
 /**
- * @brief Undoes the last action.
- * Reverts the system to the previous state.
+ * @brief Marks the change log entries of some changes as reversed or restored by the administrator.
+ * The entries are found through the change index of the change logs, and each updated entry is recorded
+ * in the request log, after the roster journal is synced.
+ * @param changeIds The ids of the changes in the undo history.
+ * @param reversed True if the changes were undone, false if they were redone.
  */
-void Script::undoAction() {
-    //stack implemented in system
-    system.undoAction();
-    global = {system.get_Classes(), system.get_Schedules(), system.get_Students()};
-    consult.updateData(global);
+void Script::markChanges(const vector<size_t>& changeIds, bool reversed) {
+    vector<size_t> positions = changeLogs.positionsOfChanges(changeIds);
+    changeLogs.mark(positions, !reversed, reversed ? LogReason::ReversedByAdministrator : LogReason::RestoredByAdministrator);
+    for (size_t position : positions) {
+        requestLog.logUpdated(position, changeLogs[position]);
+        exporter->push(position, changeLogs[position]);
+    }
+    storage.sync();
+    requestLog.sync();
+}
+
+/**
+ * @brief Displays the search menu until the user goes back.
+ * @param menuName The title of the menu.
+ */
+void Script::searchMenu(const string& menuName) {
+    while (true) {
+        vector<MenuItem> searchMenu = {
+                {"\033[1mSchedules\033[0m (student/class)", &Script::searchSchedule},
+                {"\033[1mStudents Information\033[0m", &Script::searchStudent},
+                {"\033[1mOccupation of ALL\033[0m (classes/UCs/years)", &Script::searchAllOccupations},
+                {"\033[1mOccupation of the\033[0m (classes of a UC/UCs of a year)", &Script::searchSpecificOccupation},
+                {"\033[1mList of students registered in a\033[0m (class/UC/year)", &Script::searchListOfStudents},
+                {"\033[1mList of students registered in at least N UCs\033[0m", &Script::listOfStudentsInAtLeastNUCs},
+                {"[Back]", nullptr}
+        };
+
+        int searchChoice = showMenu(menuName, searchMenu);
+        if (searchChoice == 7) {
+            break;  // Go back to the previous menu
+        }
+        if (searchChoice >=1 && searchChoice < 7 && searchMenu[searchChoice - 1].action != nullptr) {
+            (this->*searchMenu[searchChoice - 1].action)();
+        }
+    }
 }
 
 /**
@@ -485,108 +561,129 @@ void Script::listOfStudentsInAtLeastNUCs() {
     backToMenu();
 }
 
+/**
+ * @brief Displays the details of a pending class change.
+ *
+ * @param request The pending request.
+ */
+template<>
+void Script::printPendingRequest<ChangeClassRequest>(const ChangeClassRequest& request, const int&) {
+    cout << "Student Name: " << context->findStudent(request.studentCode)->StudentName << endl;
+    cout << "Request Type: " << requestTypeName<ChangeClassRequest>() << endl;
+    cout << "Current UC Code: " << context->getUcCode(request.currentUc) << endl;
+    cout << "Current Class Code: " << context->getClassCode(request.currentClass) << endl;
+    cout << "New Class Code: " << context->getClassCode(request.newClass) << endl;
+}
+
+/**
+ * @brief Displays the details of a pending UC change.
+ *
+ * @param request The pending request.
+ */
+template<>
+void Script::printPendingRequest<ChangeUcRequest>(const ChangeUcRequest& request, const int&) {
+    cout << "Student Name: " << context->findStudent(request.studentCode)->StudentName << endl;
+    cout << "Request Type: " << requestTypeName<ChangeUcRequest>() << endl;
+    cout << "Current UC Code: " << context->getUcCode(request.currentUc) << endl;
+    cout << "Current Class Code: " << context->getClassCode(request.currentClass) << endl;
+    cout << "New UC Code: " << context->getUcCode(request.newUc) << endl;
+}
+
+/**
+ * @brief Displays the details of a pending request to leave a UC.
+ *
+ * @param request The pending request.
+ */
+template<>
+void Script::printPendingRequest<LeaveUcClassRequest>(const LeaveUcClassRequest& request, const int&) {
+    cout << "Student Name: " << context->findStudent(request.studentCode)->StudentName << endl;
+    cout << "Request Type: " << requestTypeName<LeaveUcClassRequest>() << endl;
+    cout << "Current UC Code: " << context->getUcCode(request.currentUc) << endl;
+    cout << "Current Class Code: " << context->getClassCode(request.currentClass) << endl;
+}
+
+/**
+ * @brief Displays the details of a pending request to join a UC.
+ *
+ * @param request The pending request.
+ */
+template<>
+void Script::printPendingRequest<JoinUcClassRequest>(const JoinUcClassRequest& request, const int&) {
+    cout << "Student Name: " << context->findStudent(request.studentCode)->StudentName << endl;
+    cout << "Request Type: " << requestTypeName<JoinUcClassRequest>() << endl;
+    cout << "New UC Code: " << context->getUcCode(request.newUc) << endl;
+}
+
+/**
+ * @brief Displays the details of a pending class swap, from the point of view of the given student.
+ *
+ * @param request The pending request.
+ * @param studentCode The code of the student involved in the request.
+ */
+template<>
+void Script::printPendingRequest<SwapClassesRequest>(const SwapClassesRequest& request, const int& studentCode) {
+    bool first = request.studentCode1 == studentCode;
+    cout << "Student Name: " << context->findStudent(studentCode)->StudentName << endl;
+    cout << "Request Type: " << requestTypeName<SwapClassesRequest>() << endl;
+    cout << "UC Code: " << context->getUcCode(request.uc) << endl;
+    cout << "Current Class Code: " << context->getClassCode(first ? request.class1 : request.class2) << endl;
+    cout << "New Class Code: " << context->getClassCode(first ? request.class2 : request.class1) << endl;
+}
+
+/**
+ * @brief Displays the details of a pending change request from the point of view of a student.
+ *
+ * @param request The pending change request.
+ * @param studentCode The code of the student involved in the request.
+ */
+void Script::printPendingRequest(const ChangeRequest& request, const int& studentCode) {
+    visit([this, &studentCode](const auto& data) { printPendingRequest(data, studentCode); }, request.requestData);
+}
+
 /**
  * @brief Displays pending change requests for a specific student and allows for request cancellation.
  *
- * This function iterates through pending change requests in the queue and displays the relevant
- * information based on the request type. The student can choose to cancel a request if desired.
+ * The requests of the student are found through the student index of the request store, wherever they are
+ * in the queue, and any of them can be canceled.
  *
  * @param studentCode The code of the student for whom pending requests should be displayed.
  */
 void Script::pendingRequest(const int& studentCode) {
-    while (!changeRequestQueue.empty()) {
-        const ChangeRequest& changeRequest = changeRequestQueue.front();
-        cout << "\n";
-        cout << "\033[1m[Pending request]\033[0m" << endl;
-
-        // Check the request type and display relevant information
-        if (changeRequest.requestType == "ChangeClassRequest") {
-            const ChangeClassRequest& data = get<ChangeClassRequest>(changeRequest.requestData);
-            // Display ChangeClassRequest details
-            if (data.student->StudentCode == studentCode) {
-                cout << "Student Name: " << data.student->StudentName << endl;
-                cout << "Request Type: " << changeRequest.requestType << endl;
-                cout << "Current UC Code: " << data.currentUcCode << endl;
-                cout << "Current Class Code: " << data.currentClassCode << endl;
-                cout << "New Class Code: " << data.newClassCode << endl;
-            }
-        } else if (changeRequest.requestType == "ChangeUcRequest") {
-            const ChangeUcRequest& data = get<ChangeUcRequest>(changeRequest.requestData);
-            // Display ChangeUcRequest details
-            if (data.student->StudentCode == studentCode) {
-                cout << "Student Name: " << data.student->StudentName << endl;
-                cout << "Request Type: " << changeRequest.requestType << endl;
-                cout << "Current UC Code: " << data.currentUcCode << endl;
-                cout << "Current Class Code: " << data.currentClassCode << endl;
-                cout << "New UC Code: " << data.newUcCode << endl;
-            }
-        } else if (changeRequest.requestType == "LeaveUcClassRequest") {
-            const LeaveUcClassRequest& data = get<LeaveUcClassRequest>(changeRequest.requestData);
-            // Display LeaveUcClassRequest details
-            if (data.student->StudentCode == studentCode) {
-                cout << "Student Name: " << data.student->StudentName << endl;
-                cout << "Request Type: " << changeRequest.requestType << endl;
-                cout << "Current UC Code: " << data.currentUcCode << endl;
-                cout << "Current Class Code: " << data.currentClassCode << endl;
-            }
-        } else if (changeRequest.requestType == "JoinUcClassRequest") {
-            const JoinUcClassRequest& data = get<JoinUcClassRequest>(changeRequest.requestData);
-            // Display JoinUcClassRequest details
-            if (data.student->StudentCode == studentCode) {
-                cout << "Student Name: " << data.student->StudentName << endl;
-                cout << "Request Type: " << changeRequest.requestType << endl;
-                cout << "New UC Code: " << data.newUcCode << endl;
-            }
-        } else if (changeRequest.requestType == "SwapClassesRequest") {
-            const SwapClassesRequest& data = get<SwapClassesRequest>(changeRequest.requestData);
-            // Display SwapClassesRequest details
-            if (data.student1->StudentCode == studentCode) {
-                cout << "Student Name: " << data.student1->StudentName << endl;
-                cout << "Request Type: " << changeRequest.requestType << endl;
-                cout << "UC Code: " << data.ucCode << endl;
-                cout << "Current Class Code: " << data.classCode1 << endl;
-                cout << "New Class Code: " << data.classCode2 << endl;
-            } else if (data.student2->StudentCode == studentCode) {
-                cout << "Student Name: " << data.student2->StudentName << endl;
-                cout << "Request Type: " << changeRequest.requestType << endl;
-                cout << "UC Code: " << data.ucCode << endl;
-                cout << "Current Class Code: " << data.classCode2 << endl;
-                cout << "New Class Code: " << data.classCode1 << endl;
-            }
-        }
-        cout << "\n";
-        cout << "Please wait for it to be reviewed..." << endl;
-        cout << "\n";
-        cout << "1. [Back]" << endl;
-        cout << "2. [Cancel request]" << endl;
+    vector<RequestId> ids = requestStore.requestsOf(studentCode);
+    for (size_t i = 0; i < ids.size(); i++) {
         cout << "\n";
+        cout << "\033[1m[Pending request" << (ids.size() > 1 ? " " + to_string(i + 1) : "") << "]\033[0m" << endl;
+        printPendingRequest(requestStore.get(ids[i]), studentCode);
+    }
+    cout << "\n";
+    cout << "Please wait for it to be reviewed..." << endl;
+    cout << "\n";
+    cout << "1. [Back]" << endl;
+    for (size_t i = 0; i < ids.size(); i++) {
+        cout << i + 2 << ". [Cancel request" << (ids.size() > 1 ? " " + to_string(i + 1) : "") << "]" << endl;
+    }
+    cout << "\n";
 
-        int choice;
-        bool validChoice = false;
-
-        while (!validChoice) {
-            cout << "Enter your choice: ";
-            cin >> choice;
-            if (choice == 1) {
-                return; //go back
-            } else if (choice == 2) {
-                validChoice = true; // Set flag to exit the loop
-                if (changeRequest.requestType == "SwapClassesRequest") {
-                    // Handle request cancellation for SwapClassesRequest
-                    const SwapClassesRequest& data = get<SwapClassesRequest>(changeRequest.requestData);
-                    studentHasPendingRequest[data.student1->StudentCode] = false;
-                    studentHasPendingRequest[data.student2->StudentCode] = false;
-                }
-                changeRequestQueue.pop();
-                studentHasPendingRequest[studentCode] = false;
-                cout << "\033[1mRequest canceled successfully.\033[0m" << endl;
-                cout << "\n";
-            } else {
-                cerr << "ERROR: Invalid input. Please enter a valid choice." << endl;
-                cin.clear();  // Clear error flags
-                cin.ignore(numeric_limits<streamsize>::max(), '\n');  // Clear the input buffer
-                cout << "\n";
-            }
+    int choice;
+    bool validChoice = false;
+
+    while (!validChoice) {
+        cout << "Enter your choice: ";
+        cin >> choice;
+        if (choice == 1) {
+            return; //go back
+        } else if (choice >= 2 && choice < (int) ids.size() + 2) {
+            validChoice = true; // Set flag to exit the loop
+            requestStore.remove(ids[choice - 2]); // A swap request is canceled for both students
+            requestLog.logCanceled(ids[choice - 2]);
+            requestLog.sync();
+            cout << "\033[1mRequest canceled successfully.\033[0m" << endl;
+            cout << "\n";
+        } else {
+            cerr << "ERROR: Invalid input. Please enter a valid choice." << endl;
+            cin.clear();  // Clear error flags
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');  // Clear the input buffer
+            cout << "\n";
         }
     }
 }
@@ -608,13 +705,13 @@ void Script::changeClass() {
     cout << "Enter student code: ";
     cin >> studentCode;
 
-    if (studentHasPendingRequest[studentCode]) {
+    if (requestStore.hasPending(studentCode)) {
         pendingRequest(studentCode);
     } else {
-        Student* student = global.Students.searchByCode(studentCode);
+        Student* student = context->findStudent(studentCode);
 
         if (student) {
-            request.student = student;
+            request.studentCode = student->StudentCode;
             clearScreen();
 
             cout << "Student Code: " << student->StudentCode << endl;
@@ -650,27 +747,42 @@ void Script::changeClass() {
             }
 
             const Class& selectedClass = student->UcToClasses[choice - 1];
-            request.currentUcCode = selectedClass.UcCode;
-            request.currentClassCode = selectedClass.ClassCode;
+            request.currentUc = context->getUcId(selectedClass.UcCode);
+            request.currentClass = context->getClassId(selectedClass.ClassCode);
 
-            cout << "You've chosen " << request.currentUcCode << ", " << request.currentClassCode << endl;
+            cout << "You've chosen " << selectedClass.UcCode << ", " << selectedClass.ClassCode << endl;
             cout << "\n";
 
-            cout << "These are the possible classes and respective number of students in " << request.currentUcCode << " you can choose: " << endl;
+            cout << "These are the possible classes and respective number of students in " << selectedClass.UcCode << " you can choose: " << endl;
             cout << "(Please note that it can be more challenging to switch to a class with a larger number of students compared to one with fewer students.)" << endl;
+            cout << "(Classes in grey would be denied right now, the reason is shown next to them.)" << endl;
+            cout << "(A change denied by capacity or balance can still be requested, it is accepted if it forms a cycle with other requests.)" << endl;
 
             index = 1;
 
-            map<string, int> classStudentsCount;
-            global.Students.getStudentsCountInClass(selectedClass.UcCode, classStudentsCount);
+            // Evaluate every option on the current data, without enqueueing it, to grey out the ones bound to fail
+            Change change(context);
+            const map<string, int>& classStudentsCount = context->getClassOccupancy(selectedClass.UcCode);
             map<int, string> correspondingClassCode;
+            map<int, ChangeOutcome> deniedOutcome;
             for (const auto& classes : classStudentsCount) {
-                if (classes.first != request.currentClassCode) {
-                    cout << index << ". " << classes.first << ": " << classes.second << endl;
+                if (classes.first != selectedClass.ClassCode) {
+                    ChangeVerdict verdict = change.evaluateChangeClass(*student, selectedClass.UcCode, selectedClass.ClassCode, classes.first, false);
+                    if (verdict.accepted) {
+                        cout << index << ". " << classes.first << ": " << classes.second << endl;
+                    } else {
+                        cout << "\033[2m" << index << ". " << classes.first << ": " << classes.second
+                             << " (" << describeOutcome(verdict.outcome) << ")\033[0m" << endl;
+                        // Capacity and balance don't matter in a cycle of class changes, so only the other reasons are final
+                        if (verdict.outcome != ChangeOutcome::CapacityExceeded && verdict.outcome != ChangeOutcome::BalanceDisturbed) {
+                            deniedOutcome[index] = verdict.outcome;
+                        }
+                    }
                     correspondingClassCode[index] = classes.first;
                     index++;
                 }
             }
+            cout << "0. [Back]" << endl;
 
             cout << "\n";
             validChoice = false;
@@ -678,10 +790,16 @@ void Script::changeClass() {
             while (!validChoice) {
                 cout << "Choose the class you'd wish to change to: ";
                 cin >> choice;
+                if (choice == 0) {
+                    return; //go back
+                }
 
                 // Check if user's choice is valid
-                if (choice >= 1 && choice <= classStudentsCount.size()) {
-                    request.newClassCode = correspondingClassCode[choice];
+                if (deniedOutcome.find(choice) != deniedOutcome.end()) {
+                    cerr << "ERROR: This change would be denied (" << describeOutcome(deniedOutcome[choice]) << "). Please choose another class." << endl;
+                    cout << "\n";
+                } else if (correspondingClassCode.find(choice) != correspondingClassCode.end()) {
+                    request.newClass = context->getClassId(correspondingClassCode[choice]);
                     validChoice = true; // Set flag to exit the loop
                 } else {
                     cerr << "Invalid input. Please enter a valid choice." << endl;
@@ -691,15 +809,13 @@ void Script::changeClass() {
                 }
             }
 
-            cout << "You've chosen to change to " << request.newClassCode << endl;
+            cout << "You've chosen to change to " << context->getClassCode(request.newClass) << endl;
             cout << "\n";
 
             ChangeRequest changeRequest;
-            changeRequest.requestType = "ChangeClassRequest";
             changeRequest.requestData = request;
 
-            changeRequestQueue.push(changeRequest);
-            studentHasPendingRequest[studentCode] = true;
+            enqueueRequest(changeRequest);
 
             cout << "\033[1mChangeClass request enqueued for admin review.\033[0m" << endl << endl;
         } else {
@@ -725,13 +841,13 @@ void Script::changeUC() {
     cout << "Enter student code: ";
     cin >> studentCode;
 
-    if (studentHasPendingRequest[studentCode]) {
+    if (requestStore.hasPending(studentCode)) {
         pendingRequest(studentCode);
     } else {
-        Student* student = global.Students.searchByCode(studentCode);
+        Student* student = context->findStudent(studentCode);
 
         if (student) {
-            request.student = student;
+            request.studentCode = student->StudentCode;
             clearScreen();
 
             cout << "Student Code: " << student->StudentCode << endl;
@@ -769,10 +885,10 @@ void Script::changeUC() {
             }
 
             const Class& selectedClass = student->UcToClasses[choice - 1];
-            request.currentUcCode = selectedClass.UcCode;
-            request.currentClassCode = selectedClass.ClassCode;
+            request.currentUc = context->getUcId(selectedClass.UcCode);
+            request.currentClass = context->getClassId(selectedClass.ClassCode);
 
-            cout << "You've chosen " << request.currentUcCode << ", " << request.currentClassCode << endl;
+            cout << "You've chosen " << selectedClass.UcCode << ", " << selectedClass.ClassCode << endl;
             cout << "\n";
             cout << "These are the UCs you are not registered in: " << endl;
             cout << "(Please be aware that if you change your UC, you will be assigned to a compatible class based on your schedule.)" << endl;
@@ -780,7 +896,7 @@ void Script::changeUC() {
             index = 1;
             set<string> uniqueUcCodes;
             map<int, string> correspondingUcCode;
-            for (const Class& classes: global.Classes) {
+            for (const Class& classes: context->getClasses()) {
                 const string& ucCode = classes.UcCode;
                 if (uniqueUcCodes.find(ucCode) == uniqueUcCodes.end() && studentUcCodes.find(ucCode) == studentUcCodes.end()) {
                     cout << index << ". " << ucCode << endl;
@@ -797,8 +913,8 @@ void Script::changeUC() {
                 cin >> choice;
 
                 // Check if user's choice is valid
-                if (choice >= 1 && choice <= index) {
-                    request.newUcCode = correspondingUcCode[choice];
+                if (choice >= 1 && choice < index) {
+                    request.newUc = context->getUcId(correspondingUcCode[choice]);
                     validChoice = true; // Set flag to exit the loop
                 } else {
                     cerr << "Invalid input. Please enter a valid choice." << endl;
@@ -808,15 +924,13 @@ void Script::changeUC() {
                 }
             }
 
-            cout << "You've chosen to change to " << request.newUcCode << endl;
+            cout << "You've chosen to change to " << context->getUcCode(request.newUc) << endl;
             cout << "\n";
 
             ChangeRequest changeRequest;
-            changeRequest.requestType = "ChangeUcRequest";
             changeRequest.requestData = request;
 
-            changeRequestQueue.push(changeRequest);
-            studentHasPendingRequest[studentCode] = true;
+            enqueueRequest(changeRequest);
 
             cout << "\033[1mChangeUc request enqueued for admin review.\033[0m" << endl << endl;
         } else {
@@ -842,13 +956,13 @@ void Script::leaveUCAndClass() {
     cout << "Enter student code: ";
     cin >> studentCode;
 
-    if (studentHasPendingRequest[studentCode]) {
+    if (requestStore.hasPending(studentCode)) {
         pendingRequest(studentCode);
     } else {
-        Student* student = global.Students.searchByCode(studentCode);
+        Student* student = context->findStudent(studentCode);
 
         if (student) {
-            request.student = student;
+            request.studentCode = student->StudentCode;
             clearScreen();
 
             cout << "Student Code: " << student->StudentCode << endl;
@@ -885,18 +999,16 @@ void Script::leaveUCAndClass() {
             }
 
             const Class& selectedClass = student->UcToClasses[choice - 1];
-            request.currentUcCode = selectedClass.UcCode;
-            request.currentClassCode = selectedClass.ClassCode;
+            request.currentUc = context->getUcId(selectedClass.UcCode);
+            request.currentClass = context->getClassId(selectedClass.ClassCode);
 
-            cout << "You've chosen to leave " << request.currentUcCode << ", " << request.currentClassCode << endl;
+            cout << "You've chosen to leave " << selectedClass.UcCode << ", " << selectedClass.ClassCode << endl;
             cout << "\n";
 
             ChangeRequest changeRequest;
-            changeRequest.requestType = "LeaveUcClassRequest";
             changeRequest.requestData = request;
 
-            changeRequestQueue.push(changeRequest);
-            studentHasPendingRequest[studentCode] = true;
+            enqueueRequest(changeRequest);
 
             cout << "\033[1mLeaveUcClass request enqueued for admin review.\033[0m" << endl << endl;
         } else {
@@ -922,13 +1034,13 @@ void Script::joinUCAndClass() {
     cout << "Enter student code: ";
     cin >> studentCode;
 
-    if (studentHasPendingRequest[studentCode]) {
+    if (requestStore.hasPending(studentCode)) {
         pendingRequest(studentCode);
     } else {
-        Student* student = global.Students.searchByCode(studentCode);
+        Student* student = context->findStudent(studentCode);
 
         if (student) {
-            request.student = student;
+            request.studentCode = student->StudentCode;
             clearScreen();
 
             cout << "Student Code: " << student->StudentCode << endl;
@@ -951,7 +1063,7 @@ void Script::joinUCAndClass() {
             index = 1;
             set<string> uniqueUcCodes;
             map<int, string> correspondingUcCode;
-            for (const Class& classes: global.Classes) {
+            for (const Class& classes: context->getClasses()) {
                 const string& ucCode = classes.UcCode;
                 if (uniqueUcCodes.find(ucCode) == uniqueUcCodes.end() && studentUcCodes.find(ucCode) == studentUcCodes.end()) {
                     cout << index << ". " << ucCode << endl;
@@ -973,7 +1085,7 @@ void Script::joinUCAndClass() {
                 }
                 // Check if user's choice is valid
                 if (choice >= 1 && choice < index) {
-                    request.newUcCode = correspondingUcCode[choice];
+                    request.newUc = context->getUcId(correspondingUcCode[choice]);
                     validChoice = true; // Set flag to exit the loop
                 } else {
                     cerr << "Invalid input. Please enter a valid choice." << endl;
@@ -983,15 +1095,13 @@ void Script::joinUCAndClass() {
                 }
             }
 
-            cout << "You've chosen to join " << request.newUcCode << endl;
+            cout << "You've chosen to join " << context->getUcCode(request.newUc) << endl;
             cout << "\n";
 
             ChangeRequest changeRequest;
-            changeRequest.requestType = "JoinUcClassRequest";
             changeRequest.requestData = request;
 
-            changeRequestQueue.push(changeRequest);
-            studentHasPendingRequest[studentCode] = true;
+            enqueueRequest(changeRequest);
 
             cout << "\033[1mJoinUcClass request enqueued for admin review.\033[0m" << endl << endl;
         } else {
@@ -1017,27 +1127,29 @@ void Script::swapClassesBetweenStudents() {
     cout << "Enter student code (1): ";
     cin >> studentCode1;
 
-    if (studentHasPendingRequest[studentCode1]) {
+    if (requestStore.hasPending(studentCode1)) {
         pendingRequest(studentCode1);
-    } else {
-        cout << "Enter student code (2): ";
-        cin >> studentCode2;
+        backToMenu();
+        return;
+    }
 
-        if (studentCode2 == studentCode1) {
-            cerr << "ERROR: You've entered the same student code twice." << endl;
-            backToMenu();
-            return;
-        }
+    cout << "Enter student code (2): ";
+    cin >> studentCode2;
+
+    if (studentCode2 == studentCode1) {
+        cerr << "ERROR: You've entered the same student code twice." << endl;
+        backToMenu();
+        return;
     }
-    if (studentHasPendingRequest[studentCode2]) {
+    if (requestStore.hasPending(studentCode2)) {
         pendingRequest(studentCode2);
     } else {
-        Student *student1 = global.Students.searchByCode(studentCode1);
-        Student *student2 = global.Students.searchByCode(studentCode2);
+        Student *student1 = context->findStudent(studentCode1);
+        Student *student2 = context->findStudent(studentCode2);
 
         if (student1 && student2) {
-            request.student1 = student1;
-            request.student2 = student2;
+            request.studentCode1 = student1->StudentCode;
+            request.studentCode2 = student2->StudentCode;
             clearScreen();
 
             cout << endl;
@@ -1101,9 +1213,9 @@ void Script::swapClassesBetweenStudents() {
                     const Class& selectedClass = correspondingClass[choice];
                     for (const Class& ucToClass : student2->UcToClasses) {
                         if (ucToClass.UcCode == selectedClass.UcCode) {
-                            request.ucCode = selectedClass.UcCode;
-                            request.classCode1 = selectedClass.ClassCode;
-                            request.classCode2 = ucToClass.ClassCode;
+                            request.uc = context->getUcId(selectedClass.UcCode);
+                            request.class1 = context->getClassId(selectedClass.ClassCode);
+                            request.class2 = context->getClassId(ucToClass.ClassCode);
                             validChoice = true; // Set flag to exit the loop;
                         }
                     }
@@ -1120,18 +1232,15 @@ void Script::swapClassesBetweenStudents() {
                 }
             }
 
-            cout << "You've chosen " << request.ucCode << ": " << endl;
-            cout << request.classCode1 << ", " << student1->StudentName << endl;
-            cout << request.classCode2 << ", " << student2->StudentName << endl;
+            cout << "You've chosen " << context->getUcCode(request.uc) << ": " << endl;
+            cout << context->getClassCode(request.class1) << ", " << student1->StudentName << endl;
+            cout << context->getClassCode(request.class2) << ", " << student2->StudentName << endl;
             cout << "\n";
 
             ChangeRequest changeRequest;
-            changeRequest.requestType = "SwapClassesRequest";
             changeRequest.requestData = request;
 
-            changeRequestQueue.push(changeRequest);
-            studentHasPendingRequest[studentCode1] = true;
-            studentHasPendingRequest[studentCode2] = true;
+            enqueueRequest(changeRequest);
 
             cout << "\033[1mSwapClasses request enqueued for admin review.\033[0m" << endl << endl;
         } else {
@@ -1142,70 +1251,133 @@ void Script::swapClassesBetweenStudents() {
 }
 
 /**
- * @brief Process the frontmost change request from the queue.
+ * @brief Process a class change, the student is resolved by code.
+ *
+ * @param request The request to process.
+ * @param verdict If not null, the verdict of the request already evaluated on the current data.
+ * @return True if the request was accepted, otherwise false.
+ */
+template<>
+bool Script::processRequest<ChangeClassRequest>(const ChangeClassRequest& request, const ChangeVerdict* verdict) {
+    cout << "\033[1mChange Class\033[0m ";
+    Student* student = context->findStudent(request.studentCode);
+    if (student == nullptr) {
+        cerr << "ERROR: Student not found." << endl;
+        return false;
+    }
+    WriteTransaction transaction(*context);
+    Change change(context);
+    change.changeClass(transaction, *student, context->getUcCode(request.currentUc), context->getClassCode(request.currentClass),
+                       context->getClassCode(request.newClass), verdict);
+    commitRequest(transaction, change.logEntry);
+    return change.logEntry.accepted;
+}
+
+/**
+ * @brief Process a UC change.
+ *
+ * @param request The request to process.
+ * @param verdict If not null, the verdict of the request already evaluated on the current data.
+ * @return True if the request was accepted, otherwise false.
+ */
+template<>
+bool Script::processRequest<ChangeUcRequest>(const ChangeUcRequest& request, const ChangeVerdict* verdict) {
+    cout << "\033[1mChange UC\033[0m ";
+    Student* student = context->findStudent(request.studentCode);
+    if (student == nullptr) {
+        cerr << "ERROR: Student not found." << endl;
+        return false;
+    }
+    WriteTransaction transaction(*context);
+    Change change(context);
+    change.changeUC(transaction, *student, context->getUcCode(request.currentUc), context->getClassCode(request.currentClass),
+                    context->getUcCode(request.newUc), verdict);
+    commitRequest(transaction, change.logEntry);
+    return change.logEntry.accepted;
+}
+
+/**
+ * @brief Process a request to leave a UC and class.
+ *
+ * @param request The request to process.
+ * @param verdict If not null, the verdict of the request already evaluated on the current data.
+ * @return True if the request was accepted, otherwise false.
+ */
+template<>
+bool Script::processRequest<LeaveUcClassRequest>(const LeaveUcClassRequest& request, const ChangeVerdict* verdict) {
+    cout << "\033[1mLeave UC and Class\033[0m ";
+    Student* student = context->findStudent(request.studentCode);
+    if (student == nullptr) {
+        cerr << "ERROR: Student not found." << endl;
+        return false;
+    }
+    WriteTransaction transaction(*context);
+    Change change(context);
+    change.leaveUCAndClass(transaction, *student, context->getUcCode(request.currentUc), context->getClassCode(request.currentClass), verdict);
+    commitRequest(transaction, change.logEntry);
+    return change.logEntry.accepted;
+}
+
+/**
+ * @brief Process a request to join a UC and class.
+ *
+ * @param request The request to process.
+ * @param verdict If not null, the verdict of the request already evaluated on the current data.
+ * @return True if the request was accepted, otherwise false.
+ */
+template<>
+bool Script::processRequest<JoinUcClassRequest>(const JoinUcClassRequest& request, const ChangeVerdict* verdict) {
+    cout << "\033[1mJoin UC and Class\033[0m ";
+    Student* student = context->findStudent(request.studentCode);
+    if (student == nullptr) {
+        cerr << "ERROR: Student not found." << endl;
+        return false;
+    }
+    WriteTransaction transaction(*context);
+    Change change(context);
+    change.joinUCAndClass(transaction, *student, context->getUcCode(request.newUc), verdict);
+    commitRequest(transaction, change.logEntry);
+    return change.logEntry.accepted;
+}
+
+/**
+ * @brief Process a class swap between two students.
  *
- * This function dequeues the frontmost change request, processes it according to its type,
- * and updates the system state and logs accordingly.
- */
-void Script::processRequest() {
-    // Dequeue the frontmost change request from the queue
-    ChangeRequest request = changeRequestQueue.front();
-    changeRequestQueue.pop();
-
-    // Check the type of the change request and process it accordingly
-    if (request.requestType == "ChangeClassRequest") {
-        // Process a "Change Class" request
-        cout << "\033[1mChange Class\033[0m ";
-        ChangeClassRequest changeRequest = get<ChangeClassRequest>(request.requestData);
-        Change change(global);
-        change.changeClass(*changeRequest.student, changeRequest.currentUcCode, changeRequest.currentClassCode, changeRequest.newClassCode);
-        studentHasPendingRequest[changeRequest.student->StudentCode] = false;
-        updateData(change.global);
-        changeLogs.push_back(change.logEntry);
-    }
-    else if (request.requestType == "ChangeUcRequest") {
-        // Process a "Change UC" request
-        cout << "\033[1mChange UC\033[0m ";
-        ChangeUcRequest changeRequest = get<ChangeUcRequest>(request.requestData);
-        Change change(global);
-        change.changeUC(*changeRequest.student, changeRequest.currentUcCode, changeRequest.currentClassCode, changeRequest.newUcCode);
-        studentHasPendingRequest[changeRequest.student->StudentCode] = false;
-        updateData(change.global);
-        changeLogs.push_back(change.logEntry);
-    }
-    else if (request.requestType == "LeaveUcClassRequest") {
-        // Process a "Leave UC and Class" request
-        cout << "\033[1mLeave UC and Class\033[0m ";
-        LeaveUcClassRequest changeRequest = get<LeaveUcClassRequest>(request.requestData);
-        Change change(global);
-        change.leaveUCAndClass(*changeRequest.student, changeRequest.currentUcCode, changeRequest.currentClassCode);
-        studentHasPendingRequest[changeRequest.student->StudentCode] = false;
-        updateData(change.global);
-        changeLogs.push_back(change.logEntry);
-    }
-    else if (request.requestType == "JoinUcClassRequest") {
-        // Process a "Join UC and Class" request
-        cout << "\033[1mJoin UC and Class\033[0m ";
-        JoinUcClassRequest changeRequest = get<JoinUcClassRequest>(request.requestData);
-        Change change(global);
-        change.joinUCAndClass(*changeRequest.student, changeRequest.newUcCode);
-        studentHasPendingRequest[changeRequest.student->StudentCode] = false;
-        updateData(change.global);
-        changeLogs.push_back(change.logEntry);
-    }
-    else if (request.requestType == "SwapClassesRequest") {
-        // Process a "Swap Classes" request
-        cout << "\033[1mSwap Classes\033[0m ";
-        SwapClassesRequest changeRequest = get<SwapClassesRequest>(request.requestData);
-        Change change(global);
-        change.swapClassesBetweenStudents(*changeRequest.student1, changeRequest.ucCode, changeRequest.classCode1, *changeRequest.student2, changeRequest.classCode2);
-        studentHasPendingRequest[changeRequest.student1->StudentCode] = false;
-        studentHasPendingRequest[changeRequest.student2->StudentCode] = false;
-        updateData(change.global);
-        changeLogs.push_back(change.logEntry);
+ * @param request The request to process.
+ * @param verdict If not null, the verdict of the request already evaluated on the current data.
+ * @return True if the request was accepted, otherwise false.
+ */
+template<>
+bool Script::processRequest<SwapClassesRequest>(const SwapClassesRequest& request, const ChangeVerdict* verdict) {
+    cout << "\033[1mSwap Classes\033[0m ";
+    Student* student1 = context->findStudent(request.studentCode1);
+    Student* student2 = context->findStudent(request.studentCode2);
+    if (student1 == nullptr || student2 == nullptr) {
+        cerr << "ERROR: Either one or both students not found." << endl;
+        return false;
     }
+    WriteTransaction transaction(*context);
+    Change change(context);
+    change.swapClassesBetweenStudents(transaction, *student1, context->getUcCode(request.uc), context->getClassCode(request.class1),
+                                      *student2, context->getClassCode(request.class2), verdict);
+    commitRequest(transaction, change.logEntry);
+    return change.logEntry.accepted;
+}
 
+/**
+ * @brief Process a change request taken from the queue.
+ *
+ * The request is dispatched on its type to the matching specialization of processRequest,
+ * and the system state and logs are updated accordingly.
+ *
+ * @param request The change request to process.
+ * @param verdict If not null, the verdict of the request already evaluated on the current data.
+ * @return True if the request was accepted, otherwise false.
+ */
+bool Script::processRequest(const ChangeRequest& request, const ChangeVerdict* verdict) {
+    bool accepted = visit([this, verdict](const auto& data) { return processRequest(data, verdict); }, request.requestData);
     cout << endl;
+    return accepted;
 }
 
 /**
@@ -1218,9 +1390,16 @@ void Script::processNextChangeRequest() {
 
     drawBox("Change Requests");
 
-    if (!changeRequestQueue.empty()) {
+    if (!requestStore.empty()) {
+        // Dequeue the next change request from the store and process it
+        RequestId id = requestStore.frontId();
+        ChangeRequest request = requestStore.pop();
+        size_t logged = changeLogs.size();
         cout << "1. ";
-        processRequest(); // Process the next change request
+        processRequest(request);
+        requestLog.logProcessed(id, changeLogs.size() > logged ? &changeLogs.back() : nullptr);
+        storage.sync();
+        requestLog.sync();
     } else {
         cout << "No requests pending." << endl;
         cout << "\n";
@@ -1228,21 +1407,108 @@ void Script::processNextChangeRequest() {
     backToMenu();
 }
 
+/**
+ * @brief Accept the class change requests of the queue that form cycles.
+ *
+ * The cycles found by the CycleResolver among the pending requests are committed one transaction each,
+ * and their requests are removed from the store. The other requests stay where they are.
+ *
+ * @return The number of requests accepted through cycles.
+ */
+int Script::resolveClassChangeCycles() {
+    vector<RequestId> ids = requestStore.pendingIds();
+    vector<ChangeRequest> pending;
+    for (RequestId id : ids) {
+        pending.push_back(requestStore.get(id));
+    }
+
+    vector<vector<size_t>> cycles = CycleResolver(context).findCycles(pending);
+    int accepted = 0;
+
+    for (const vector<size_t>& cycle : cycles) {
+        WriteTransaction transaction(*context);
+        vector<ChangeLogEntry> entries;
+
+        const string& ucCode = context->getUcCode(get<ChangeClassRequest>(pending[cycle.front()].requestData).currentUc);
+        cout << "\033[1mCycle of " << cycle.size() << " class changes\033[0m [" << ucCode << "]:" << endl;
+
+        for (size_t index : cycle) {
+            const ChangeClassRequest& request = get<ChangeClassRequest>(pending[index].requestData);
+            Student& student = *context->findStudent(request.studentCode); // checked by the CycleResolver
+            const string& currentClassCode = context->getClassCode(request.currentClass);
+            const string& newClassCode = context->getClassCode(request.newClass);
+            for (auto& ucToClass : transaction.edit(student).UcToClasses) {
+                if (ucToClass.UcCode == ucCode && ucToClass.ClassCode == currentClassCode) {
+                    ucToClass.ClassCode = newClassCode;
+                }
+            }
+            cout << "   " << student.StudentCode << " , " << student.StudentName
+                 << " [from " << currentClassCode << " to " << newClassCode << "]" << endl;
+
+            ChangeLogEntry logEntry;
+            logEntry.requestType = RequestType::ChangeClass;
+            logEntry.timestamp = getCurrentTime(); //defined in UtilityFunctions
+            logEntry.studentCode = student.StudentCode;
+            logEntry.currentUc = request.currentUc;
+            logEntry.currentClass = request.currentClass;
+            logEntry.newUc = request.currentUc;
+            logEntry.newClass = request.newClass;
+            logEntry.reason = LogReason::AcceptedInCycle;
+            logEntry.cycleLength = (uint16_t) cycle.size();
+            logEntry.accepted = true;
+            entries.push_back(logEntry);
+
+        }
+
+        transaction.commit();
+        size_t changeId = system.recordChange(transaction);
+        int64_t commitTime = storage.lastCommitTime();
+        for (size_t k = 0; k < cycle.size(); k++) {
+            entries[k].changeId = changeId;
+            entries[k].timestamp = commitTime;
+            requestStore.remove(ids[cycle[k]]);
+            requestLog.logProcessed(ids[cycle[k]], &entries[k]);
+        }
+        for (const ChangeLogEntry& entry : entries) {
+            logChange(entry);
+        }
+        accepted += (int) cycle.size();
+        cout << "Cycle of class changes committed successfully!" << endl << endl;
+    }
+
+    return accepted;
+}
+
 /**
  * @brief Process all change requests in the queue.
  *
- * This function processes all change requests in the queue. It then returns to the main menu.
+ * This function processes all change requests in the queue, with the same results as processing them one by one.
+ * It then returns to the main menu.
  */
 void Script::processAllChangeRequests() {
     clearScreen();
 
     drawBox("Change Requests");
-    int i = 1;
-    while (!changeRequestQueue.empty()) {
-        cout << i++ << ". ";
-        processRequest();
+    int resolvedByCycles = resolveClassChangeCycles();
+
+    vector<RequestId> ids = requestStore.pendingIds();
+    vector<ChangeRequest> batch = requestStore.drain();
+
+    // Requests are validated in parallel and applied in queue order, their log records are synced in groups
+    size_t i = 0;
+    BatchProcessor(context, pool).process(batch, [this, &i, &ids](const ChangeRequest& request, const ChangeVerdict* verdict) {
+        size_t logged = changeLogs.size();
+        cout << i + 1 << ". ";
+        bool accepted = processRequest(request, verdict);
+        requestLog.logProcessed(ids[i++], changeLogs.size() > logged ? &changeLogs.back() : nullptr);
+        return accepted;
+    });
+    storage.sync();
+    requestLog.sync();
+    if (resolvedByCycles > 0) {
+        cout << "\033[1m" << resolvedByCycles << " class change requests accepted through cycles.\033[0m" << endl << endl;
     }
-    if (changeRequestQueue.empty()) {
+    if (requestStore.empty()) {
         cout << "No requests pending." << endl;
         cout << "\n";
     }
@@ -1261,6 +1527,9 @@ void Script::changeLogsMenu() {
             {"\033[1mAll Change Logs\033[0m", &Script::allChangeLogs},
             {"\033[1mSuccessful Change Logs\033[0m", &Script::successfulChangeLogs},
             {"\033[1mUnsuccessful Change Logs\033[0m", &Script::failedChangeLogs},
+            {"\033[1mConsult the roster as of a time\033[0m", &Script::consultAsOf},
+            {"\033[1mChange Log Statistics\033[0m", &Script::changeLogStatistics},
+            {"\033[1mChange Log Export Stream\033[0m", &Script::changeLogExport},
             {"[Back]", &Script::actionGoBack}
     };
 
@@ -1285,7 +1554,7 @@ void Script::changeLogsMenu() {
 
         clearScreen();
 
-        if (choice == 4) {
+        if (choice == 7) {
             break; // Go back to the main menu
         } else if (choice >= 1 && choice <= occupationMenu.size()) {
             // Call the selected function based on the user's choice
@@ -1295,76 +1564,265 @@ void Script::changeLogsMenu() {
 }
 
 /**
- * @brief Display all change logs.
+ * @brief The number of change logs displayed in each page of the change log views.
+ */
+static const size_t ChangeLogPageSize = 10;
+
+/**
+ * @brief Display a page of selected change logs, followed by the page number and the filter.
+ *
+ * Only the entries of the page are read from the change logs, so a page costs the same whatever the
+ * number of change logs.
  *
- * This function shows all change logs including accepted and denied requests.
+ * @param shown The positions of the selected change logs, numbered from 1 in the view.
+ * @param page The page to display, from 0.
+ * @param filter The filter the change logs were selected with.
  */
-void Script::allChangeLogs() {
-    clearScreen();
-    drawBox("All Change Logs");
+void Script::printChangeLogPage(const vector<size_t>& shown, size_t page, const ChangeLogFilter& filter) {
+    size_t pages = max<size_t>((shown.size() + ChangeLogPageSize - 1) / ChangeLogPageSize, 1);
+    size_t first = page * ChangeLogPageSize;
+    size_t last = min(first + ChangeLogPageSize, shown.size());
 
-    if (changeLogs.empty()) {
-        cout << "NO LOGS" << endl;
-    } else {
-        int index = 1;
-        for (const auto &entry: changeLogs) {
-            // Display detailed information about each change log entry
-            cout << index++ << ". " << entry.requestType << " (" << entry.timestamp << ")" << endl;
-            cout << "   Student Code: " << entry.studentCode << endl;
-            cout << "   Student Name: " << entry.studentName << endl;
-            cout << "   Current UC Code: " << entry.currentUcCode << " , Class Code: " << entry.currentClassCode << endl;
-            cout << "   New UC Code: " << entry.newUcCode << " , Class Code: " << entry.newClassCode << endl;
-            cout << "   State: ";
-            if (entry.accepted) {
-                cout << "Accepted" << endl;
-            } else {
-                cout << "Denied" << endl;
-            }
-            cout << "   Notes: " << entry.extraNotes << endl << endl;
+    if (shown.empty()) {
+        cout << "NO LOGS" << endl << endl;
+    }
+    // A UC or class id of the entries is InvalidId where the request has none
+    auto code = [](const string& code) { return code.empty() ? string("-") : code; };
+    for (size_t i = first; i < last; i++) {
+        const ChangeLogEntry& entry = changeLogs[shown[i]];
+        const Student* student = context->findStudent(entry.studentCode);
+        // Display detailed information about each change log entry
+        cout << i + 1 << ". " << describeRequestType(entry.requestType) << " (" << formatTimestamp(entry.timestamp) << ")" << endl;
+        cout << "   Student Code: " << entry.studentCode << endl;
+        cout << "   Student Name: " << (student != nullptr ? student->StudentName : "-") << endl;
+        cout << "   Current UC Code: " << code(context->getUcCode(entry.currentUc)) << " , Class Code: " << code(context->getClassCode(entry.currentClass)) << endl;
+        cout << "   New UC Code: " << code(context->getUcCode(entry.newUc)) << " , Class Code: " << code(context->getClassCode(entry.newClass)) << endl;
+        cout << "   State: " << (entry.accepted ? "Accepted" : "Denied") << endl;
+        cout << "   Notes: " << describeNotes(entry, *context) << endl << endl;
+    }
+
+    cout << "Page " << page + 1 << " of " << pages << " (" << shown.size() << " change logs)" << endl;
+    string conditions;
+    if (filter.requestType) {
+        conditions += " type \"" + describeRequestType(*filter.requestType) + "\"";
+    }
+    if (filter.studentCode != 0) {
+        conditions += " student " + to_string(filter.studentCode);
+    }
+    if (filter.uc != InvalidId) {
+        conditions += " UC " + context->getUcCode(filter.uc);
+    }
+    if (filter.from != INT64_MIN) {
+        conditions += " from " + formatTimestamp(filter.from);
+    }
+    if (filter.until != INT64_MAX) {
+        conditions += " before " + formatTimestamp(filter.until);
+    }
+    if (!conditions.empty()) {
+        cout << "Filter:" << conditions << endl;
+    }
+    cout << endl;
+}
+
+/**
+ * @brief Handle the page and filter options shared by the change log views.
+ *
+ * The filter asks for each of its conditions in turn, a blank answer matches every change log. An
+ * invalid answer leaves the filter as it was.
+ *
+ * @param option The option chosen: 1 next page, 2 previous page, 3 go to a page, 4 filter.
+ * @param shown The positions of the selected change logs.
+ * @param page The page displayed, updated by the page options.
+ * @param filter The filter of the view, updated by the filter option.
+ * @return True if the change logs must be selected again with the new filter, otherwise false.
+ */
+bool Script::browseChangeLogs(int option, const vector<size_t>& shown, size_t& page, ChangeLogFilter& filter) {
+    size_t pages = max<size_t>((shown.size() + ChangeLogPageSize - 1) / ChangeLogPageSize, 1);
+    if (option == 1) {
+        page = min(page + 1, pages - 1);
+        return false;
+    }
+    if (option == 2) {
+        page = page > 0 ? page - 1 : 0;
+        return false;
+    }
+    if (option == 3) {
+        size_t number;
+        cout << "Enter the page (1-" << pages << "): ";
+        if (!(cin >> number) || number < 1 || number > pages) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            cerr << "ERROR: Invalid input. Please enter a page between 1 and " << pages << "." << endl;
+            cout << "Press ENTER to continue...";
+            cin.get();
+            return false;
         }
+        page = number - 1;
+        return false;
     }
-    backToMenu();
+    if (option != 4) {
+        return false;
+    }
+
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    ChangeLogFilter edited;
+    edited.state = filter.state;
+    string line;
+    string error;
+
+    cout << endl << "Request type:" << endl;
+    for (size_t i = 0; i < RequestTypeCount; i++) {
+        cout << i + 1 << ". " << describeRequestType((RequestType) i) << endl;
+    }
+    cout << "Enter your choice (blank for any): ";
+    getline(cin, line);
+    if (!line.empty()) {
+        size_t choice = 0;
+        istringstream in(line);
+        if (!(in >> choice) || choice < 1 || choice > RequestTypeCount) {
+            error = "Invalid request type.";
+        } else {
+            edited.requestType = (RequestType) (choice - 1);
+        }
+    }
+
+    cout << "Student code (blank for any): ";
+    getline(cin, line);
+    if (error.empty() && !line.empty()) {
+        istringstream in(line);
+        if (!(in >> edited.studentCode) || edited.studentCode <= 0) {
+            error = "Invalid student code.";
+        }
+    }
+
+    cout << "UC code (blank for any): ";
+    getline(cin, line);
+    if (error.empty() && !line.empty()) {
+        edited.uc = context->getUcId(line);
+        if (edited.uc == InvalidId) {
+            error = "UC " + line + " doesn't exist.";
+        }
+    }
+
+    // The end of the range is the end of the second, minute or day entered
+    time_t time, span;
+    cout << "From (YYYY-MM-DD hh:mm:ss, blank for any): ";
+    getline(cin, line);
+    if (error.empty() && !line.empty()) {
+        if (parseTimestamp(line, time)) {
+            edited.from = (int64_t) time * 1000000000;
+        } else {
+            error = "Invalid time. Please enter it as YYYY-MM-DD hh:mm:ss, YYYY-MM-DD hh:mm or YYYY-MM-DD.";
+        }
+    }
+    cout << "To (YYYY-MM-DD hh:mm:ss, blank for any): ";
+    getline(cin, line);
+    if (error.empty() && !line.empty()) {
+        if (parseTimestamp(line, time, &span)) {
+            edited.until = (int64_t) (time + span) * 1000000000;
+        } else {
+            error = "Invalid time. Please enter it as YYYY-MM-DD hh:mm:ss, YYYY-MM-DD hh:mm or YYYY-MM-DD.";
+        }
+    }
+
+    if (!error.empty()) {
+        cerr << "ERROR: " << error << " The filter was not changed." << endl;
+        cout << "Press ENTER to continue...";
+        cin.get();
+        return false;
+    }
+    filter = edited;
+    page = 0;
+    return true;
+}
+
+/**
+ * @brief Display the change logs of a given state, a page at a time.
+ *
+ * The change logs are selected through the indexes of the change logs once, and again only when the
+ * filter changes; turning a page only displays the entries of that page.
+ *
+ * @param title The title of the view.
+ * @param state The state of the change logs of the view.
+ */
+void Script::viewChangeLogs(const string& title, LogState state) {
+    ChangeLogFilter filter;
+    filter.state = state;
+    vector<size_t> shown = changeLogs.select(filter);
+    size_t page = 0;
+
+    while (true) {
+        clearScreen();
+        drawBox(title);
+        printChangeLogPage(shown, page, filter);
+
+        int choice;
+        cout << "MENU:" << endl;
+        cout << "1. Next page" << endl;
+        cout << "2. Previous page" << endl;
+        cout << "3. Go to page" << endl;
+        cout << "4. Filter (request type, student, UC, time)" << endl;
+        cout << "5. [Back]" << endl;
+        cout << "Enter your choice: ";
+        if (!(cin >> choice)) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            continue;
+        }
+        if (choice == 5) {
+            return;
+        }
+        if (browseChangeLogs(choice, shown, page, filter)) {
+            shown = changeLogs.select(filter);
+        }
+    }
+}
+
+/**
+ * @brief Display all change logs.
+ *
+ * This function shows all change logs including accepted and denied requests, a page at a time.
+ */
+void Script::allChangeLogs() {
+    viewChangeLogs("All Change Logs", LogState::Any);
 }
 
 /**
  * @brief Display successful change logs.
  *
- * This function shows only the successful change logs, i.e., accepted requests, and provides options to undo the last change.
+ * This function shows only the successful change logs, i.e., accepted requests, a page at a time, and provides options to undo the last change,
+ * to undo every change back to one of the list, and to redo the last undone change. The log entries are matched to the
+ * undo history by their change id, so the entries reversed are exactly the ones of the undone changes. The memory
+ * budget of the undo history can be changed too, the oldest changes are squashed if they no longer fit.
  */
 void Script::successfulChangeLogs() {
+    ChangeLogFilter filter;
+    filter.state = LogState::Accepted;
+    vector<size_t> shown = changeLogs.select(filter); // the position in the change logs of each listed entry
+    size_t page = 0;
+
     while (true){
         clearScreen();
         drawBox("Successful Changes Logs");
+        printChangeLogPage(shown, page, filter);
 
-        if (changeLogs.empty()) {
-            cout << "NO SUCCEED CHANGES " << endl;
-            break;
-        } else {
-            int index = 1;
-            stringstream out;
-
-            for (const auto &entry: changeLogs) {
-                if (entry.accepted){
-                    // Display detailed information about successful change logs
-                    out << index++ << ". " << entry.requestType << " (" << entry.timestamp << ")" << endl;
-                    out << "   Student: " << entry.studentCode << endl;
-                    out << "   Student Name: " << entry.studentName << endl;
-                    out << "   Current UC code: " << entry.currentUcCode << " , Class Code: " << entry.currentClassCode << endl;
-                    out << "   New UC code: " << entry.newUcCode << " , Class Code: " << entry.newClassCode << endl;
-                    out << "   State: Accepted" << endl;
-                    out << "   Notes: " << entry.extraNotes << endl << endl;
-                }
-            }
-            string output = out.str();
-            if (output.empty()) {
-                cout << "NO SUCCEED CHANGES " << endl;
-                break;
-            }
-            cout << output;
+        cout << "Undo history: " << system.historyDepth() << " changes reversible";
+        if (system.checkpointDepth() > 0) {
+            cout << " (the oldest " << system.checkpointDepth() << " only together)";
         }
+        cout << ", " << system.historyMemory() / 1024 << " KiB of " << system.getHistoryBudget() / 1024 << " KiB" << endl << endl;
+
         int choice;
         cout << "MENU:" << endl;
-        cout << "1. \033[1mUNDO the last change\033[0m" << endl << "2. [Back]"<< endl;
+        cout << "1. \033[1mUNDO the last change\033[0m" << endl;
+        cout << "2. \033[1mUNDO back to a change of the list\033[0m" << endl;
+        cout << "3. \033[1mREDO the last undone change\033[0m" << endl;
+        cout << "4. Next page" << endl;
+        cout << "5. Previous page" << endl;
+        cout << "6. Go to page" << endl;
+        cout << "7. Filter (request type, student, UC, time)" << endl;
+        cout << "8. Set the memory budget of the undo history" << endl;
+        cout << "9. [Back]" << endl;
         cout << "Enter your choice: ";
         if (!(cin >> choice)) {
             cin.clear();
@@ -1372,19 +1830,65 @@ void Script::successfulChangeLogs() {
             continue;
         }
 
-        if (choice == 2) {
+        if (choice == 9) {
             return;
         }
+        else if (choice >= 4 && choice <= 7) {
+            if (browseChangeLogs(choice - 3, shown, page, filter)) {
+                shown = changeLogs.select(filter);
+            }
+            continue;
+        }
         else if (choice == 1) {
-            undoAction();
-            for (auto i = changeLogs.size()-1; i >= 0; i--) {
-                if (changeLogs[i].accepted) {
-                    changeLogs[i].accepted = false;
-                    changeLogs[i].extraNotes = "REQUEST RESULT REVERSED BY ADMINISTRATOR";
-                    break;
-                }
+            vector<size_t> undone = system.undoAction();
+            if (undone.empty()) {
+                cerr << "ERROR: There are no changes of this run to undo." << endl;
+            } else {
+                markChanges(undone, true);
+                cout << endl << undone.size() << " Change requests reversed successfully" << endl;
             }
-            cout << endl << "Last Change request reversed successfully" << endl;
+            break;
+        }
+        else if (choice == 2) {
+            int number;
+            cout << "Enter the number of the change: ";
+            if (!(cin >> number) || number < 1 || number > (int) shown.size()) {
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                cerr << "ERROR: Invalid input. Please enter a number of the list." << endl;
+                break;
+            }
+            size_t changeId = changeLogs[shown[number - 1]].changeId;
+            vector<size_t> undone = changeId == NoChange ? vector<size_t>() : system.undoTo(changeId);
+            if (undone.empty()) {
+                cerr << "ERROR: This change was made in a previous run, it can't be undone." << endl;
+            } else {
+                markChanges(undone, true);
+                cout << endl << undone.size() << " Change requests reversed successfully" << endl;
+            }
+            break;
+        }
+        else if (choice == 3) {
+            vector<size_t> redone = system.redoAction();
+            if (redone.empty()) {
+                cerr << "ERROR: There are no undone changes to redo." << endl;
+            } else {
+                markChanges(redone, false);
+                cout << endl << redone.size() << " Change requests restored successfully" << endl;
+            }
+            break;
+        }
+        else if (choice == 8) {
+            long long budget;
+            cout << "Enter the memory budget, in KiB: ";
+            if (!(cin >> budget) || budget < 1 || (unsigned long long) budget > numeric_limits<size_t>::max() / 1024) {
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                cerr << "ERROR: Invalid input. Please enter a positive number of KiB." << endl;
+                break;
+            }
+            system.setHistoryBudget((size_t) budget * 1024);
+            cout << endl << "Undo history budget set to " << budget << " KiB, " << system.historyDepth() << " changes reversible" << endl;
             break;
         }
     }
@@ -1394,46 +1898,411 @@ void Script::successfulChangeLogs() {
 /**
  * @brief Display failed change logs.
  *
- * This function shows only the unsuccessful change logs, i.e., denied requests.
+ * This function shows only the unsuccessful change logs, i.e., denied requests, a page at a time.
  */
 void Script::failedChangeLogs() {
-    clearScreen();
-    drawBox("Unsuccessful Changes Logs");
-    if (changeLogs.empty()) {
-        cout << "NO FAILED CHANGES " << endl;
-    } else {
-        int index = 1;
-        stringstream out;
-        for (const auto &entry: changeLogs) {
-            if (!entry.accepted){
-                // Display detailed information about failed change logs
-                out << index++ << ". " << entry.requestType << " (" << entry.timestamp << ")" << endl;
-                out << "   Student: " << entry.studentCode << endl;
-                out << "   Student Name: " << entry.studentName << endl;
-                out << "   Current UC code: " << entry.currentUcCode << " , Class Code: " << entry.currentClassCode
-                     << endl;
-                out << "   New UC code: " << entry.newUcCode << " , Class Code: " << entry.newClassCode << endl;
-                out << "   State: Denied" << endl;
-                out << "   Notes: " << entry.extraNotes << endl << endl;
+    viewChangeLogs("Unsuccessful Changes Logs", LogState::Denied);
+}
+
+/**
+ * @brief Display the statistics of the change logs, and export them to a CSV file on request.
+ *
+ * The statistics are kept up to date by the change logs as each entry is logged, so the view only reads
+ * counters; the request rate only lists the minutes and hours that had requests.
+ */
+void Script::changeLogStatistics() {
+    while (true) {
+        clearScreen();
+        drawBox("Change Log Statistics");
+
+        const ChangeLogStats& stats = changeLogs.getStats();
+        int64_t now = getCurrentTime();
+        auto percent = [](const RequestCounts& counts) {
+            char buffer[16];
+            snprintf(buffer, sizeof(buffer), "%.1f%%", counts.acceptanceRate() * 100);
+            return string(buffer);
+        };
+
+        const RequestCounts& total = stats.getTotal();
+        cout << "\033[1mRequests:\033[0m " << total.requests() << " (" << total.accepted << " accepted, " << total.denied
+             << " denied, " << percent(total) << " accepted)" << endl;
+        cout << "Reversed by the administrator: " << stats.getReversed() << " , restored: " << stats.getRestored() << endl << endl;
+
+        cout << "\033[1mAcceptance by UC:\033[0m" << endl;
+        const vector<string>& ucCodes = context->getUcCodes();
+        for (UcId uc = 0; uc < ucCodes.size(); uc++) {
+            RequestCounts counts = stats.getUc(uc);
+            if (counts.requests() > 0) {
+                cout << "   " << ucCodes[uc] << ": " << counts.requests() << " requests, " << percent(counts) << " accepted" << endl;
             }
         }
-        string output = out.str();
-        if (output.empty()) {
-            cout << "NO SUCCEED CHANGES " << endl;
-        } else {
-            cout << output;
+
+        cout << endl << "\033[1mRejection reasons:\033[0m" << endl;
+        for (LogReason reason : {LogReason::CapacityExceeded, LogReason::BalanceDisturbed, LogReason::ScheduleConflict,
+                                 LogReason::MaxUcsExceeded, LogReason::NoVacancy, LogReason::AlreadyEnrolled, LogReason::NotEnrolled}) {
+            cout << "   " << describeReason(reason) << ": " << stats.getReason(reason) << endl;
+        }
+
+        cout << endl << "\033[1mBusiest classes:\033[0m" << endl;
+        int rank = 1;
+        for (const auto& busy : stats.getBusiestClasses()) {
+            cout << "   " << rank++ << ". " << context->getUcCode((UcId) (busy.first >> 16)) << " , "
+                 << context->getClassCode((ClassId) (busy.first & 0xFFFF)) << ": " << busy.second << " requests" << endl;
+        }
+
+        cout << endl << "\033[1mRequests in the last " << ChangeLogStats::MinuteBuckets << " minutes:\033[0m" << endl;
+        for (const auto& bucket : stats.getMinutes(now)) {
+            if (bucket.second.requests() > 0) {
+                cout << "   " << formatTimestamp(bucket.first).substr(11, 5) << "  " << bucket.second.requests()
+                     << " (" << bucket.second.accepted << " accepted)" << endl;
+            }
+        }
+        cout << endl << "\033[1mRequests in the last " << ChangeLogStats::HourBuckets << " hours:\033[0m" << endl;
+        for (const auto& bucket : stats.getHours(now)) {
+            if (bucket.second.requests() > 0) {
+                cout << "   " << formatTimestamp(bucket.first).substr(0, 13) << "h  " << bucket.second.requests()
+                     << " (" << bucket.second.accepted << " accepted)" << endl;
+            }
+        }
+
+        int choice;
+        cout << endl << "MENU:" << endl;
+        cout << "1. Export to \"change_log_stats.csv\"" << endl;
+        cout << "2. [Back]" << endl;
+        cout << "Enter your choice: ";
+        if (!(cin >> choice)) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            continue;
+        }
+        if (choice == 2) {
+            return;
+        }
+        if (choice == 1) {
+            if (stats.exportCsv("change_log_stats.csv", *context, now)) {
+                cout << "File \"change_log_stats.csv\" outputted successful" << endl;
+            } else {
+                cerr << "ERROR: Could not write \"change_log_stats.csv\"." << endl;
+            }
+            backToMenu();
         }
     }
-    backToMenu();
+}
+
+/**
+ * @brief Display the state of the export stream of the change logs, and change its format or backpressure policy.
+ *
+ * A new format starts a new stream, once the entries queued for the previous one are written; the
+ * policy applies from the next entry logged.
+ */
+void Script::changeLogExport() {
+    while (true) {
+        clearScreen();
+        drawBox("Change Log Export Stream");
+
+        ExportOptions options = exporter->getOptions();
+        cout << "File: " << exporter->getPath() << " (" << describeFormat(options.format) << ")" << endl;
+        cout << "Rotated at " << options.maxFileBytes / 1024 << " KiB, keeping " << options.maxRotatedFiles << " older files" << endl;
+        cout << "When the queue of " << options.queueCapacity << " entries is full: "
+             << (options.policy == BackpressurePolicy::Block ? "wait for the writer" : "drop the entry") << endl << endl;
+        cout << "Entries exported: " << exporter->getExported() << endl;
+        cout << "Entries dropped: " << exporter->getDropped() << endl;
+        cout << "Files rotated: " << exporter->getRotations() << endl;
+        if (exporter->hasFailed()) {
+            cout << "\033[1mThe export files could not be written, see the error above.\033[0m" << endl;
+        }
+
+        int choice;
+        cout << endl << "MENU:" << endl;
+        cout << "1. Export as " << describeFormat(options.format == ExportFormat::Csv ? ExportFormat::Jsonl : ExportFormat::Csv) << endl;
+        cout << "2. " << (options.policy == BackpressurePolicy::Block ? "Drop" : "Wait for the writer on") << " the entries logged while the queue is full" << endl;
+        cout << "3. Refresh" << endl;
+        cout << "4. [Back]" << endl;
+        cout << "Enter your choice: ";
+        if (!(cin >> choice)) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            continue;
+        }
+        if (choice == 4) {
+            return;
+        }
+        if (choice == 1) {
+            options.format = options.format == ExportFormat::Csv ? ExportFormat::Jsonl : ExportFormat::Csv;
+            exporter.reset();
+            exporter = make_unique<ChangeLogExporter>(context->getCatalog(), options);
+        } else if (choice == 2) {
+            exporter->setPolicy(options.policy == BackpressurePolicy::Block ? BackpressurePolicy::Drop : BackpressurePolicy::Block);
+        }
+    }
+}
+
+/**
+ * @brief Runs the search menu over the roster as it was at a given time or at the time of a change log.
+ *
+ * A change log position stands for the time the roster history gave to its commit, so the roster has
+ * that change and none made after it. A time typed in includes every change committed in its second.
+ */
+void Script::consultAsOf() {
+    clearScreen();
+    drawBox("Consult As Of");
+    cout << "Enter a time (YYYY-MM-DD hh:mm:ss) or the number of a change log (#N): ";
+    string input;
+    cin >> ws;
+    getline(cin, input);
+
+    string timestamp = input;
+    int64_t time;
+    if (!input.empty() && input[0] == '#') {
+        size_t position = 0;
+        istringstream in(input.substr(1));
+        if (!(in >> position) || position < 1 || position > changeLogs.size()) {
+            cerr << "ERROR: There is no change log #" << input.substr(1) << "." << endl;
+            backToMenu();
+            return;
+        }
+        time = changeLogs[position - 1].timestamp;
+        timestamp = formatTimestamp(time);
+    } else {
+        time_t seconds;
+        if (!parseTimestamp(timestamp, seconds)) {
+            cerr << "ERROR: Invalid time. Please enter it as YYYY-MM-DD hh:mm:ss." << endl;
+            backToMenu();
+            return;
+        }
+        time = (int64_t) seconds * 1000000000 + 999999999;
+    }
+
+    shared_ptr<DataContext> past = storage.rosterAsOf(time);
+    if (past == nullptr) {
+        time_t start = (time_t) (storage.historyStart() / 1000000000);
+        char buffer[20];
+        strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", localtime(&start));
+        cerr << "ERROR: The roster history starts at " << buffer << ", it can't go back to " << timestamp << "." << endl;
+        backToMenu();
+        return;
+    }
+
+    Consult current = consult;
+    consult = Consult(past);
+    searchMenu("Search Menu as of " + timestamp);
+    consult = current;
 }
 
 /**
  * @brief Print updated student data to a file.
  *
- * This function saves the updated student data to a CSV file named "students_updated.csv" and notifies the user of the successful output.
+ * This function exports the whole roster, only the changes since the last export, the timetable of every student, or
+ * the data for analysis in a columnar file, until the user goes back.
  */
 void Script::printToFile() {
-    global.Students.saveToCSV("students_updated.csv");
-    cout << "File \"students_updated.csv\" outputted successful" << endl;
-    backToMenu();
+    while (true) {
+        clearScreen();
+        drawBox("Print to File");
+        if (rosterTracker.hasExport()) {
+            cout << "Last export: \"" << rosterTracker.getPath() << "\", " << rosterTracker.changedStudents()
+                 << " students changed since the last export" << endl << endl;
+        }
+
+        int choice;
+        cout << "1. \033[1mExport the whole roster\033[0m" << endl;
+        cout << "2. \033[1mExport the changes since the last export\033[0m" << endl;
+        cout << "3. \033[1mExport the timetable of every student\033[0m" << endl;
+        cout << "4. \033[1mExport the roster, schedules and change logs for analysis\033[0m" << endl;
+        cout << "5. [Back]" << endl;
+        cout << "Enter your choice: ";
+        if (!(cin >> choice)) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            continue;
+        }
+        if (choice == 5) {
+            return;
+        }
+        if (choice == 1) {
+            exportRoster();
+        } else if (choice == 2) {
+            exportRosterChanges();
+        } else if (choice == 3) {
+            exportTimetables();
+        } else if (choice == 4) {
+            exportColumnar();
+        }
+    }
+}
+
+/**
+ * @brief Export the whole roster to a CSV file.
+ *
+ * This function asks for the path of the CSV file, "students_updated.csv" by default, and saves the updated student data to it.
+ * The rows are formatted in parallel and the file is replaced atomically, so it never holds a partial roster.
+ * The changes made after the export are tracked from it.
+ */
+void Script::exportRoster() {
+    string path;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    cout << "Enter the file path (blank for \"" << rosterExportPath << "\"): ";
+    getline(cin, path);
+    if (path.empty()) {
+        path = rosterExportPath;
+    }
+
+    if (rosterTracker.exportFull(RosterExporter(pool), path)) {
+        rosterExportPath = path;
+        cout << "File \"" << path << "\" outputted successful" << endl;
+    } else {
+        cerr << "ERROR: Could not write \"" << path << "\"." << endl;
+    }
+    cout << "Press ENTER to continue...";
+    cin.get();
+}
+
+/**
+ * @brief Export the changes of the roster since the last export to a delta file.
+ *
+ * This function asks for the path of the delta file, "students_delta.csv" by default, and whether to also patch the
+ * exported roster file. Only the students changed since the last export are read and written.
+ */
+void Script::exportRosterChanges() {
+    string path;
+    string answer;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    if (!rosterTracker.hasExport()) {
+        cerr << "ERROR: Export the whole roster first, the changes are computed from it." << endl;
+        cout << "Press ENTER to continue...";
+        cin.get();
+        return;
+    }
+    cout << "Enter the delta file path (blank for \"" << rosterDeltaPath << "\"): ";
+    getline(cin, path);
+    if (path.empty()) {
+        path = rosterDeltaPath;
+    }
+    cout << "Also update \"" << rosterTracker.getPath() << "\"? (y/n): ";
+    getline(cin, answer);
+
+    DeltaSummary summary;
+    string error;
+    if (rosterTracker.exportDelta(RosterExporter(pool), path, answer == "y" || answer == "Y", summary, error)) {
+        rosterDeltaPath = path;
+        cout << "File \"" << path << "\" outputted successful: " << summary.students << " students changed, " << summary.added
+             << " enrollments added, " << summary.removed << " removed, " << summary.changed << " changed class" << endl;
+        if (summary.rewritten) {
+            cout << "\"" << rosterTracker.getPath() << "\" was written again, as some students changed their number of UCs" << endl;
+        } else if (summary.patched > 0) {
+            cout << "\"" << rosterTracker.getPath() << "\" patched in place for " << summary.patched << " students" << endl;
+        }
+    } else {
+        cerr << "ERROR: " << error << endl;
+    }
+    cout << "Press ENTER to continue...";
+    cin.get();
+}
+
+/**
+ * @brief Export the timetable of every student to files.
+ *
+ * This function asks for the format, the layout and the path of the files: "timetables.csv" or "timetables.ics" for a single
+ * file, the directory "timetables" for a file per student. The events of an iCalendar start on the first day of the term, the
+ * next Monday by default, and repeat weekly for the weeks of the term. The timetables are formatted in parallel.
+ */
+void Script::exportTimetables() {
+    TimetableOptions options;
+    string answer;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    cout << "Format (1. CSV, 2. iCalendar): ";
+    getline(cin, answer);
+    if (answer != "1" && answer != "2") {
+        cerr << "ERROR: Invalid format." << endl;
+        cout << "Press ENTER to continue...";
+        cin.get();
+        return;
+    }
+    options.format = answer == "1" ? TimetableFormat::Csv : TimetableFormat::ICalendar;
+    cout << "One file per student? (y/n): ";
+    getline(cin, answer);
+    options.perStudent = answer == "y" || answer == "Y";
+
+    string path = options.perStudent ? "timetables" : "timetables" + TimetableExporter::extension(options.format);
+    cout << "Enter the " << (options.perStudent ? "directory" : "file") << " path (blank for \"" << path << "\"): ";
+    getline(cin, answer);
+    if (!answer.empty()) {
+        path = answer;
+    }
+
+    if (options.format == TimetableFormat::ICalendar) {
+        time_t now = time(nullptr);
+        tm today = {};
+        localtime_r(&now, &today);
+        today.tm_mday += (8 - today.tm_wday) % 7 == 0 ? 7 : (8 - today.tm_wday) % 7;
+        mktime(&today);
+        char nextMonday[16];
+        strftime(nextMonday, sizeof(nextMonday), "%Y-%m-%d", &today);
+
+        cout << "First day of the term, YYYY-MM-DD (blank for " << nextMonday << "): ";
+        getline(cin, options.termStart);
+        if (options.termStart.empty()) {
+            options.termStart = nextMonday;
+        }
+        cout << "Number of weeks of the term (blank for " << options.weeks << "): ";
+        getline(cin, answer);
+        bool validWeeks = answer.empty() || (answer.size() <= 3 && all_of(answer.begin(), answer.end(), ::isdigit) && stoi(answer) > 0);
+        if (!TimetableExporter::validDate(options.termStart) || !validWeeks) {
+            cerr << "ERROR: Invalid " << (validWeeks ? "date." : "number of weeks.") << endl;
+            cout << "Press ENTER to continue...";
+            cin.get();
+            return;
+        }
+        if (!answer.empty()) {
+            options.weeks = (unsigned) stoi(answer);
+        }
+    }
+
+    size_t files;
+    TimetableExporter exporter(pool, *context->getCatalog(), options);
+    if (exporter.exportTimetables(context->getStudents(), path, files)) {
+        cout << (options.perStudent ? "Directory \"" : "File \"") << path << "\" outputted successful";
+        if (options.perStudent) {
+            cout << ": " << files << " files";
+        }
+        cout << endl;
+    } else {
+        cerr << "ERROR: Could not write \"" << path << "\" (" << files << " files written)." << endl;
+    }
+    cout << "Press ENTER to continue...";
+    cin.get();
+}
+
+/**
+ * @brief Export the roster, the schedules and the change logs to a columnar file for analysis.
+ *
+ * This function asks for the path of the file, "analytics.lcol" by default, and saves the enrollment, schedule and change log
+ * tables to it. The columns are encoded in parallel and the file is replaced atomically.
+ */
+void Script::exportColumnar() {
+    string path;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    cout << "Enter the file path (blank for \"" << columnarPath << "\"): ";
+    getline(cin, path);
+    if (path.empty()) {
+        path = columnarPath;
+    }
+
+    const Catalog& catalog = *context->getCatalog();
+    vector<ColumnTable> tables;
+    tables.push_back(ColumnarExporter::enrollmentTable(context->getStudents()));
+    tables.push_back(ColumnarExporter::scheduleTable(catalog));
+    tables.push_back(ColumnarExporter::changeLogTable(changeLogs, catalog));
+    uint64_t bytes;
+    if (ColumnarExporter(pool).exportTables(tables, path, bytes)) {
+        columnarPath = path;
+        cout << "File \"" << path << "\" outputted successful: " << bytes << " bytes, ";
+        for (size_t i = 0; i < tables.size(); i++) {
+            cout << tables[i].rows << " " << tables[i].name << (i + 1 < tables.size() ? ", " : "\n");
+        }
+    } else {
+        cerr << "ERROR: Could not write \"" << path << "\"." << endl;
+    }
+    cout << "Press ENTER to continue...";
+    cin.get();
 }
@@ -8,72 +8,21 @@
 
 #include "Consult.h"
 #include "Change.h"
+#include "ChangeRequest.h"
+#include "CycleResolver.h"
+#include "BatchProcessor.h"
+#include "RequestStore.h"
+#include "RequestLog.h"
+#include "StorageEngine.h"
+#include "ChangeLog.h"
+#include "ChangeLogExporter.h"
+#include "RosterTracker.h"
+#include "TimetableExporter.h"
+#include "ColumnarExporter.h"
 #include <vector>
 #include <limits>
 #include <queue>
 
-/**
- * @struct ChangeClassRequest
- * @brief A structure to represent a request to Change a Student's Class.
- */
-struct ChangeClassRequest {
-    Student* student;        ///< A pointer to the student for whom the change is requested.
-    string currentUcCode;    ///< The current UC (University Course) code of the student.
-    string currentClassCode; ///< The current class code of the student.
-    string newClassCode;     ///< The desired new class code for the student.
-};
-
-/**
- * @struct ChangeUcRequest
- * @brief A structure to represent a request to Change a Student's UC (University Course).
- */
-struct ChangeUcRequest {
-    Student* student;        ///< A pointer to the student for whom the change is requested.
-    string currentUcCode;    ///< The current UC code of the student.
-    string currentClassCode; ///< The current class code of the student.
-    string newUcCode;        ///< The desired new UC code for the student.
-};
-
-/**
- * @struct LeaveUcClassRequest
- * @brief A structure to represent a request for a Student to leave a specific UC and Class.
- */
-struct LeaveUcClassRequest {
-    Student* student;        ///< A pointer to the student who wishes to leave.
-    string currentUcCode;    ///< The UC code of the UC the student wants to leave.
-    string currentClassCode; ///< The class code of the class the student wants to leave.
-};
-
-/**
- * @struct JoinUcClassRequest
- * @brief A structure to represent a request for a Student to join a specific UC and Class.
- */
-struct JoinUcClassRequest {
-    Student* student; ///< A pointer to the student who wishes to join.
-    string newUcCode; ///< The UC code of the UC the student wants to join.
-};
-
-/**
- * @struct SwapClassesRequest
- * @brief A structure to represent a request for two Students to swap Classes within the same UC.
- */
-struct SwapClassesRequest {
-    Student* student1; ///< A pointer to the first student involved in the class swap.
-    string ucCode;     ///< The UC code to which the swap pertains.
-    string classCode1; ///< The class code of the first student.
-    Student* student2; ///< A pointer to the second student involved in the class swap.
-    string classCode2; ///< The class code of the second student.
-};
-
-/**
- * @struct ChangeRequest
- * @brief A structure to represent a generic Change request, which can be of various types (changing class, changing UC, leaving UC and class, joining UC and class, or swapping classes).
- */
-struct ChangeRequest {
-    string requestType; ///< A string indicating the type of change request (e.g., "ChangeClassRequest").
-    variant<ChangeClassRequest, ChangeUcRequest, LeaveUcClassRequest, JoinUcClassRequest, SwapClassesRequest> requestData; ///< A variant that can hold any of the specific request types, allowing for flexibility in managing different types of requests.
-};
-
 /**
  * @class Script
  * @brief Main Script for interacting with the "LEIC Schedules" system.
@@ -94,14 +43,14 @@ public:
     void run();
 
     /**
-     * Queue of change requests waiting to be processed.
+     * Change requests waiting to be processed, students of the final year first and then in arrival order.
      */
-    queue<ChangeRequest> changeRequestQueue;
+    RequestStore requestStore;
 
     /**
-     * List of All change request log
+     * List of All change request log, indexed for the filtered views
      */
-    vector<ChangeLogEntry> changeLogs;
+    ChangeLog changeLogs;
 
 private:
     /**
@@ -113,16 +62,31 @@ private:
         void (Script::*action)(); ///< Function pointer to the action associated with the menu item.
     };
 
+    shared_ptr<DataContext> context; ///< The data context shared by the script, the system and the consult.
+    StorageEngine storage; ///< Restores the roster of the previous runs and journals every commit to the disk.
     System system; ///< The academic system used for data management.
-    Global global; ///< The global data used by the script.
     Consult consult; ///< The consultation component for accessing academic data.
+    ThreadPool pool; ///< The threads used to validate change requests in parallel.
+    RequestLog requestLog; ///< The on-disk log of the change requests and change logs, replayed on startup.
+    RosterTracker rosterTracker; ///< Tracks the students changed since the roster was last printed to a file.
+    unique_ptr<ChangeLogExporter> exporter; ///< Streams the change logs to rotating files, replaced when its format changes.
     const string adminPassword = "12345"; ///< The administrator's password.
+    string rosterExportPath = "students_updated.csv"; ///< The path the roster was last printed to, offered as the default.
+    string rosterDeltaPath = "students_delta.csv"; ///< The path the changes of the roster were last printed to, offered as the default.
+    string columnarPath = "analytics.lcol"; ///< The path the columnar file for analysis was last printed to, offered as the default.
 
     /**
-     * A map to keep track of students with pending change requests.
-     * The key is the student code, and the value is a boolean indicating if a request is pending.
+     * Give the priority class of a change request in the request store, students of the final year first.
+     * @param request The change request.
+     * @return The priority class of the request, 0 is processed first.
      */
-    map<int, bool> studentHasPendingRequest;
+    size_t finalYearFirst(const ChangeRequest& request);
+
+    /**
+     * Add a change request to the store and wait until it is written to the request log.
+     * @param request The change request.
+     */
+    void enqueueRequest(const ChangeRequest& request);
 
     /**
      * Draw a text box with the specified text.
@@ -154,15 +118,31 @@ private:
     void backToMenu();
 
     /**
-     * Update the global data with the provided data.
-     * @param global The global data to update with.
+     * Commit or roll back the transaction of a processed request and register its change log.
+     * @param transaction The write transaction the request was processed in.
+     * @param logEntry The change log entry of the processed request.
+     */
+    void commitRequest(WriteTransaction& transaction, const ChangeLogEntry& logEntry);
+
+    /**
+     * Add an entry to the change logs and queue it for the export stream.
+     * @param entry The change log entry.
      */
-    void updateData(Global global);
+    void logChange(const ChangeLogEntry& entry);
 
     /**
-     * Undo the last succeed change.
+     * Mark the change log entries of some changes as reversed or restored by the administrator, and record it in the request log.
+     * @param changeIds The ids of the changes in the undo history.
+     * @param reversed True if the changes were undone, false if they were redone.
      */
-    void undoAction();
+    void markChanges(const vector<size_t>& changeIds, bool reversed);
+
+    /**
+     * @brief Displays the search menu, whose queries all go through the consult.
+     *
+     * @param menuName The title of the menu.
+     */
+    void searchMenu(const string& menuName);
 
     /**
      * @brief Displays a submenu for searching and consulting schedules.
@@ -290,13 +270,30 @@ private:
     /**
      * @brief Displays pending change requests for a specific student and handles cancellation.
      *
-     * This function shows the pending change request for a specific student identified by their student code.
-     * It allows the user to cancel a pending request.
+     * This function shows the pending change requests for a specific student identified by their student code,
+     * wherever they are in the queue. It allows the user to cancel any of them.
      *
      * @param studentCode The student code for which pending requests should be displayed and managed.
      */
     void pendingRequest(const int& studentCode);
 
+    /**
+     * @brief Displays the details of a pending request of a given type, every request type must specialize it.
+     *
+     * @param request The pending request.
+     * @param studentCode The student code from whose point of view the request is displayed.
+     */
+    template<typename Request>
+    void printPendingRequest(const Request& request, const int& studentCode) = delete;
+
+    /**
+     * @brief Displays the details of a pending change request.
+     *
+     * @param request The pending change request.
+     * @param studentCode The student code from whose point of view the request is displayed.
+     */
+    void printPendingRequest(const ChangeRequest& request, const int& studentCode);
+
     /**
      * @brief Initiates the process for changing a student's class.
      *
@@ -338,12 +335,26 @@ private:
     void swapClassesBetweenStudents();
 
     /**
-     * @brief Processes a change request from the queue.
+     * @brief Processes a change request taken from the queue.
+     *
+     * This function applies the requested change to the student's data, if it respects every rule.
+     * After processing, relevant data and change logs are updated.
+     *
+     * @param request The change request to process.
+     * @param verdict If not null, the verdict of the request already evaluated on the current data.
+     * @return True if the request was accepted, otherwise false.
+     */
+    bool processRequest(const ChangeRequest& request, const ChangeVerdict* verdict = nullptr);
+
+    /**
+     * @brief Processes a request of a given type, every request type must specialize it.
      *
-     * This function processes the next change request from the queue, applying the requested change to the student's data.
-     * After processing, the request is removed from the queue, and relevant data and change logs are updated.
+     * @param request The request to process.
+     * @param verdict If not null, the verdict of the request already evaluated on the current data.
+     * @return True if the request was accepted, otherwise false.
      */
-    void processRequest();
+    template<typename Request>
+    bool processRequest(const Request& request, const ChangeVerdict* verdict) = delete;
 
     /**
      * @brief Allows the Administrator to process all change requests in the queue.
@@ -354,6 +365,17 @@ private:
      */
     void processNextChangeRequest();
 
+    /**
+     * @brief Accepts the class change requests of the queue that form cycles.
+     *
+     * A class change request that would be denied alone, because of the capacity or the balance between classes,
+     * is accepted when it is part of a cycle of requests in the same UC, as the cycle keeps every class with the
+     * same number of students. Each cycle is committed in a single transaction, the other requests stay in the queue.
+     *
+     * @return The number of requests accepted through cycles.
+     */
+    int resolveClassChangeCycles();
+
     /**
      * @brief Allows the Administrator to process the next change request in the queue.
      *
@@ -368,22 +390,51 @@ private:
      *
      * This function presents a menu to the admin, where they can choose to view different types of change logs, such as all change logs,
      * successful change logs, and unsuccessful (failed) change logs. The admin can navigate through these logs and perform actions
-     * such as undoing the last change if allowed.
+     * such as undoing the last change if allowed, or consult the roster as it was at the time of a log.
      */
     void changeLogsMenu();
 
+    /**
+     * @brief Displays a page of selected change logs.
+     *
+     * @param shown The positions of the selected change logs, numbered from 1 in the view.
+     * @param page The page to display, from 0.
+     * @param filter The filter the change logs were selected with.
+     */
+    void printChangeLogPage(const vector<size_t>& shown, size_t page, const ChangeLogFilter& filter);
+
+    /**
+     * @brief Handles the page and filter options shared by the change log views.
+     *
+     * @param option The option chosen: 1 next page, 2 previous page, 3 go to a page, 4 filter.
+     * @param shown The positions of the selected change logs.
+     * @param page The page displayed, updated by the page options.
+     * @param filter The filter of the view, updated by the filter option.
+     * @return True if the change logs must be selected again with the new filter, otherwise false.
+     */
+    bool browseChangeLogs(int option, const vector<size_t>& shown, size_t& page, ChangeLogFilter& filter);
+
+    /**
+     * @brief Displays the change logs of a given state, a page at a time, with page and filter options.
+     *
+     * @param title The title of the view.
+     * @param state The state of the change logs of the view.
+     */
+    void viewChangeLogs(const string& title, LogState state);
+
     /**
      * @brief Displays all change logs, including both successful and unsuccessful changes.
      *
-     * This function displays a list of all change logs, which include information about the requested changes, timestamps, student details,
-     * state (accepted or denied), and any additional notes. If there are no logs, it informs the admin accordingly.
+     * This function displays a list of all change logs, a page at a time, which include information about the requested changes, timestamps, student details,
+     * state (accepted or denied), and any additional notes. The list can be filtered by request type, student, UC and time.
      */
     void allChangeLogs();
 
     /**
-     * @brief Displays successful change logs and provides options for undoing the last change.
+     * @brief Displays successful change logs and provides options for undoing and redoing changes.
      *
-     * This function presents successful change logs, which include accepted changes, to the user. It allows the admin to undo the last change if they choose to.
+     * This function presents successful change logs, which include accepted changes, to the user, a page at a time. It allows the admin to undo the last change,
+     * to undo every change back to one of the list, to redo the last undone change, or to set the memory budget of the undo history.
      * The function also provides an option to go back to the previous menu.
      */
     void successfulChangeLogs();
@@ -391,18 +442,74 @@ private:
     /**
      * @brief Displays unsuccessful (failed) change logs.
      *
-     * This function displays a list of change logs that represent changes that were denied or unsuccessful. It includes information about the
-     * requested changes, timestamps, student details, and the reason of why they were denied. If there are no failed change logs, it informs the user accordingly.
+     * This function displays a list of change logs that represent changes that were denied or unsuccessful, a page at a time. It includes information about the
+     * requested changes, timestamps, student details, and the reason of why they were denied. The list can be filtered by request type, student, UC and time.
      */
     void failedChangeLogs();
 
+    /**
+     * @brief Displays the statistics of the change logs: acceptance by UC, rejection reasons, busiest classes and request rate.
+     *
+     * The statistics are updated as each change log is logged, so displaying them doesn't go through the change logs.
+     * They can be exported to the CSV file "change_log_stats.csv".
+     */
+    void changeLogStatistics();
+
+    /**
+     * @brief Displays the state of the export stream of the change logs, and changes its format or backpressure policy.
+     *
+     * The change logs are written to "data/changelog.csv" or "data/changelog.jsonl" by a background thread as they are logged.
+     */
+    void changeLogExport();
+
+    /**
+     * @brief Runs the search menu over the roster as it was at a given time.
+     *
+     * The time is either a timestamp or the position of an entry of all the change logs, which stands for
+     * the time of that entry. The roster of that time is rebuilt by the storage engine, and the consult
+     * is pointed at it until the user goes back, so every query of the search menu (schedules, class
+     * lists, occupations) answers as of that time.
+     */
+    void consultAsOf();
+
+    /**
+     * @brief Displays the menu to print the student data to files.
+     *
+     * The whole roster, or only the changes since it was last printed, can be saved to CSV (Comma-Separated Values) files.
+     */
+    void printToFile();
+
     /**
      * @brief Saves the updated student data to a CSV file.
      *
-     * This function saves the updated student data to a CSV (Comma-Separated Values) file named "students_updated.csv".
+     * This function saves the updated student data to a CSV file, at a path given by the user, "students_updated.csv" by default.
      * It provides feedback to the user, indicating whether the file output was successful.
      */
-    void printToFile();
+    void exportRoster();
+
+    /**
+     * @brief Saves the enrollments added, removed and changed since the last export to a CSV file.
+     *
+     * This function saves the changes to a CSV file, at a path given by the user, "students_delta.csv" by default, and can also
+     * update the exported roster file, in place when the rows of the changed students keep their size.
+     */
+    void exportRosterChanges();
+
+    /**
+     * @brief Saves the timetable of every student, as consultTheScheduleOfStudent shows it, to files.
+     *
+     * This function asks for the format, CSV or iCalendar, and whether to save a single file with every student or a file per
+     * student in a directory. An iCalendar also needs the first day and the number of weeks of the term.
+     */
+    void exportTimetables();
+
+    /**
+     * @brief Saves the enrollments, the schedules and the change logs to a columnar binary file for analysis.
+     *
+     * This function saves the tables to a file, at a path given by the user, "analytics.lcol" by default. Each column is
+     * dictionary or run-length encoded and can be mapped on its own; the footer of the file describes them.
+     */
+    void exportColumnar();
 };
 
 #endif // SCRIPT_H
\ No newline at end of file
@@ -0,0 +1,609 @@
+/**
+ * @file StorageEngine.cpp
+ * @brief Implementation of the StorageEngine class.
+ */
+
+#include "StorageEngine.h"
+#include "UtilityFunctions.h"
+#include <fstream>
+#include <iostream>
+
+/**
+ * @brief The first bytes of a journal file of the roster.
+ */
+static const char JournalMagic[8] = {'A', 'E', 'D', 'J', 'R', 'N', 'L', '1'};
+
+/**
+ * @brief The first bytes of a snapshot file of the roster.
+ */
+static const char SnapshotMagic[8] = {'A', 'E', 'D', 'S', 'N', 'A', 'P', '1'};
+
+/**
+ * @brief The first bytes of a history file of the roster.
+ */
+static const char HistoryMagic[8] = {'A', 'E', 'D', 'H', 'I', 'S', 'T', '1'};
+
+/**
+ * @brief The times of the history below which they are in seconds, as the first histories wrote them.
+ *
+ * 10^15 nanoseconds is less than twelve days after the epoch, and 10^15 seconds millions of years after it.
+ */
+static const int64_t HistorySecondsLimit = 1000000000000000;
+
+/**
+ * @brief Reads the enrollments of a journal record, a snapshot or a keyframe, after their header.
+ *
+ * The enrollments are [number of students] followed, for each student, by [student code], [name] if
+ * the names are stored, [number of classes] and the UC and class id of each class.
+ *
+ * @param reader The reader, positioned at the number of students.
+ * @param withNames True if the names of the students are stored, as in snapshots and keyframes.
+ * @param onStudent Called with the code, the name (empty if not stored) and the enrollment of each student.
+ * @return True if every enrollment was read, otherwise false.
+ *
+ * @complexity O(s * c), where s is the number of students and c their number of classes.
+ */
+static bool readEnrollments(BinaryReader& reader, bool withNames, const function<void(int, string&, PackedEnrollment&)>& onStudent) {
+    uint32_t count;
+    if (!reader.get(count)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t studentCode;
+        string studentName;
+        uint16_t classCount;
+        if (!reader.get(studentCode) || (withNames && !reader.getString(studentName)) || !reader.get(classCount)) {
+            return false;
+        }
+        PackedEnrollment classes(classCount);
+        for (auto& ucClass : classes) {
+            if (!reader.get(ucClass.first) || !reader.get(ucClass.second)) {
+                return false;
+            }
+        }
+        onStudent(studentCode, studentName, classes);
+    }
+    return true;
+}
+
+/**
+ * @brief Inserts students in a binary search tree so that it is balanced, as they are sorted by name.
+ *
+ * @param students The binary search tree.
+ * @param sorted The students, sorted by name.
+ * @param first The position of the first student to insert.
+ * @param last The end of the students to insert.
+ */
+static void insertBalanced(StudentBST& students, const vector<Student>& sorted, size_t first, size_t last) {
+    if (first >= last) {
+        return;
+    }
+    size_t middle = first + (last - first) / 2;
+    students.insertStudent(sorted[middle].StudentCode, sorted[middle].StudentName, sorted[middle].UcToClasses);
+    insertBalanced(students, sorted, first, middle);
+    insertBalanced(students, sorted, middle + 1, last);
+}
+
+/**
+ * @brief Constructor for the StorageEngine class.
+ *
+ * The roster read from the CSV files is replaced by the enrollment of the last snapshot and of the
+ * journal records after it, the torn tail of the journal is cut, and from then on every commit of the
+ * data context is journaled. The history is indexed and, if it doesn't end with the restored roster
+ * (on its first run, or after a crash that lost its last records), a keyframe of the roster is added.
+ *
+ * @param context The data context, with the roster read from the CSV files.
+ * @param basePath The path of the storage files, without their extensions.
+ * @param checkpointInterval The number of journal records that triggers a checkpoint.
+ */
+StorageEngine::StorageEngine(shared_ptr<DataContext> context, const string& basePath, size_t checkpointInterval)
+    : context(std::move(context)), snapshotPath(basePath + ".snapshot"),
+      journal(basePath + ".journal", string(JournalMagic, sizeof(JournalMagic))), catalogFingerprint(0),
+      checkpointInterval(max<size_t>(checkpointInterval, 1)), nextSequence(1), appliedToImage(0), stopping(false),
+      snapshotSequence(0), history(basePath + ".history", string(HistoryMagic, sizeof(HistoryMagic))), lastTime(0) {
+    for (const string& ucCode : this->context->getUcCodes()) {
+        catalogFingerprint = crc32(ucCode.c_str(), ucCode.size() + 1, catalogFingerprint);
+    }
+    for (ClassId classId = 0; !this->context->getClassCode(classId).empty(); classId++) {
+        const string& classCode = this->context->getClassCode(classId);
+        catalogFingerprint = crc32(classCode.c_str(), classCode.size() + 1, catalogFingerprint);
+    }
+
+    // The image starts as the roster of the CSV files
+    this->context->getStudents().forEachStudent([this](const Student& student) {
+        image.push_back({student.StudentCode, student.StudentName, this->context->pack(student.UcToClasses)});
+    });
+    sort(image.begin(), image.end(), [](const StudentImage& a, const StudentImage& b) { return a.studentCode < b.studentCode; });
+    for (size_t i = 0; i < image.size(); i++) {
+        imagePosition[image[i].studentCode] = i;
+    }
+
+    loadSnapshot();
+
+    const vector<string_view>& records = journal.load();
+    size_t keptRecords = 0;
+    uint64_t lastSequence = snapshotSequence;
+    for (const string_view& record : records) {
+        uint64_t sequence;
+        if (!applyToImage(record, sequence)) {
+            break;
+        }
+        if (sequence > snapshotSequence) {
+            unsnapshotted.emplace_back(sequence, string(record));
+            lastSequence = sequence;
+        }
+        keptRecords++;
+    }
+    if (journal.tornTail() || keptRecords < records.size()) {
+        cerr << "ERROR: The roster journal ends with an incomplete record, it was dropped." << endl;
+    }
+    appliedToImage = unsnapshotted.size();
+    journal.open(keptRecords);
+
+    // Sequence numbers never go back in the history, even if the journal and the snapshot were lost
+    nextSequence = max(lastSequence, loadHistory()) + 1;
+    uint64_t lastMarked = max(deltaMarks.empty() ? 0 : deltaMarks.back().sequence, keyframeMarks.empty() ? 0 : keyframeMarks.back().sequence);
+    if (keyframeMarks.empty() || lastMarked != lastSequence) {
+        uint64_t sequence = nextSequence++;
+        appendHistory(HistoryType::Keyframe, sequence, nextHistoryTime(), encodeImage(sequence));
+    }
+
+    restoreRoster();
+    observerId = this->context->addCommitObserver([this](const vector<const Student*>& students) { onCommit(students); });
+    checkpointer = thread(&StorageEngine::checkpointLoop, this);
+}
+
+/**
+ * @brief Destructor for the StorageEngine class.
+ *
+ * The commits stop being journaled and the checkpoint thread writes a last snapshot if there are
+ * records that are not in one, so the next startup only reads the snapshot.
+ */
+StorageEngine::~StorageEngine() {
+    context->removeCommitObserver(observerId);
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wakeUp.notify_one();
+    checkpointer.join();
+}
+
+/**
+ * @brief Encodes the enrollment of some students as a journal record.
+ *
+ * The record is [catalog fingerprint][sequence][number of students] followed, for each student, by
+ * [student code][number of classes] and the UC and class id of each class.
+ *
+ * @param sequence The sequence number of the record.
+ * @param students The students.
+ * @return The payload of the record.
+ *
+ * @complexity O(s * c), where s is the number of students and c their number of classes.
+ */
+string StorageEngine::encodeRecord(uint64_t sequence, const vector<const Student*>& students) const {
+    string payload;
+    BinaryWriter writer(payload);
+    writer.put(catalogFingerprint);
+    writer.put(sequence);
+    writer.put<uint32_t>((uint32_t) students.size());
+    for (const Student* student : students) {
+        writer.put<int32_t>(student->StudentCode);
+        writer.put<uint16_t>((uint16_t) student->UcToClasses.size());
+        for (const Class& ucClass : student->UcToClasses) {
+            writer.put(context->getUcId(ucClass.UcCode));
+            writer.put(context->getClassId(ucClass.ClassCode));
+        }
+    }
+    return payload;
+}
+
+/**
+ * @brief Applies a journal record to the image, if it is newer than the snapshot.
+ *
+ * @param record The payload of the record.
+ * @param sequence The sequence number of the record.
+ * @return True if the record is valid and of the current catalog, otherwise false.
+ */
+bool StorageEngine::applyToImage(string_view record, uint64_t& sequence) {
+    BinaryReader reader(record.data(), record.size());
+    uint32_t fingerprint;
+    if (!reader.get(fingerprint) || fingerprint != catalogFingerprint || !reader.get(sequence)) {
+        return false;
+    }
+    bool newer = sequence > snapshotSequence;
+    bool ok = readEnrollments(reader, false, [this, newer](int studentCode, string&, PackedEnrollment& classes) {
+        auto it = imagePosition.find(studentCode);
+        if (newer && it != imagePosition.end()) {
+            image[it->second].classes = std::move(classes);
+        }
+    });
+    return ok && reader.atEnd();
+}
+
+/**
+ * @brief Replaces the enrollment of the image with the one of the snapshot file.
+ *
+ * The snapshot is [magic][catalog fingerprint][sequence][number of students], then for each student
+ * [student code][name][number of classes] and the UC and class id of each class, and a CRC-32 of
+ * everything after the magic. Students that are no longer in the roster are ignored.
+ *
+ * @return True if a valid snapshot of the current catalog was read, otherwise false.
+ */
+bool StorageEngine::loadSnapshot() {
+    ifstream in(snapshotPath, ios::binary | ios::ate);
+    if (!in) {
+        return false;
+    }
+    string data((size_t) in.tellg(), '\0');
+    in.seekg(0);
+    in.read(&data[0], (streamsize) data.size());
+
+    if (data.size() < sizeof(SnapshotMagic) + sizeof(uint32_t) || data.compare(0, sizeof(SnapshotMagic), string(SnapshotMagic, sizeof(SnapshotMagic))) != 0) {
+        cerr << "ERROR: " << snapshotPath << " is not a roster snapshot, it was ignored." << endl;
+        return false;
+    }
+    size_t bodySize = data.size() - sizeof(SnapshotMagic) - sizeof(uint32_t);
+    uint32_t checksum;
+    memcpy(&checksum, data.data() + data.size() - sizeof(uint32_t), sizeof(uint32_t));
+    if (crc32(data.data() + sizeof(SnapshotMagic), bodySize) != checksum) {
+        cerr << "ERROR: " << snapshotPath << " is corrupted, it was ignored." << endl;
+        return false;
+    }
+
+    BinaryReader reader(data.data() + sizeof(SnapshotMagic), bodySize);
+    uint32_t fingerprint;
+    uint64_t sequence;
+    if (!reader.get(fingerprint) || fingerprint != catalogFingerprint || !reader.get(sequence)) {
+        cerr << "ERROR: " << snapshotPath << " was taken with another catalog, it was ignored." << endl;
+        return false;
+    }
+    vector<pair<size_t, PackedEnrollment>> enrollments;
+    bool ok = readEnrollments(reader, true, [this, &enrollments](int studentCode, string&, PackedEnrollment& classes) {
+        auto it = imagePosition.find(studentCode);
+        if (it != imagePosition.end()) {
+            enrollments.emplace_back(it->second, std::move(classes));
+        }
+    });
+    if (!ok) {
+        return false;
+    }
+
+    for (auto& enrollment : enrollments) {
+        image[enrollment.first].classes = std::move(enrollment.second);
+    }
+    snapshotSequence = sequence;
+    return true;
+}
+
+/**
+ * @brief Encodes the image as the body of a snapshot or of a keyframe.
+ *
+ * The body is [catalog fingerprint][sequence][number of students], then for each student [student code]
+ * [name][number of classes] and the UC and class id of each class.
+ *
+ * @param sequence The sequence number of the last record applied to the image.
+ * @return The encoded image.
+ *
+ * @complexity O(N), where N is the number of students.
+ */
+string StorageEngine::encodeImage(uint64_t sequence) const {
+    string body;
+    BinaryWriter writer(body);
+    writer.put(catalogFingerprint);
+    writer.put(sequence);
+    writer.put<uint32_t>((uint32_t) image.size());
+    for (const StudentImage& student : image) {
+        writer.put<int32_t>(student.studentCode);
+        writer.putString(student.studentName);
+        writer.put<uint16_t>((uint16_t) student.classes.size());
+        for (const auto& ucClass : student.classes) {
+            writer.put(ucClass.first);
+            writer.put(ucClass.second);
+        }
+    }
+    return body;
+}
+
+/**
+ * @brief Writes an encoded image as the snapshot file, replacing the previous one atomically.
+ *
+ * @param body The encoded image.
+ * @return True if the snapshot was written, otherwise false.
+ *
+ * @complexity O(N), where N is the number of students.
+ */
+bool StorageEngine::writeSnapshot(const string& body) const {
+    string data(SnapshotMagic, sizeof(SnapshotMagic));
+    data.append(body);
+    BinaryWriter writer(data);
+    writer.put(crc32(body.data(), body.size()));
+    return replaceFile(snapshotPath, data);
+}
+
+/**
+ * @brief Indexes the records of the history file of the current catalog, and opens it for appending.
+ *
+ * A record of the history is [type][time] followed by a journal record or an encoded image, which
+ * both start with the catalog fingerprint and the sequence number. Only their headers are read here.
+ * The times of the first histories were in seconds, they are read as the first nanosecond of their second.
+ *
+ * @return The highest sequence number in the history, of any catalog, or 0 if it is empty.
+ *
+ * @complexity O(n), where n is the number of records of the history.
+ */
+uint64_t StorageEngine::loadHistory() {
+    const vector<string_view>& records = history.load();
+    size_t keptRecords = 0;
+    uint64_t highest = 0;
+    for (const string_view& record : records) {
+        BinaryReader reader(record.data(), record.size());
+        uint8_t type;
+        int64_t time;
+        uint32_t fingerprint;
+        uint64_t sequence;
+        if (!reader.get(type) || type > (uint8_t) HistoryType::Keyframe || !reader.get(time) || !reader.get(fingerprint) || !reader.get(sequence)) {
+            break;
+        }
+        if (time < HistorySecondsLimit) {
+            time *= 1000000000;
+        }
+        keptRecords++;
+        highest = max(highest, sequence);
+        lastTime = max(lastTime, time);
+        if (fingerprint == catalogFingerprint) {
+            HistoryMark mark{sequence, time, history.offsetOf(record)};
+            ((HistoryType) type == HistoryType::Delta ? deltaMarks : keyframeMarks).push_back(mark);
+        }
+    }
+    if (history.tornTail() || keptRecords < records.size()) {
+        cerr << "ERROR: The roster history ends with an incomplete record, it was dropped." << endl;
+    }
+    history.open(keptRecords);
+    return highest;
+}
+
+/**
+ * @brief Appends a record to the history file and indexes it, with the lock held.
+ *
+ * @param type The type of the record.
+ * @param sequence The sequence number of the record.
+ * @param time The time of the record, in nanoseconds since the epoch.
+ * @param body The encoded journal record or image.
+ *
+ * @complexity O(b), where b is the size of the body.
+ */
+void StorageEngine::appendHistory(HistoryType type, uint64_t sequence, int64_t time, const string& body) {
+    string payload;
+    BinaryWriter writer(payload);
+    writer.put<uint8_t>((uint8_t) type);
+    writer.put(time);
+    payload.append(body);
+    HistoryMark mark{sequence, time, history.append(payload)};
+    (type == HistoryType::Delta ? deltaMarks : keyframeMarks).push_back(mark);
+    lastTime = max(lastTime, time);
+}
+
+/**
+ * @brief Gets the time of a new commit of the history, with the lock held.
+ *
+ * The times of the commits are unique and increasing even if the clock goes back or two commits are
+ * made in the same nanosecond, so a time names a single point of the history.
+ *
+ * @return The current time, or one nanosecond after the last record if the clock is behind it.
+ */
+int64_t StorageEngine::nextHistoryTime() const {
+    return max(getCurrentTime(), lastTime + 1);
+}
+
+/**
+ * @brief Copies the enrollment of the image to the students of the data context, in a single transaction.
+ *
+ * Only the students whose enrollment differs are edited. An enrollment with a UC or class that isn't
+ * in the catalog is left as it was read from the CSV files.
+ */
+void StorageEngine::restoreRoster() {
+    WriteTransaction transaction(*context);
+    for (const StudentImage& studentImage : image) {
+        bool valid = all_of(studentImage.classes.begin(), studentImage.classes.end(), [](const pair<UcId, ClassId>& ucClass) {
+            return ucClass.first != InvalidId && ucClass.second != InvalidId;
+        });
+        vector<Class> classes = context->unpack(studentImage.classes);
+        Student* student = context->findStudent(studentImage.studentCode);
+        if (valid && student != nullptr && !(student->UcToClasses == classes)) {
+            transaction.edit(*student).UcToClasses = std::move(classes);
+        }
+    }
+    transaction.commit();
+}
+
+/**
+ * @brief Journals the students changed by a commit.
+ *
+ * The record is appended to the journal and to the history buffers and synced in the background, so
+ * the commit doesn't wait for the disk. The checkpoint thread is woken when enough records are not in a snapshot.
+ *
+ * @param students The students whose enrollment changed.
+ *
+ * @complexity O(s * c), where s is the number of students and c their number of classes.
+ */
+void StorageEngine::onCommit(const vector<const Student*>& students) {
+    lock_guard<mutex> guard(lock);
+    uint64_t sequence = nextSequence++;
+    string payload = encodeRecord(sequence, students);
+    journal.append(payload);
+    appendHistory(HistoryType::Delta, sequence, nextHistoryTime(), payload);
+    unsnapshotted.emplace_back(sequence, std::move(payload));
+    if (unsnapshotted.size() - appliedToImage >= checkpointInterval) {
+        wakeUp.notify_one();
+    }
+}
+
+/**
+ * @brief Writes a checkpoint each time enough records are journaled, and a last one when the engine is closed.
+ *
+ * The new records are applied to the image and the snapshot is written without holding the lock, so
+ * commits go on meanwhile. The snapshot is also appended to the history as a keyframe. The journal is
+ * then cut to the records after the snapshot; commits wait for this rewrite, which only holds the few
+ * records journaled during the checkpoint.
+ */
+void StorageEngine::checkpointLoop() {
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        wakeUp.wait(guard, [this]() { return stopping || unsnapshotted.size() - appliedToImage >= checkpointInterval; });
+        bool last = stopping;
+        if (unsnapshotted.size() > appliedToImage) {
+            vector<string> fresh;
+            for (size_t i = appliedToImage; i < unsnapshotted.size(); i++) {
+                fresh.push_back(unsnapshotted[i].second);
+            }
+            appliedToImage = unsnapshotted.size();
+            guard.unlock();
+
+            uint64_t sequence = snapshotSequence;
+            for (const string& record : fresh) {
+                applyToImage(record, sequence);
+            }
+            snapshotSequence = sequence;
+            string body = encodeImage(snapshotSequence);
+            bool written = writeSnapshot(body);
+            if (!written) {
+                cerr << "ERROR: Could not write the roster snapshot, the journal is kept." << endl;
+            }
+
+            guard.lock();
+            if (keyframeMarks.empty() || snapshotSequence > keyframeMarks.back().sequence) {
+                // The keyframe has the time of the commit of its last record
+                auto last = lower_bound(deltaMarks.begin(), deltaMarks.end(), snapshotSequence,
+                                        [](const HistoryMark& mark, uint64_t key) { return mark.sequence < key; });
+                int64_t time = last != deltaMarks.end() && last->sequence == snapshotSequence ? last->time : lastTime;
+                appendHistory(HistoryType::Keyframe, snapshotSequence, time, body);
+            }
+            if (written) {
+                while (!unsnapshotted.empty() && unsnapshotted.front().first <= snapshotSequence) {
+                    unsnapshotted.pop_front();
+                    appliedToImage--;
+                }
+                vector<string> kept;
+                for (const auto& record : unsnapshotted) {
+                    kept.push_back(record.second);
+                }
+                journal.rewrite(kept);
+            }
+        }
+        if (last) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Waits until every commit journaled so far is on the disk.
+ */
+void StorageEngine::sync() {
+    journal.sync();
+}
+
+/**
+ * @brief Rebuilds the roster as it was at a given time, from the nearest keyframe and the commits after it.
+ *
+ * The last record of the history at that time is found by binary search on the times of the records,
+ * and the last keyframe before it by binary search on the sequence numbers. The keyframe and the
+ * commits between the two are then read from the history file, so at most one checkpoint interval of
+ * commits is replayed, however old the time is. The names of the students are the ones of the keyframe,
+ * and the catalog is shared with the live context.
+ *
+ * @param time The time, in nanoseconds since the epoch.
+ * @return A data context with the catalog and the roster of that time, or nullptr if the history doesn't reach that time.
+ *
+ * @complexity O(log n + N log N + d), where n is the number of records of the history, N the number of students and d the size of the commits replayed.
+ */
+shared_ptr<DataContext> StorageEngine::rosterAsOf(int64_t time) {
+    auto bySequence = [](const HistoryMark& mark, uint64_t key) { return mark.sequence < key; };
+    auto byTime = [](int64_t key, const HistoryMark& mark) { return key < mark.time; };
+
+    unique_lock<mutex> guard(lock);
+    auto lastDelta = upper_bound(deltaMarks.begin(), deltaMarks.end(), time, byTime);
+    auto lastKeyframe = upper_bound(keyframeMarks.begin(), keyframeMarks.end(), time, byTime);
+    if (lastKeyframe == keyframeMarks.begin()) {
+        return nullptr;
+    }
+    uint64_t target = (lastKeyframe - 1)->sequence;
+    if (lastDelta != deltaMarks.begin()) {
+        target = max(target, (lastDelta - 1)->sequence);
+    }
+    HistoryMark keyframe = *(lower_bound(keyframeMarks.begin(), keyframeMarks.end(), target + 1, bySequence) - 1);
+    auto firstDelta = lower_bound(deltaMarks.begin(), deltaMarks.end(), keyframe.sequence + 1, bySequence);
+    auto endDelta = lower_bound(firstDelta, deltaMarks.end(), target + 1, bySequence);
+    if ((uint64_t) (endDelta - firstDelta) != target - keyframe.sequence) {
+        cerr << "ERROR: The roster history lost some commits around that time, it can't be rebuilt." << endl;
+        return nullptr;
+    }
+    uint64_t firstOffset = firstDelta != endDelta ? firstDelta->offset : 0;
+    uint64_t lastOffset = firstDelta != endDelta ? (endDelta - 1)->offset : 0;
+    guard.unlock();
+
+    history.sync();
+    vector<string> records;
+    if (!history.read(keyframe.offset, keyframe.offset, records) || (firstDelta != endDelta && !history.read(firstOffset, lastOffset, records))) {
+        cerr << "ERROR: The roster history could not be read." << endl;
+        return nullptr;
+    }
+
+    vector<Student> roster;
+    unordered_map<int, size_t> position;
+    bool ok = true;
+    for (size_t i = 0; ok && i < records.size(); i++) {
+        BinaryReader reader(records[i].data(), records[i].size());
+        uint8_t type;
+        int64_t recordTime;
+        uint32_t fingerprint;
+        uint64_t sequence;
+        ok = reader.get(type) && reader.get(recordTime) && reader.get(fingerprint) && reader.get(sequence);
+        bool isKeyframe = (HistoryType) type == HistoryType::Keyframe;
+        if (!ok || (i > 0 && isKeyframe) || fingerprint != catalogFingerprint || sequence > target) {
+            continue; // the keyframes written between the commits
+        }
+        ok = readEnrollments(reader, isKeyframe, [&](int studentCode, string& studentName, PackedEnrollment& classes) {
+            if (isKeyframe) {
+                position[studentCode] = roster.size();
+                roster.emplace_back(studentCode, studentName);
+                roster.back().UcToClasses = context->unpack(classes);
+            } else if (position.count(studentCode)) {
+                roster[position[studentCode]].UcToClasses = context->unpack(classes);
+            }
+        });
+    }
+    if (!ok) {
+        cerr << "ERROR: The roster history is corrupted around that time." << endl;
+        return nullptr;
+    }
+
+    StudentBST students;
+    sort(roster.begin(), roster.end());
+    insertBalanced(students, roster, 0, roster.size());
+    return make_shared<DataContext>(context->getCatalog(), students);
+}
+
+/**
+ * @brief Gets the time since when the roster can be rebuilt.
+ *
+ * @return The time of the first keyframe of the history, in nanoseconds since the epoch.
+ */
+int64_t StorageEngine::historyStart() {
+    lock_guard<mutex> guard(lock);
+    return keyframeMarks.empty() ? 0 : keyframeMarks.front().time;
+}
+
+/**
+ * @brief Gets the time the history gives to the last commit, to find the roster right after it.
+ *
+ * The time is the one of the commit in the history, not the clock, so the roster as of that time has
+ * that commit and none made after it.
+ *
+ * @return The time of the last record of the history, in nanoseconds since the epoch.
+ */
+int64_t StorageEngine::lastCommitTime() {
+    lock_guard<mutex> guard(lock);
+    return lastTime;
+}
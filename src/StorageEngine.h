@@ -0,0 +1,205 @@
+/**
+ * @file StorageEngine.h
+ * @brief Header file for the StorageEngine class.
+ */
+
+#ifndef PROJETO_AED_STORAGEENGINE_H
+#define PROJETO_AED_STORAGEENGINE_H
+
+#include "DataContext.h"
+#include "JournalFile.h"
+#include <deque>
+
+/**
+ * @class StorageEngine
+ * @brief Keeps the enrollment of every student on the disk, as a snapshot and a journal of the commits after it.
+ *
+ * Each commit of the DataContext appends to the journal a record with a sequence number and the new
+ * enrollment of the students it changed, as UC and class ids. The record is synced in the background
+ * by the group commit of the JournalFile, so a commit only costs its encoding.
+ *
+ * A checkpoint thread keeps its own image of the roster. Every few commits it applies the new journal
+ * records to the image, writes the image as a binary snapshot (atomically, through a temporary file)
+ * and then cuts the journal to the records after the snapshot. On startup the enrollments of the
+ * snapshot and then of the journal records after it are applied to the roster read from the CSV files,
+ * so recovery reads at most one snapshot and a bounded journal.
+ *
+ * Snapshots and records carry a fingerprint of the catalog, and are ignored if the catalog changed,
+ * as their ids would no longer name the same UCs and classes.
+ *
+ * The journal records are also appended, with the time of their commit, to a history file that is
+ * never cut, and each snapshot is appended to it as a keyframe. The roster as of any time is then
+ * rebuilt from the last keyframe before it and the few records between the two, whose offsets in the
+ * file are kept in memory.
+ */
+class StorageEngine {
+private:
+    /**
+     * @struct StudentImage
+     * @brief The enrollment of a student as stored on the disk.
+     */
+    struct StudentImage {
+        int studentCode;                     ///< The code of the student.
+        string studentName;                  ///< The name of the student.
+        PackedEnrollment classes;            ///< The UC and class ids of the enrollment.
+    };
+
+    /**
+     * @enum HistoryType
+     * @brief The types of the records of the history file.
+     */
+    enum class HistoryType : uint8_t {
+        Delta,    ///< The enrollment of the students changed by a commit, as in the journal.
+        Keyframe  ///< The enrollment of every student, as in a snapshot.
+    };
+
+    /**
+     * @struct HistoryMark
+     * @brief The position of a record in the history file.
+     */
+    struct HistoryMark {
+        uint64_t sequence; ///< The sequence number of the record.
+        int64_t time;      ///< The time of the commit of the record, in nanoseconds since the epoch, different for each commit.
+        uint64_t offset;   ///< The offset of the record in the history file.
+    };
+
+    shared_ptr<DataContext> context; ///< The data context whose commits are stored.
+    string snapshotPath;             ///< The path of the snapshot file.
+    JournalFile journal;             ///< The journal of the commits after the snapshot.
+    uint32_t catalogFingerprint;     ///< The checksum of the UC and class codes of the catalog.
+    size_t checkpointInterval;       ///< The number of journal records that triggers a checkpoint.
+
+    mutex lock;                          ///< Protects the sequence number and the records not in a snapshot yet.
+    condition_variable wakeUp;           ///< Signals the checkpoint thread that a checkpoint is due or that the engine is closing.
+    uint64_t nextSequence;               ///< The sequence number of the next journal record.
+    deque<pair<uint64_t, string>> unsnapshotted; ///< The journal records not in a snapshot yet, with their sequence numbers.
+    size_t appliedToImage;               ///< The number of unsnapshotted records already applied to the image.
+    bool stopping;                       ///< True when the engine is being closed.
+
+    vector<StudentImage> image;                 ///< The roster of the checkpoint thread, sorted by student code.
+    unordered_map<int, size_t> imagePosition;   ///< The position of each student code in the image.
+    uint64_t snapshotSequence;                  ///< The sequence number of the last record in the snapshot.
+    thread checkpointer;                        ///< Writes the snapshots and cuts the journal.
+    size_t observerId;                          ///< The id of the commit observer that journals the commits.
+
+    JournalFile history;                 ///< The history of the commits and the snapshots, never cut.
+    vector<HistoryMark> deltaMarks;      ///< The commits of the history of the current catalog, by sequence number.
+    vector<HistoryMark> keyframeMarks;   ///< The keyframes of the history of the current catalog, by sequence number.
+    int64_t lastTime;                    ///< The time of the last record of the history, so that times always go forward.
+
+    /**
+     * @brief Encode the enrollment of some students as a journal record.
+     * @param sequence The sequence number of the record.
+     * @param students The students.
+     * @return The payload of the record.
+     */
+    string encodeRecord(uint64_t sequence, const vector<const Student*>& students) const;
+
+    /**
+     * @brief Apply a journal record to the image.
+     * @param record The payload of the record.
+     * @param sequence The sequence number of the record.
+     * @return True if the record is valid and of the current catalog, otherwise false.
+     */
+    bool applyToImage(string_view record, uint64_t& sequence);
+
+    /**
+     * @brief Replace the enrollment of the image with the one of a snapshot file.
+     * @return True if a valid snapshot of the current catalog was read, otherwise false.
+     */
+    bool loadSnapshot();
+
+    /**
+     * @brief Encode the image as the body of a snapshot or of a keyframe.
+     * @param sequence The sequence number of the last record applied to the image.
+     * @return The encoded image.
+     */
+    string encodeImage(uint64_t sequence) const;
+
+    /**
+     * @brief Write an encoded image as the snapshot file.
+     * @param body The encoded image.
+     * @return True if the snapshot was written, otherwise false.
+     */
+    bool writeSnapshot(const string& body) const;
+
+    /**
+     * @brief Index the records of the history file of the current catalog.
+     * @return The highest sequence number in the history, of any catalog, or 0 if it is empty.
+     */
+    uint64_t loadHistory();
+
+    /**
+     * @brief Append a record to the history file and index it, with the lock held.
+     * @param type The type of the record.
+     * @param sequence The sequence number of the record.
+     * @param time The time of the record, in nanoseconds since the epoch.
+     * @param body The encoded journal record or image.
+     */
+    void appendHistory(HistoryType type, uint64_t sequence, int64_t time, const string& body);
+
+    /**
+     * @brief Get the time of a new commit of the history, with the lock held.
+     * @return The current time, or just after the last record if the clock is behind it.
+     */
+    int64_t nextHistoryTime() const;
+
+    /**
+     * @brief Copy the enrollment of the image to the students of the data context.
+     */
+    void restoreRoster();
+
+    /**
+     * @brief Journal the students changed by a commit, called by the data context.
+     * @param students The students whose enrollment changed.
+     */
+    void onCommit(const vector<const Student*>& students);
+
+    /**
+     * @brief Write a checkpoint each time enough records are journaled, until the engine is closed.
+     */
+    void checkpointLoop();
+
+public:
+    /**
+     * @brief Constructor for the StorageEngine class, restores the stored roster and starts journaling the commits.
+     * @param context The data context, with the roster read from the CSV files.
+     * @param basePath The path of the storage files, without their extensions.
+     * @param checkpointInterval The number of journal records that triggers a checkpoint.
+     */
+    StorageEngine(shared_ptr<DataContext> context, const string& basePath, size_t checkpointInterval = 256);
+
+    /**
+     * @brief Destructor for the StorageEngine class, writes a last checkpoint and stops journaling the commits.
+     */
+    ~StorageEngine();
+
+    StorageEngine(const StorageEngine&) = delete;
+    StorageEngine& operator=(const StorageEngine&) = delete;
+
+    /**
+     * @brief Wait until every commit journaled so far is on the disk.
+     */
+    void sync();
+
+    /**
+     * @brief Rebuild the roster as it was at a given time, from the nearest keyframe and the commits after it.
+     * @param time The time, in nanoseconds since the epoch.
+     * @return A data context with the catalog and the roster of that time, or nullptr if the history doesn't reach that time.
+     */
+    shared_ptr<DataContext> rosterAsOf(int64_t time);
+
+    /**
+     * @brief Get the time since when the roster can be rebuilt.
+     * @return The time of the first keyframe of the history, in nanoseconds since the epoch.
+     */
+    int64_t historyStart();
+
+    /**
+     * @brief Get the time the history gives to the last commit, to find the roster right after it.
+     * @return The time of the last record of the history, in nanoseconds since the epoch.
+     */
+    int64_t lastCommitTime();
+};
+
+#endif //PROJETO_AED_STORAGEENGINE_H
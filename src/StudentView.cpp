@@ -0,0 +1,125 @@
+/**
+ * @file StudentView.cpp
+ * @brief Implementation of the StudentView class.
+ */
+
+#include "StudentView.h"
+#include <algorithm>
+
+/**
+ * @brief Constructor for the StudentView class, in ascending name order.
+ *
+ * @param students The students of the DataContext, by handle.
+ * @param codes The code of each student of the DataContext, by handle.
+ * @param handles The handles of the students of the view, sorted and without repetitions.
+ */
+StudentView::StudentView(const vector<Student*>& students, const vector<int>& codes, vector<StudentHandle> handles)
+    : students(&students), codes(&codes), handles(std::move(handles)), order(StudentOrder::Name), descending(false),
+      ordered(this->handles.size()) {}
+
+/**
+ * @brief Get the number of students of the view.
+ *
+ * @return The number of students.
+ */
+size_t StudentView::size() const {
+    return handles.size();
+}
+
+/**
+ * @brief Check if the view has no students.
+ *
+ * @return True if the view is empty, otherwise false.
+ */
+bool StudentView::empty() const {
+    return handles.empty();
+}
+
+/**
+ * @brief Change the order of the view.
+ *
+ * In name order the handles are sorted again only if an order by code had moved them; in code order
+ * they are sorted lazily, as pages are read.
+ *
+ * @param order The order of the students.
+ * @param descending True to reverse the order.
+ *
+ * @complexity O(1), or O(n log n) when going back to name order after an order by code.
+ */
+void StudentView::orderBy(StudentOrder order, bool descending) {
+    if (order == this->order && descending == this->descending) {
+        return;
+    }
+    if (order == StudentOrder::Name) {
+        if (this->order == StudentOrder::Code) {
+            sort(handles.begin(), handles.end());
+        }
+        ordered = handles.size();
+    } else {
+        ordered = 0;
+    }
+    this->order = order;
+    this->descending = descending;
+}
+
+/**
+ * @brief Put the handles up to a position in their final order.
+ *
+ * In name order they always are, in either direction: a descending page is read from the back. In
+ * code order the handles after the ordered ones are partially sorted, only up to the position.
+ *
+ * @param end The position the handles are ordered up to.
+ *
+ * @complexity O(n log k), where n is the number of handles not yet ordered and k the number to order.
+ */
+void StudentView::orderUpTo(size_t end) {
+    end = min(end, handles.size());
+    if (end <= ordered) {
+        return;
+    }
+    const vector<int>& byHandle = *codes;
+    if (descending) {
+        partial_sort(handles.begin() + ordered, handles.begin() + end, handles.end(), [&byHandle](StudentHandle a, StudentHandle b) {
+            return byHandle[a] > byHandle[b];
+        });
+    } else {
+        partial_sort(handles.begin() + ordered, handles.begin() + end, handles.end(), [&byHandle](StudentHandle a, StudentHandle b) {
+            return byHandle[a] < byHandle[b];
+        });
+    }
+    ordered = end;
+}
+
+/**
+ * @brief Get a page of the students of the view, in its order.
+ *
+ * @param offset The position of the first student of the page.
+ * @param limit The maximum number of students of the page.
+ * @return The students of the page, fewer than the limit at the end of the view.
+ *
+ * @complexity O(k) in name order, where k is the limit; in code order, the ordering up to the end of the page.
+ */
+vector<const Student*> StudentView::page(size_t offset, size_t limit) {
+    vector<const Student*> result;
+    if (offset >= handles.size()) {
+        return result;
+    }
+    size_t end = offset + min(limit, handles.size() - offset);
+    orderUpTo(end);
+    result.reserve(end - offset);
+    bool reversed = order == StudentOrder::Name && descending;
+    for (size_t i = offset; i < end; i++) {
+        result.push_back((*students)[handles[reversed ? handles.size() - 1 - i : i]]);
+    }
+    return result;
+}
+
+/**
+ * @brief Get the first students of the view, in its order.
+ *
+ * @param k The maximum number of students.
+ * @return The first k students.
+ */
+vector<const Student*> StudentView::top(size_t k) {
+    return page(0, k);
+}
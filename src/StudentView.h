@@ -0,0 +1,99 @@
+/**
+ * @file StudentView.h
+ * @brief Header file for the StudentView class.
+ */
+
+#ifndef PROJETO_AED_STUDENTVIEW_H
+#define PROJETO_AED_STUDENTVIEW_H
+
+#include "Data.h"
+
+/**
+ * @brief The position of a student in the roster in name order, a compact id for the student.
+ *
+ * The handles of a DataContext follow the order of its students by name and then by code, so sorting
+ * handles sorts the students. They stay valid until the whole roster is replaced (e.g. by an undo).
+ */
+typedef uint32_t StudentHandle;
+
+/**
+ * @enum StudentOrder
+ * @brief The order of the students of a StudentView.
+ */
+enum class StudentOrder {
+    Name, ///< By name and then by code, so students with the same name keep a stable order.
+    Code  ///< By student code.
+};
+
+/**
+ * @class StudentView
+ * @brief The result of a query on the students: the handles of the matching students, read a page at a time.
+ *
+ * A view holds only the handles of its students, never a copy of them, and is built from the indexes
+ * of the DataContext without reading the students themselves. A page reads only the students on it:
+ * in name order the handles are already sorted, and in code order only the handles up to the end of
+ * the page are sorted, by the codes of the DataContext, so the first page of a large result (its top-K)
+ * costs O(n log k) comparisons of integers and the reading of k students.
+ *
+ * A view must not be kept across a write transaction, its handles may not be the same afterwards.
+ */
+class StudentView {
+private:
+    const vector<Student*>* students; ///< The students of the DataContext, by handle.
+    const vector<int>* codes;         ///< The code of each student of the DataContext, by handle.
+    vector<StudentHandle> handles;    ///< The handles of the students of the view.
+    StudentOrder order;               ///< The order of the view.
+    bool descending;                  ///< True if the order is reversed.
+    size_t ordered;                   ///< The number of handles at the front already in their final order.
+
+    /**
+     * @brief Put the handles up to a position in their final order.
+     * @param end The position the handles are ordered up to.
+     */
+    void orderUpTo(size_t end);
+
+public:
+    /**
+     * @brief Constructor for the StudentView class, in ascending name order.
+     * @param students The students of the DataContext, by handle.
+     * @param codes The code of each student of the DataContext, by handle.
+     * @param handles The handles of the students of the view, sorted and without repetitions.
+     */
+    StudentView(const vector<Student*>& students, const vector<int>& codes, vector<StudentHandle> handles);
+
+    /**
+     * @brief Get the number of students of the view.
+     * @return The number of students.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Check if the view has no students.
+     * @return True if the view is empty, otherwise false.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Change the order of the view.
+     * @param order The order of the students.
+     * @param descending True to reverse the order.
+     */
+    void orderBy(StudentOrder order, bool descending = false);
+
+    /**
+     * @brief Get a page of the students of the view, in its order.
+     * @param offset The position of the first student of the page.
+     * @param limit The maximum number of students of the page.
+     * @return The students of the page, fewer than the limit at the end of the view.
+     */
+    vector<const Student*> page(size_t offset, size_t limit);
+
+    /**
+     * @brief Get the first students of the view, in its order.
+     * @param k The maximum number of students.
+     * @return The first k students.
+     */
+    vector<const Student*> top(size_t k);
+};
+
+#endif //PROJETO_AED_STUDENTVIEW_H
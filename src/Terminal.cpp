@@ -0,0 +1,246 @@
+/**
+ * @file Terminal.cpp
+ * @brief Implementation of the Terminal class.
+ */
+
+#include "Terminal.h"
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <streambuf>
+#include <unistd.h>
+
+namespace {
+    /**
+     * @class ScreenBuffer
+     * @brief The stream buffer of cout on a terminal: keeps the output until the screen is presented.
+     *
+     * The screen can be presented by an error written from another thread, so the output is kept under a lock.
+     */
+    class ScreenBuffer : public streambuf {
+    private:
+        static const size_t MaxPending = 1 << 16; ///< The output kept before a part of a long screen is written anyway.
+
+        streambuf* target;  ///< The stream buffer of the terminal.
+        mutex lock;         ///< Protects the pending output and the state of the screen.
+        string pending;     ///< The output not yet written.
+        bool newScreen;     ///< True if the pending output starts a new screen.
+        bool inScreen;      ///< True while a new screen is written in parts, its end not yet written.
+
+        /**
+         * @brief Writes the pending output to the terminal, with the lock held.
+         *
+         * A new screen starts at the top left corner, and each of its lines erases the rest of the line
+         * it is written over; its end erases the rest of the previous screen.
+         *
+         * @param end True if the screen is complete, false if only a part of a long screen is written.
+         */
+        void write(bool end) {
+            string out;
+            if (newScreen) {
+                out += "\033[H";
+                inScreen = true;
+                newScreen = false;
+            }
+            if (inScreen) {
+                out.reserve(out.size() + pending.size() + pending.size() / 16 + 8);
+                for (char c : pending) {
+                    if (c == '\n') {
+                        out += "\033[K";
+                    }
+                    out += c;
+                }
+                if (end) {
+                    out += "\033[J";
+                    inScreen = false;
+                }
+            } else {
+                out.swap(pending);
+            }
+            pending.clear();
+            if (!out.empty()) {
+                target->sputn(out.data(), (streamsize) out.size());
+                target->pubsync();
+            }
+        }
+
+    protected:
+        int overflow(int c) override {
+            lock_guard<mutex> guard(lock);
+            if (c != EOF) {
+                pending += (char) c;
+            }
+            return c == EOF ? 0 : c;
+        }
+
+        streamsize xsputn(const char* data, streamsize size) override {
+            lock_guard<mutex> guard(lock);
+            pending.append(data, (size_t) size);
+            return size;
+        }
+
+        /**
+         * @brief Called by flush and endl: the output is kept, unless a long screen has a large part of it pending.
+         */
+        int sync() override {
+            lock_guard<mutex> guard(lock);
+            if (pending.size() >= MaxPending) {
+                write(false);
+            }
+            return 0;
+        }
+
+    public:
+        explicit ScreenBuffer(streambuf* target) : target(target), newScreen(false), inScreen(false) {}
+
+        /**
+         * @brief Starts a new screen, after writing what the current one still has pending.
+         */
+        void clear() {
+            lock_guard<mutex> guard(lock);
+            if (!pending.empty() || inScreen) {
+                write(true);
+            }
+            newScreen = true;
+        }
+
+        /**
+         * @brief Writes the pending output, and the end of a new screen.
+         */
+        void present() {
+            lock_guard<mutex> guard(lock);
+            if (!pending.empty() || newScreen || inScreen) {
+                write(true);
+            }
+        }
+    };
+
+    /**
+     * @class PresentingBuffer
+     * @brief A stream buffer that presents the screen before reading or writing through another stream buffer.
+     *
+     * It wraps the stream buffers of cin and cerr, so that the screen is shown before the user is asked for
+     * input and before an error message.
+     */
+    class PresentingBuffer : public streambuf {
+    private:
+        streambuf* source;  ///< The wrapped stream buffer.
+        ScreenBuffer& screen; ///< The screen to present first.
+        char current;       ///< The character read last, the get area of this buffer.
+
+    protected:
+        int underflow() override {
+            screen.present();
+            int c = source->sbumpc();
+            if (c == EOF) {
+                return EOF;
+            }
+            current = (char) c;
+            setg(&current, &current, &current + 1);
+            return (unsigned char) current;
+        }
+
+        int overflow(int c) override {
+            screen.present();
+            return c == EOF ? 0 : source->sputc((char) c);
+        }
+
+        streamsize xsputn(const char* data, streamsize size) override {
+            screen.present();
+            return source->sputn(data, size);
+        }
+
+        int sync() override {
+            return source->pubsync();
+        }
+
+    public:
+        PresentingBuffer(streambuf* source, ScreenBuffer& screen) : source(source), screen(screen), current(0) {}
+    };
+
+    /**
+     * @class InstalledTerminal
+     * @brief The stream buffers installed on cout, cin and cerr, restored when the program exits.
+     */
+    class InstalledTerminal {
+    private:
+        streambuf* coutBuffer; ///< The stream buffer of cout before the installation.
+        streambuf* cinBuffer;  ///< The stream buffer of cin before the installation.
+        streambuf* cerrBuffer; ///< The stream buffer of cerr before the installation.
+
+    public:
+        ScreenBuffer screen;    ///< The stream buffer of cout.
+        PresentingBuffer input; ///< The stream buffer of cin.
+        PresentingBuffer error; ///< The stream buffer of cerr.
+
+        InstalledTerminal()
+            : coutBuffer(cout.rdbuf()), cinBuffer(cin.rdbuf()), cerrBuffer(cerr.rdbuf()), screen(coutBuffer),
+              input(cinBuffer, screen), error(cerrBuffer, screen) {
+            cout.flush();
+            cout.rdbuf(&screen);
+            cin.rdbuf(&input);
+            cerr.rdbuf(&error);
+        }
+
+        ~InstalledTerminal() {
+            screen.present();
+            cout.rdbuf(coutBuffer);
+            cin.rdbuf(cinBuffer);
+            cerr.rdbuf(cerrBuffer);
+        }
+    };
+
+    InstalledTerminal* installed = nullptr; ///< The installed stream buffers, null when not installed.
+}
+
+/**
+ * @brief Starts buffering the screens of cout, if stdout is a terminal.
+ *
+ * The stream buffers are installed once, and restored by a static object when the program exits, after
+ * the last screen is presented.
+ */
+void Terminal::install() {
+    if (installed != nullptr || !isInteractive()) {
+        return;
+    }
+    static InstalledTerminal terminal;
+    installed = &terminal;
+}
+
+/**
+ * @brief Checks if stdout is a terminal that understands ANSI escape sequences.
+ *
+ * @return True for a terminal, false for a pipe, a file or a dumb terminal.
+ */
+bool Terminal::isInteractive() {
+    static const bool interactive = [] {
+        const char* term = getenv("TERM");
+        return isatty(STDOUT_FILENO) == 1 && (term == nullptr || strcmp(term, "dumb") != 0);
+    }();
+    return interactive;
+}
+
+/**
+ * @brief Starts a new screen, which replaces the current one when it is written.
+ *
+ * Without the screen buffer installed on a terminal, the screen is cleared right away with the escape
+ * sequences; when not interactive, nothing is written.
+ */
+void Terminal::clear() {
+    if (installed != nullptr) {
+        installed->screen.clear();
+    } else if (isInteractive()) {
+        cout << "\033[H\033[2J" << flush;
+    }
+}
+
+/**
+ * @brief Writes the screen built so far to the terminal.
+ */
+void Terminal::present() {
+    if (installed != nullptr) {
+        installed->screen.present();
+    } else {
+        cout.flush();
+    }
+}
@@ -0,0 +1,52 @@
+/**
+ * @file Terminal.h
+ * @brief Header file for the Terminal class.
+ */
+
+#ifndef PROJETO_AED_TERMINAL_H
+#define PROJETO_AED_TERMINAL_H
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+/**
+ * @class Terminal
+ * @brief Clears and redraws the screens of the application with ANSI escape sequences, a whole screen at a time.
+ *
+ * Once installed on a terminal, the output of cout is kept in memory and written to the terminal only
+ * when the application waits for input, writes an error, or exits; a screen is then written at once
+ * instead of line by line. Clearing the screen doesn't erase it: the next screen is written over the
+ * previous one, from the top left corner, erasing the rest of each line it writes, and whatever is left
+ * below it is erased when it is complete. So a screen is replaced by the next one without blinking,
+ * and without running an external program as system("clear") did.
+ *
+ * When stdout is not a terminal (a pipe or a file), or the terminal is "dumb", nothing is installed:
+ * the output is written as it is, and clearing the screen writes nothing.
+ */
+class Terminal {
+public:
+    /**
+     * @brief Start buffering the screens of cout, if stdout is a terminal; the output written so far is kept.
+     */
+    static void install();
+
+    /**
+     * @brief Check if stdout is a terminal that understands ANSI escape sequences.
+     * @return True for a terminal, false for a pipe, a file or a dumb terminal.
+     */
+    static bool isInteractive();
+
+    /**
+     * @brief Start a new screen, which replaces the current one when it is written; does nothing when not interactive.
+     */
+    static void clear();
+
+    /**
+     * @brief Write the screen built so far to the terminal.
+     */
+    static void present();
+};
+
+#endif //PROJETO_AED_TERMINAL_H
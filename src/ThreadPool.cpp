@@ -0,0 +1,109 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Implementation of the ThreadPool class.
+ */
+
+#include "ThreadPool.h"
+
+/**
+ * @brief Constructor for the ThreadPool class, starts threadCount - 1 workers.
+ *
+ * @param threadCount The total number of threads, including the caller of parallelFor.
+ */
+ThreadPool::ThreadPool(unsigned threadCount)
+    : task(nullptr), taskCount(0), nextIndex(0), busyWorkers(0), generation(0), stopping(false) {
+    for (unsigned i = 1; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ * @brief Stops and joins every worker thread.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Gets the number of threads used by parallelFor, including the caller.
+ *
+ * @return The number of threads.
+ */
+unsigned ThreadPool::size() const {
+    return workers.size() + 1;
+}
+
+/**
+ * @brief Takes and runs iterations of the current loop until there are none left.
+ *
+ * Iterations are taken in small blocks, to keep the threads from competing for every index.
+ */
+void ThreadPool::runIterations() {
+    const size_t block = 16;
+    for (size_t first = nextIndex.fetch_add(block); first < taskCount; first = nextIndex.fetch_add(block)) {
+        size_t last = min(first + block, taskCount);
+        for (size_t i = first; i < last; i++) {
+            (*task)(i);
+        }
+    }
+}
+
+/**
+ * @brief The loop of each worker thread, waits for a new loop, runs its iterations and reports back.
+ */
+void ThreadPool::workerLoop() {
+    unsigned long seenGeneration = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(lock);
+            wakeUp.wait(guard, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) {
+                return;
+            }
+            seenGeneration = generation;
+        }
+
+        runIterations();
+
+        lock_guard<mutex> guard(lock);
+        if (--busyWorkers == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief Runs body(i) for every i in [0, count) across the threads of the pool.
+ *
+ * @param count The number of iterations.
+ * @param body The body of the loop, it must be safe to run concurrently for different i.
+ *
+ * @complexity O(count / size()) per thread, if the iterations take the same time.
+ */
+void ThreadPool::parallelFor(size_t count, const function<void(size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    {
+        lock_guard<mutex> guard(lock);
+        task = &body;
+        taskCount = count;
+        nextIndex = 0;
+        busyWorkers = workers.size();
+        generation++;
+    }
+    wakeUp.notify_all();
+
+    runIterations();
+
+    unique_lock<mutex> guard(lock);
+    finished.wait(guard, [&] { return busyWorkers == 0; });
+    task = nullptr;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file ThreadPool.h
+ * @brief Header file for the ThreadPool class.
+ */
+
+#ifndef PROJETO_AED_THREADPOOL_H
+#define PROJETO_AED_THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+using namespace std;
+
+/**
+ * @class ThreadPool
+ * @brief A fixed set of worker threads that run the iterations of a loop in parallel.
+ *
+ * The workers are created once and wait for work between loops. The thread that calls parallelFor
+ * also runs iterations, and only returns when every iteration has finished.
+ */
+class ThreadPool {
+private:
+    vector<thread> workers;            ///< The worker threads.
+    mutex lock;                        ///< Protects the state shared with the workers.
+    condition_variable wakeUp;         ///< Signals the workers that there is a new loop or that the pool is stopping.
+    condition_variable finished;       ///< Signals the caller that every worker left the current loop.
+    const function<void(size_t)>* task; ///< The body of the current loop.
+    size_t taskCount;                  ///< The number of iterations of the current loop.
+    atomic<size_t> nextIndex;          ///< The next iteration to be taken.
+    size_t busyWorkers;                ///< The number of workers still in the current loop.
+    unsigned long generation;          ///< Incremented on each loop, so workers don't run the same loop twice.
+    bool stopping;                     ///< True when the pool is being destroyed.
+
+    /**
+     * @brief Take and run iterations of the current loop until there are none left.
+     */
+    void runIterations();
+
+    /**
+     * @brief The loop of each worker thread.
+     */
+    void workerLoop();
+
+public:
+    /**
+     * @brief Constructor for the ThreadPool class.
+     * @param threadCount The total number of threads, including the caller of parallelFor.
+     */
+    explicit ThreadPool(unsigned threadCount = thread::hardware_concurrency());
+
+    /**
+     * @brief Stop and join every worker thread.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Get the number of threads used by parallelFor, including the caller.
+     * @return The number of threads.
+     */
+    unsigned size() const;
+
+    /**
+     * @brief Run body(i) for every i in [0, count) across the threads of the pool.
+     * @param count The number of iterations.
+     * @param body The body of the loop, it must be safe to run concurrently for different i.
+     */
+    void parallelFor(size_t count, const function<void(size_t)>& body);
+};
+
+#endif //PROJETO_AED_THREADPOOL_H
@@ -0,0 +1,376 @@
+/**
+ * @file TimetableExporter.cpp
+ * @brief Implementation of the TimetableExporter class.
+ */
+
+#include "TimetableExporter.h"
+#include "JournalFile.h"
+#include "UtilityFunctions.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace {
+    const char* const weekdays[] = {"Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"};
+    const uint32_t UnknownDay = 7; ///< The day index of a weekday that isn't a day of the week, after every other day.
+
+    /**
+     * @brief Gets the index of a day of the week, Monday first.
+     *
+     * @param weekDay The name of the day.
+     * @return The index of the day, or UnknownDay.
+     */
+    uint32_t dayIndex(const string& weekDay) {
+        auto it = find(weekdays, weekdays + 7, weekDay);
+        return (uint32_t) (it - weekdays);
+    }
+
+    /**
+     * @brief Parses a YYYY-MM-DD date into the UTC time of its noon.
+     *
+     * @param date The date.
+     * @param time Receives the time.
+     * @return True if the date is valid, otherwise false.
+     */
+    bool parseDate(const string& date, time_t& time) {
+        int year, month, day;
+        char end;
+        if (date.size() != 10 || sscanf(date.c_str(), "%4d-%2d-%2d%c", &year, &month, &day, &end) != 3) {
+            return false;
+        }
+        tm fields = {};
+        fields.tm_year = year - 1900;
+        fields.tm_mon = month - 1;
+        fields.tm_mday = day;
+        fields.tm_hour = 12;
+        time = timegm(&fields);
+        // timegm normalizes the fields, an invalid day or month moves the date
+        return fields.tm_year == year - 1900 && fields.tm_mon == month - 1 && fields.tm_mday == day;
+    }
+
+    /**
+     * @brief Formats a UTC time with strftime.
+     *
+     * @param time The time.
+     * @param format The strftime format.
+     * @return The formatted time.
+     */
+    string formatUtc(time_t time, const char* format) {
+        tm fields = {};
+        gmtime_r(&time, &fields);
+        char text[32];
+        return string(text, strftime(text, sizeof(text), format, &fields));
+    }
+
+    /**
+     * @brief Formats a time of the day as the HHMMSS of an iCalendar date-time.
+     *
+     * A time outside of the day is clamped to it, so a bad schedule can't make an invalid date-time.
+     *
+     * @param hours The time, in hours.
+     * @return The formatted time.
+     */
+    string icsTime(float hours) {
+        long minutes = clamp(lround(hours * 60), 0L, 24L * 60 - 1);
+        char text[8] = {'0', '0', '0', '0', '0', '0'};
+        to_chars(text + (minutes / 60 < 10 ? 1 : 0), text + 2, minutes / 60);
+        to_chars(text + (minutes % 60 < 10 ? 3 : 2), text + 4, minutes % 60);
+        return string(text, 6);
+    }
+
+    /**
+     * @brief Appends an iCalendar text property, escaping its value and folding it into lines of at most 75 bytes.
+     *
+     * The lines are only folded between UTF-8 characters.
+     *
+     * @param out The buffer the property is appended to.
+     * @param name The name of the property.
+     * @param value The value of the property.
+     */
+    void appendTextProperty(string& out, const string& name, const string& value) {
+        string line = name + ":";
+        for (char c : value) {
+            if (c == '\\' || c == ';' || c == ',') {
+                line += '\\';
+            }
+            line += c;
+        }
+        size_t start = 0;
+        while (line.size() - start > 75) {
+            size_t end = start + 75 - (start > 0 ? 1 : 0);
+            while (end > start + 1 && ((unsigned char) line[end] & 0xC0) == 0x80) {
+                end--;
+            }
+            out.append(line, start, end - start);
+            out += "\r\n ";
+            start = end;
+        }
+        out.append(line, start, string::npos);
+        out += "\r\n";
+    }
+
+    /**
+     * @brief Writes a whole buffer to a new file, replacing any previous file at its path.
+     *
+     * @param path The path of the file.
+     * @param data The content of the file.
+     * @return True if the file was written, otherwise false.
+     */
+    bool writeFile(const string& path, const string& data) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = writeAll(fd, data);
+        return ::close(fd) == 0 && ok;
+    }
+}
+
+/**
+ * @brief Constructor for the TimetableExporter class, builds the lookup of the timetables.
+ *
+ * Every schedule of the catalog is formatted once, in the format of the export, and stored with the
+ * other schedules of its class, in the order of Schedule::operator<: by day of the week, then by start.
+ * For an iCalendar, the first event of a schedule is on the first of its days of the week on or after
+ * the start of the term, and repeats weekly for the weeks of the term; events without a day of the week
+ * are left out.
+ *
+ * @param pool The threads the timetables are formatted on.
+ * @param catalog The catalog of the UCs, classes and schedules.
+ * @param options How the timetables are exported, with a valid term start for an iCalendar.
+ *
+ * @complexity O(S log S), where S is the number of schedules.
+ */
+TimetableExporter::TimetableExporter(ThreadPool& pool, const Catalog& catalog, TimetableOptions options)
+    : pool(pool), catalog(catalog), options(std::move(options)), classCount(0) {
+    for (const Class& ucClass : catalog.getClasses()) {
+        ClassId classId = catalog.getClassId(ucClass.ClassCode);
+        classCount = max(classCount, (size_t) classId + 1);
+    }
+    slots.resize(catalog.getUcCodes().size() * classCount);
+
+    time_t termStart = 0;
+    string stamp;
+    uint32_t startDay = 0;
+    if (this->options.format == TimetableFormat::ICalendar) {
+        parseDate(this->options.termStart, termStart);
+        stamp = formatUtc(time(nullptr), "%Y%m%dT%H%M%SZ");
+        tm fields = {};
+        gmtime_r(&termStart, &fields);
+        startDay = (uint32_t) (fields.tm_wday + 6) % 7;
+    }
+
+    // The position of each schedule in its class, which keeps the id of its events unique
+    map<pair<string, string>, size_t> positions;
+    for (const Schedule& schedule : catalog.getSchedules()) {
+        const Class& ucClass = schedule.UcToClasses;
+        UcId ucId = catalog.getUcId(ucClass.UcCode);
+        ClassId classId = catalog.getClassId(ucClass.ClassCode);
+        size_t position = positions[{ucClass.UcCode, ucClass.ClassCode}]++;
+        uint32_t day = dayIndex(schedule.WeekDay);
+        if (ucId == InvalidId || classId == InvalidId || classId >= classCount) {
+            continue;
+        }
+
+        Slot slot;
+        slot.order = day * 24 * 60 + (uint32_t) max(0L, lround(schedule.StartHour * 60));
+        if (this->options.format == TimetableFormat::Csv) {
+            ostringstream row;
+            row << "," << schedule.WeekDay << "," << floatToHours(schedule.StartHour) << ","
+                << floatToHours(schedule.StartHour + schedule.Duration) << "," << schedule.Duration << ","
+                << ucClass.UcCode << "," << ucClass.ClassCode << "," << schedule.Type << "\n";
+            slot.text = row.str();
+        } else {
+            if (day == UnknownDay) {
+                continue;
+            }
+            string date = formatUtc(termStart + (time_t) ((day + 7 - startDay) % 7) * 24 * 60 * 60, "%Y%m%d");
+            slot.text = "-" + ucClass.UcCode + "-" + ucClass.ClassCode + "-" + to_string(position) + "@leic-schedules\r\n";
+            slot.text += "DTSTAMP:" + stamp + "\r\n";
+            slot.text += "DTSTART:" + date + "T" + icsTime(schedule.StartHour) + "\r\n";
+            slot.text += "DTEND:" + date + "T" + icsTime(schedule.StartHour + schedule.Duration) + "\r\n";
+            slot.text += "RRULE:FREQ=WEEKLY;COUNT=" + to_string(this->options.weeks) + "\r\n";
+            appendTextProperty(slot.text, "SUMMARY", ucClass.UcCode + " " + schedule.Type + " (" + ucClass.ClassCode + ")");
+            slot.text += "END:VEVENT\r\n";
+        }
+        slots[(size_t) ucId * classCount + classId].push_back(std::move(slot));
+    }
+    for (vector<Slot>& classSlots : slots) {
+        stable_sort(classSlots.begin(), classSlots.end(), [](const Slot& a, const Slot& b) {
+            return a.order < b.order;
+        });
+    }
+}
+
+/**
+ * @brief Checks if a date is a valid YYYY-MM-DD date.
+ *
+ * @param date The date.
+ * @return True if the date is valid, otherwise false.
+ */
+bool TimetableExporter::validDate(const string& date) {
+    time_t time;
+    return parseDate(date, time);
+}
+
+/**
+ * @brief Gets the extension of the files of a format.
+ *
+ * @param format The format.
+ * @return The extension, with its dot.
+ */
+string TimetableExporter::extension(TimetableFormat format) {
+    return format == TimetableFormat::Csv ? ".csv" : ".ics";
+}
+
+/**
+ * @brief Gets the header of a file: the header row of a CSV file, nothing for an iCalendar.
+ *
+ * @return The header.
+ */
+string TimetableExporter::header() const {
+    return options.format == TimetableFormat::Csv ? "StudentCode,StudentName,WeekDay,StartHour,EndHour,Duration,UcCode,ClassCode,Type\n" : "";
+}
+
+/**
+ * @brief Formats the timetable of a student.
+ *
+ * The slots of the classes of the student are merged in the order of the week; slots at the same time
+ * keep the order of the classes of the student. A CSV row is the code and name of the student followed
+ * by the slot. An iCalendar is a calendar named after the student, with an event per slot whose id
+ * starts with the code of the student.
+ *
+ * @param student The student.
+ * @param out The buffer the timetable is appended to.
+ * @param classSlots A buffer for the slots of the student, reused between students.
+ *
+ * @complexity O(k log k + r), where k is the number of schedules of the student and r the size of the timetable.
+ */
+void TimetableExporter::formatStudent(const Student& student, string& out, vector<const Slot*>& classSlots) const {
+    classSlots.clear();
+    for (const Class& ucClass : student.UcToClasses) {
+        UcId ucId = catalog.getUcId(ucClass.UcCode);
+        ClassId classId = catalog.getClassId(ucClass.ClassCode);
+        if (ucId == InvalidId || classId == InvalidId || classId >= classCount) {
+            continue;
+        }
+        for (const Slot& slot : slots[(size_t) ucId * classCount + classId]) {
+            classSlots.push_back(&slot);
+        }
+    }
+    stable_sort(classSlots.begin(), classSlots.end(), [](const Slot* a, const Slot* b) {
+        return a->order < b->order;
+    });
+
+    string code = to_string(student.StudentCode);
+    if (options.format == TimetableFormat::Csv) {
+        for (const Slot* slot : classSlots) {
+            out += code;
+            out += ',';
+            out += student.StudentName;
+            out += slot->text;
+        }
+        return;
+    }
+    out += "BEGIN:VCALENDAR\r\nVERSION:2.0\r\nPRODID:-//LEIC Schedules//Timetables//EN\r\nCALSCALE:GREGORIAN\r\n";
+    appendTextProperty(out, "X-WR-CALNAME", code + " " + student.StudentName);
+    for (const Slot* slot : classSlots) {
+        out += "BEGIN:VEVENT\r\nUID:";
+        out += code;
+        out += slot->text;
+    }
+    out += "END:VCALENDAR\r\n";
+}
+
+/**
+ * @brief Exports the timetable of every student, in name order.
+ *
+ * The students are cut into ranges that are formatted in parallel. For a single file, the ranges of
+ * each window are formatted into their buffers, which are then written in order to a temporary file
+ * that replaces the file once every window is written and synced; an iCalendar file then holds a
+ * calendar per student. For a file per student, each range formats the timetable of each of its
+ * students into its buffer and writes it to the file named after the code of the student.
+ *
+ * @param students The roster.
+ * @param path The path of the file, or of the directory for a file per student, created if needed.
+ * @param files Receives the number of files written.
+ * @return True if every file was written, otherwise false.
+ *
+ * @complexity O(n + r / t), where n is the number of students, r the size of the timetables and t the number of threads,
+ * and the writes of the files.
+ */
+bool TimetableExporter::exportTimetables(const StudentBST& students, const string& path, size_t& files) const {
+    files = 0;
+    vector<const Student*> roster;
+    students.forEachStudent([&roster](const Student& student) {
+        roster.push_back(&student);
+    });
+    size_t rangeCount = max<size_t>(min(roster.size(), pool.size() * RangesPerThread), 1);
+    auto rangeStart = [&roster, rangeCount](size_t range) {
+        return roster.size() * range / rangeCount;
+    };
+
+    if (options.perStudent) {
+        struct stat status = {};
+        if (::mkdir(path.c_str(), 0755) != 0 && (::stat(path.c_str(), &status) != 0 || !S_ISDIR(status.st_mode))) {
+            return false;
+        }
+        atomic<size_t> written(0);
+        atomic<bool> failed(false);
+        string ext = extension(options.format);
+        pool.parallelFor(rangeCount, [&](size_t range) {
+            string out;
+            vector<const Slot*> classSlots;
+            for (size_t i = rangeStart(range); i < rangeStart(range + 1) && !failed; i++) {
+                out = header();
+                formatStudent(*roster[i], out, classSlots);
+                if (!writeFile(path + "/" + to_string(roster[i]->StudentCode) + ext, out)) {
+                    failed = true;
+                    return;
+                }
+                written++;
+            }
+        });
+        files = written;
+        return !failed;
+    }
+
+    string temporaryPath = path + ".tmp";
+    int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = writeAll(fd, header());
+    size_t windowSize = (rangeCount + WindowsPerExport - 1) / WindowsPerExport;
+    vector<string> chunks(windowSize);
+    for (size_t begin = 0; ok && begin < rangeCount; begin += windowSize) {
+        size_t end = min(begin + windowSize, rangeCount);
+        pool.parallelFor(end - begin, [&](size_t i) {
+            vector<const Slot*> classSlots;
+            chunks[i].clear();
+            for (size_t student = rangeStart(begin + i); student < rangeStart(begin + i + 1); student++) {
+                formatStudent(*roster[student], chunks[i], classSlots);
+            }
+        });
+        for (size_t i = 0; ok && i < end - begin; i++) {
+            ok = writeAll(fd, chunks[i]);
+        }
+    }
+
+    ok = ok && ::fdatasync(fd) == 0;
+    ::close(fd);
+    if (!ok || ::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        ::unlink(temporaryPath.c_str());
+        return false;
+    }
+    syncDirectoryOf(path);
+    files = 1;
+    return true;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file TimetableExporter.h
+ * @brief Header file for the TimetableExporter class.
+ */
+
+#ifndef PROJETO_AED_TIMETABLEEXPORTER_H
+#define PROJETO_AED_TIMETABLEEXPORTER_H
+
+#include "Catalog.h"
+#include "ThreadPool.h"
+
+/**
+ * @enum TimetableFormat
+ * @brief The format the timetables are exported in.
+ */
+enum class TimetableFormat {
+    Csv,       ///< A row per class of the week.
+    ICalendar  ///< A calendar per student, with a weekly recurring event per class of the week.
+};
+
+/**
+ * @struct TimetableOptions
+ * @brief How the timetables are exported.
+ */
+struct TimetableOptions {
+    TimetableFormat format = TimetableFormat::Csv; ///< The format of the files.
+    bool perStudent = false;    ///< True for a file per student in a directory, false for a single file with every student.
+    string termStart;           ///< The first day of the term, as YYYY-MM-DD, the first events of an iCalendar are on or after it.
+    unsigned weeks = 15;        ///< The number of weeks of the term, the number of times the iCalendar events repeat.
+};
+
+/**
+ * @class TimetableExporter
+ * @brief Exports the timetable of every student, as Consult::getStudentSchedule gives it, in parallel on a thread pool.
+ *
+ * The lookup of the timetables is built once per export and shared by every thread: the schedules of
+ * each class are sorted and formatted once, indexed by the ids of their UC and class. The timetable of
+ * a student is then the formatted schedules of its classes, merged in the order of the week, with the
+ * code and name of the student in front of each of them. Nothing is formatted twice and no schedule
+ * is copied for each student.
+ *
+ * The students are cut into ranges in name order, formatted concurrently, each into its own buffer.
+ * For a single file, the buffers are written in order through a temporary file that replaces the file
+ * once it is synced, a window of ranges at a time. For a file per student, each range writes the
+ * files of its students from its buffer; these files are not synced one by one.
+ */
+class TimetableExporter {
+private:
+    /**
+     * @struct Slot
+     * @brief A schedule of a class, formatted for every student of the class.
+     */
+    struct Slot {
+        uint32_t order;  ///< The position of the schedule in the week, its day and then its start.
+        string text;     ///< The schedule formatted, what follows the code of the student in the row or the event.
+    };
+
+    static const size_t RangesPerThread = 16;   ///< The number of ranges the students are cut into for each thread.
+    static const size_t WindowsPerExport = 4;   ///< The number of windows the ranges of a single file are formatted in.
+
+    ThreadPool& pool;             ///< The threads the timetables are formatted on.
+    const Catalog& catalog;       ///< The catalog the UCs and classes of the students are looked up in.
+    TimetableOptions options;     ///< How the timetables are exported.
+    size_t classCount;            ///< The number of class ids of the catalog.
+    vector<vector<Slot>> slots;   ///< The slots of each class, in the order of the week, at UC id * classCount + class id.
+
+    /**
+     * @brief Format the timetable of a student.
+     * @param student The student.
+     * @param out The buffer the timetable is appended to.
+     * @param classSlots A buffer for the slots of the student, reused between students.
+     */
+    void formatStudent(const Student& student, string& out, vector<const Slot*>& classSlots) const;
+
+    /**
+     * @brief Get the header of a file: the header row of a CSV file, nothing for an iCalendar.
+     * @return The header.
+     */
+    string header() const;
+
+public:
+    /**
+     * @brief Constructor for the TimetableExporter class, builds the lookup of the timetables.
+     * @param pool The threads the timetables are formatted on.
+     * @param catalog The catalog of the UCs, classes and schedules.
+     * @param options How the timetables are exported, with a valid term start for an iCalendar.
+     */
+    TimetableExporter(ThreadPool& pool, const Catalog& catalog, TimetableOptions options);
+
+    /**
+     * @brief Check if a date is a valid YYYY-MM-DD date.
+     * @param date The date.
+     * @return True if the date is valid, otherwise false.
+     */
+    static bool validDate(const string& date);
+
+    /**
+     * @brief Get the extension of the files of a format.
+     * @param format The format.
+     * @return The extension, with its dot.
+     */
+    static string extension(TimetableFormat format);
+
+    /**
+     * @brief Export the timetable of every student.
+     * @param students The roster.
+     * @param path The path of the file, or of the directory for a file per student, created if needed.
+     * @param files Receives the number of files written.
+     * @return True if every file was written, otherwise false.
+     */
+    bool exportTimetables(const StudentBST& students, const string& path, size_t& files) const;
+};
+
+#endif //PROJETO_AED_TIMETABLEEXPORTER_H
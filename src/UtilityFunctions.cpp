@@ -1,4 +1,6 @@
 #include "UtilityFunctions.h"
+#include <chrono>
+#include <charconv>
 
 /**
  * @file
@@ -20,17 +22,36 @@ string ToLower(const string& input) {
 }
 
 /**
+ * @param out The string the time is appended to.
  * @param hours The floating-point number representing hours.
- * @return A string in "hh:mm" format corresponding to the given hours.
  */
-string floatToHours(float hours) {
+void appendHours(string& out, float hours) {
     int wholeHours = static_cast<int>(hours);
     int minutes = static_cast<int>((hours - wholeHours) * 60);
 
-    stringstream ss;
-    ss << setw(2) << setfill('0') << wholeHours << ":" << setw(2) << setfill('0') << minutes;
+    // Each field has at least 2 digits, padded with a zero
+    char text[32];
+    char* end = text;
+    if (wholeHours >= 0 && wholeHours < 10) {
+        *end++ = '0';
+    }
+    end = to_chars(end, text + 16, wholeHours).ptr;
+    *end++ = ':';
+    if (minutes >= 0 && minutes < 10) {
+        *end++ = '0';
+    }
+    end = to_chars(end, text + sizeof(text), minutes).ptr;
+    out.append(text, end);
+}
 
-    return ss.str();
+/**
+ * @param hours The floating-point number representing hours.
+ * @return A string in "hh:mm" format corresponding to the given hours.
+ */
+string floatToHours(float hours) {
+    string text;
+    appendHours(text, hours);
+    return text;
 }
 
 /**
@@ -96,14 +117,63 @@ void sortByOccupation(vector<pair<string, int>>& result, bool ascending) {
 }
 
 /**
- * @return A string representing the current timestamp in "YYYY-MM-DD hh:mm:ss" format.
+ * @brief Gets the current time as a timestamp, with the precision of the system clock.
+ *
+ * @return The current time, in nanoseconds since the epoch.
  */
-string getCurrentTimestamp() {
-    time_t currentTime = time(nullptr);
-    tm* localTime = localtime(&currentTime);
+int64_t getCurrentTime() {
+    return (int64_t) chrono::duration_cast<chrono::nanoseconds>(chrono::system_clock::now().time_since_epoch()).count();
+}
 
-    char buffer[20];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", localTime);
+/**
+ * @brief Formats a timestamp as a local time, with milliseconds.
+ *
+ * @param nanos The timestamp, in nanoseconds since the epoch.
+ * @return The timestamp in "YYYY-MM-DD hh:mm:ss.mmm" format.
+ */
+string formatTimestamp(int64_t nanos) {
+    int64_t seconds = nanos / 1000000000;
+    int64_t rest = nanos % 1000000000;
+    if (rest < 0) {
+        seconds--;
+        rest += 1000000000;
+    }
+    time_t currentTime = (time_t) seconds;
+    tm localTime = {};
+    localtime_r(&currentTime, &localTime);
 
+    char buffer[24];
+    size_t length = strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &localTime);
+    snprintf(buffer + length, sizeof(buffer) - length, ".%03d", (int) (rest / 1000000));
     return buffer;
 }
+
+/**
+ * @brief Parses a local time in the format of the timestamps, the missing fields are 0.
+ *
+ * The span is the length of the period the timestamp names, as a day is not always 24 hours long.
+ *
+ * @param timestamp The time as "YYYY-MM-DD hh:mm:ss", "YYYY-MM-DD hh:mm" or "YYYY-MM-DD".
+ * @param time The parsed time, in seconds since the epoch.
+ * @param span If not null, the length in seconds of the second, minute or day the timestamp names.
+ * @return True if the time was parsed, otherwise false.
+ */
+bool parseTimestamp(const string& timestamp, time_t& time, time_t* span) {
+    const char* formats[] = {"%Y-%m-%d %H:%M:%S", "%Y-%m-%d %H:%M", "%Y-%m-%d"};
+    for (int format = 0; format < 3; format++) {
+        tm localTime = {};
+        istringstream in(timestamp);
+        in >> get_time(&localTime, formats[format]);
+        if (!in.fail() && (in >> ws).eof()) {
+            localTime.tm_isdst = -1;
+            tm next = localTime;
+            time = mktime(&localTime);
+            if (span != nullptr) {
+                (format == 0 ? next.tm_sec : format == 1 ? next.tm_min : next.tm_mday)++;
+                *span = mktime(&next) - time;
+            }
+            return time != -1;
+        }
+    }
+    return false;
+}
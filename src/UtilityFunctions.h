@@ -7,6 +7,8 @@
 #include <algorithm>
 #include <sstream>
 #include <vector>
+#include <ctime>
+#include <cstdint>
 
 using namespace std;
 
@@ -29,6 +31,13 @@ char removeAccents(char c);
  */
 string ToLower(const string& input);
 
+/**
+ * @brief Append a floating-point value in hours to a string, as hours and minutes, without a temporary stream.
+ * @param out The string the time is appended to.
+ * @param hours The floating-point value representing hours.
+ */
+void appendHours(string& out, float hours);
+
 /**
  * @brief Convert a floating-point value in hours to a string with hours and minutes.
  * @param hours The floating-point value representing hours.
@@ -58,9 +67,25 @@ void sortClassByYear(vector<pair<string, int>>& result, bool ascending);
 void sortByOccupation(vector<pair<string, int>>& result, bool ascending);
 
 /**
- * @brief Get the current timestamp as a string.
- * @return The current timestamp as a string in "YYYY-MM-DD hh:mm:ss" format.
+ * @brief Get the current time as a timestamp.
+ * @return The current time, in nanoseconds since the epoch.
+ */
+int64_t getCurrentTime();
+
+/**
+ * @brief Format a timestamp as a local time.
+ * @param nanos The timestamp, in nanoseconds since the epoch.
+ * @return The timestamp in "YYYY-MM-DD hh:mm:ss.mmm" format.
+ */
+string formatTimestamp(int64_t nanos);
+
+/**
+ * @brief Parse a local time in the format of the timestamps, the seconds or the whole time of day may be left out.
+ * @param timestamp The time as "YYYY-MM-DD hh:mm:ss", "YYYY-MM-DD hh:mm" or "YYYY-MM-DD".
+ * @param time The parsed time, in seconds since the epoch.
+ * @param span If not null, the length in seconds of the second, minute or day the timestamp names.
+ * @return True if the time was parsed, otherwise false.
  */
-string getCurrentTimestamp();
+bool parseTimestamp(const string& timestamp, time_t& time, time_t* span = nullptr);
 
 #endif //PROJETO_AED_UTILITYFUNCTIONS_H